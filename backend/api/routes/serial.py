@@ -29,7 +29,9 @@ async def list_ports():
 @router.post("/connect")
 async def connect_serial(
     port: str = Query(..., description="Serial port (e.g., COM8 or /dev/ttyACM0)"),
-    baudrate: int = Query(115200, description="Baud rate")
+    baudrate: int = Query(115200, description="Baud rate"),
+    binary: bool = Query(False, description="Base binary (COBS) output mode"),
+    target_baud: Optional[int] = Query(None, description="Negotiate a higher baud rate after connecting")
 ):
     """
     連接 Serial port
@@ -40,7 +42,7 @@ async def connect_serial(
     try:
         logger.info(f"[API] Connect request: port={port}, baudrate={baudrate}")
         core = CoreService.get_instance()
-        await core.start_serial(port, baudrate)
+        await core.start_serial(port, baudrate, binary=binary, target_baud=target_baud)
         logger.info(f"[API] Connect successful: port={port}")
         return {"status": "connected", "port": port, "baudrate": baudrate}
     except Exception as e:
@@ -14,8 +14,16 @@ SAMPLE_RATE: int = 100  # Hz
 RING_BUFFER_SECONDS: int = 60  # 秒
 
 # 單位換算
-ACCEL_SCALE: float = 16384.0  # ±2g
-GYRO_SCALE: float = 131.0     # ±250 dps
+# 量程代碼 → LSB 靈敏度，必須與 firmware/common/imu_scale.h 一致（tests/test_imu_scale.py 檢查）
+IMU_ACCEL_LSB_PER_G: tuple[float, ...] = (16384.0, 8192.0, 4096.0, 2048.0)  # ±2/4/8/16 g
+IMU_GYRO_LSB_PER_DPS: tuple[float, ...] = (131.0, 65.5, 32.8, 16.4)         # ±250/500/1000/2000 dps
+
+# 韌體目前的量程代碼（對應 imu_driver.h 的 IMU_ACCEL_RANGE / IMU_GYRO_RANGE）
+IMU_ACCEL_RANGE: int = int(os.getenv("IMU_ACCEL_RANGE", "0"))  # 0 = ±2g
+IMU_GYRO_RANGE: int = int(os.getenv("IMU_GYRO_RANGE", "0"))    # 0 = ±250 dps
+
+ACCEL_SCALE: float = IMU_ACCEL_LSB_PER_G[IMU_ACCEL_RANGE]
+GYRO_SCALE: float = IMU_GYRO_LSB_PER_DPS[IMU_GYRO_RANGE]
 
 # CORS 設定
 CORS_ORIGINS: list[str] = [
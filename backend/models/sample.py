@@ -10,10 +10,10 @@ from typing import Optional
 
 class RawSample(BaseModel):
     """
-    原始 CSV 資料模型（15 欄位）
+    原始 CSV 資料模型（15 欄位 + 可選 valid）
     對應 firmware 輸出的 CSV 格式
 
-    Format: seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2
+    Format: seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2,valid
     """
     seq: int = Field(..., description="封包序號（0~65535 循環）")
     t_remote_ms: int = Field(..., description="遠距端 millis() 時間戳")
@@ -35,6 +35,9 @@ class RawSample(BaseModel):
     gy2: int = Field(..., description="MPU2 陀螺儀 Y 軸 raw 值")
     gz2: int = Field(..., description="MPU2 陀螺儀 Z 軸 raw 值")
 
+    # IMU 有效位元
+    valid: int = Field(3, description="IMU 有效位元（bit0=MPU1, bit1=MPU2）")
+
     # 接收時間（本地）
     t_received_ns: Optional[int] = Field(None, description="本地接收時間戳 (ns)")
 
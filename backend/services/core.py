@@ -100,13 +100,16 @@ class CoreService:
 
     # --- Serial 控制 ---
 
-    async def start_serial(self, port: str = '/dev/ttyUSB0', baudrate: int = 115200):
+    async def start_serial(self, port: str = '/dev/ttyUSB0', baudrate: int = 115200,
+                           binary: bool = False, target_baud: Optional[int] = None):
         """
         啟動 Serial 資料流
 
         Args:
             port: Serial port 路徑
             baudrate: Baud rate
+            binary: Base 是否為二進位輸出模式
+            target_baud: 開啟後與 Base 協商的鮑率（None = 不協商）
 
         Raises:
             serial.SerialException: Serial 連接失敗
@@ -123,7 +126,7 @@ class CoreService:
                 self.serial_ingest.stop()
             except Exception:
                 pass
-        self.serial_ingest = SerialIngest(port, baudrate)
+        self.serial_ingest = SerialIngest(port, baudrate, binary=binary, target_baud=target_baud)
 
         # 延遲導入 WebSocket manager
         try:
@@ -490,8 +493,11 @@ class CoreService:
         # Serial 統計
         if self.serial_ingest:
             stats["serial"] = self.serial_ingest.stats
+            stats["telemetry"] = self.serial_ingest.telemetry
         else:
-            stats["serial"] = {"pps": 0.0, "dropped": 0, "parse_err": 0, "total_rx": 0}
+            stats["serial"] = {"pps": 0.0, "dropped": 0, "parse_err": 0, "total_rx": 0,
+                               "radio_lost": 0, "base_tx_drop": 0}
+            stats["telemetry"] = {}
 
         # Buffer 統計
         stats["buffer_size"] = self.ring_buffer.size
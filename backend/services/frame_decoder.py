@@ -0,0 +1,262 @@
+"""
+Frame Decoder
+解碼 Base 二進位輸出模式的 COBS 框架
+
+框架格式參考: docs/stage2/SERIAL_FORMAT.md（二進位模式）
+    編碼前: [type:1][t_base_us:4][payload:0-32][crc16:2]（little-endian）
+    傳輸:   COBS(編碼前內容) + 0x00
+"""
+
+import struct
+import time
+from dataclasses import dataclass
+from typing import Optional
+import logging
+
+logger = logging.getLogger(__name__)
+
+# 框架類型（對應 firmware/base/serial_frame.h）
+FRAME_TYPE_RADIO = 0x01
+FRAME_TYPE_STATS = 0x02
+FRAME_TYPE_EVENT = 0x03
+FRAME_TYPE_BASE_STATS = 0x04
+FRAME_TYPE_LINK = 0x05
+FRAME_TYPE_RPD = 0x06
+FRAME_TYPE_SURVEY = 0x07
+FRAME_TYPE_ENVELOPE = 0x08
+
+# RADIO / STATS / LINK 框架的 type 高 4 位元為接收管道（遠距端編號）
+FRAME_TYPE_MASK = 0x0F
+FRAME_PIPE_SHIFT = 4
+
+# 事件碼
+FRAME_EVENT_BOOT = 0x01
+FRAME_EVENT_RF_OK = 0x02
+FRAME_EVENT_RF_ERROR = 0x03
+FRAME_EVENT_TX_SKIP = 0x04
+FRAME_EVENT_BAUD = 0x05
+FRAME_EVENT_BAUD_OK = 0x06
+FRAME_EVENT_CMD_OK = 0x07
+FRAME_EVENT_CMD_ERR = 0x08
+
+FRAME_HEADER_LEN = 5
+FRAME_CRC_LEN = 2
+FRAME_MAX_PAYLOAD = 32
+
+# 文字模式的框架行：#f,<[type][t_base_us][payload] 十六進位>（firmware/base/serial_frame.h frame_print）
+FRAME_LINE_PREFIX = '#f,'
+
+# 超過此長度仍未遇到分隔符，視為雜訊並丟棄
+FRAME_MAX_ENCODED = FRAME_HEADER_LEN + FRAME_MAX_PAYLOAD + FRAME_CRC_LEN + 1
+
+# StatsFrame（每個遠距端）: packets_received, packets_lost, pps_x10, packets_duplicate, packets_late
+STATS_FRAME = struct.Struct('<IIHHH')
+# 舊版 Base（v2.6 之前）沒有 duplicate / late
+STATS_FRAME_LEGACY = struct.Struct('<IIH')
+
+# LinkFrame（每個遠距端）: iat_min_us, iat_max_us, jitter_us, gap_max, burst_count,
+# burst_hist[6], ge_p_permille, ge_r_permille
+LINK_FRAME = struct.Struct('<HHHHI6HHH')
+
+# RpdFrame: channel, samples, hits
+RPD_FRAME = struct.Struct('<BHH')
+
+# SurveyFrame: start, passes, 每頻道 4 bits 命中次數（低 4 位元為偶數頻道）
+SURVEY_CHANNELS = 126
+SURVEY_CHUNK = 42
+SURVEY_FRAME = struct.Struct(f'<BB{SURVEY_CHUNK // 2}s')
+
+# EnvelopeFrame（每個遠距端，每個視窗 3 筆）: seq, count, flags, value[12]
+# flags: bit0 = btn，bit1-2 = 統計種類（ENVELOPE_STATS 索引），bit6-7 = valid
+ENVELOPE_FRAME = struct.Struct('<HBB12h')
+ENVELOPE_STATS = ('min', 'max', 'mean')
+
+# BaseStatsFrame: tx_records_dropped, tx_bytes_dropped, tx_high_water, rx_overflow
+BASE_STATS_FRAME = struct.Struct('<IIHH')
+
+
+def _crc16_table() -> tuple[int, ...]:
+    table = []
+    for i in range(256):
+        crc = i << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+        table.append(crc & 0xFFFF)
+    return tuple(table)
+
+
+_CRC16_TABLE = _crc16_table()
+
+
+def crc16(data: bytes, crc: int = 0xFFFF) -> int:
+    """CRC-16/CCITT-FALSE（對應 firmware/common/crc.h，主機端查表計算）"""
+    for b in data:
+        crc = ((crc << 8) & 0xFFFF) ^ _CRC16_TABLE[(crc >> 8) ^ b]
+    return crc
+
+
+def cobs_encode(data: bytes) -> bytes:
+    """COBS 編碼（不含 0x00 分隔符）"""
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block.clear()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def cobs_decode(data: bytes) -> Optional[bytes]:
+    """COBS 解碼（輸入不含 0x00 分隔符），格式錯誤回傳 None"""
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        code = data[i]
+        if code == 0 or i + code > n:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < n:
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(frame_type: int, t_base_us: int, payload: bytes) -> bytes:
+    """組成一個完整框架（含分隔符），供測試與模擬使用"""
+    raw = struct.pack('<BI', frame_type, t_base_us & 0xFFFFFFFF) + payload
+    raw += struct.pack('<H', crc16(raw))
+    return cobs_encode(raw) + b'\x00'
+
+
+@dataclass
+class Frame:
+    """解碼後的框架"""
+    type: int           # FRAME_TYPE_*（已去除管道位元）
+    t_base_us: int      # Base micros()（到達或事件時間）
+    payload: bytes      # 0-32 bytes
+    pipe: int = 0       # 接收管道（RADIO / STATS 框架）
+
+
+class FrameDecoder:
+    """
+    串流框架解碼器
+
+    以任意大小的區塊餵入位元組，遇到 0x00 分隔符時解碼一個框架；
+    CRC 或 COBS 錯誤的框架丟棄並計數，下一個分隔符後即重新同步。
+    """
+
+    def __init__(self):
+        self._buf = bytearray()
+        self.stats = {
+            'frames': 0,       # 成功解碼框架數
+            'crc_err': 0,      # CRC 錯誤
+            'cobs_err': 0,     # COBS 格式錯誤 / 長度錯誤
+            'overflow': 0,     # 超長（無分隔符）資料段
+        }
+
+    def feed(self, data: bytes) -> list[Frame]:
+        """
+        餵入資料
+
+        Args:
+            data: 從 serial 讀到的位元組
+
+        Returns:
+            本次完成解碼的框架列表
+        """
+        frames = []
+        start = 0
+        while True:
+            end = data.find(b'\x00', start)
+            if end < 0:
+                self._buf += data[start:]
+                if len(self._buf) > FRAME_MAX_ENCODED:
+                    self.stats['overflow'] += 1
+                    self._buf.clear()
+                break
+
+            self._buf += data[start:end]
+            start = end + 1
+            if self._buf:
+                frame = self._decode(bytes(self._buf))
+                self._buf.clear()
+                if frame is not None:
+                    frames.append(frame)
+        return frames
+
+    def _decode(self, encoded: bytes) -> Optional[Frame]:
+        """解碼單一框架（不含分隔符）"""
+        raw = cobs_decode(encoded)
+        if raw is None or not (FRAME_HEADER_LEN + FRAME_CRC_LEN <= len(raw)
+                               <= FRAME_HEADER_LEN + FRAME_MAX_PAYLOAD + FRAME_CRC_LEN):
+            self.stats['cobs_err'] += 1
+            return None
+
+        body, (crc,) = raw[:-FRAME_CRC_LEN], struct.unpack('<H', raw[-FRAME_CRC_LEN:])
+        if crc16(body) != crc:
+            self.stats['crc_err'] += 1
+            return None
+
+        self.stats['frames'] += 1
+        return _frame_from_body(body)
+
+
+def _frame_from_body(body: bytes) -> Frame:
+    """[type][t_base_us][payload]（已驗證長度）→ Frame"""
+    frame_type, t_base_us = struct.unpack_from('<BI', body)
+    return Frame(frame_type & FRAME_TYPE_MASK, t_base_us, body[FRAME_HEADER_LEN:],
+                 frame_type >> FRAME_PIPE_SHIFT)
+
+
+def parse_frame_line(line: str) -> Optional[Frame]:
+    """
+    解析文字模式的框架行（統計等定期輸出，內容與二進位框架相同，無 CRC）
+
+    Args:
+        line: #f, 開頭的一行（不含 \r\n）
+
+    Returns:
+        Frame，或 None（前綴 / 長度 / 十六進位格式錯誤）
+    """
+    if not line.startswith(FRAME_LINE_PREFIX):
+        return None
+    try:
+        body = bytes.fromhex(line[len(FRAME_LINE_PREFIX):])
+    except ValueError:
+        return None
+    if not FRAME_HEADER_LEN <= len(body) <= FRAME_HEADER_LEN + FRAME_MAX_PAYLOAD:
+        return None
+    return _frame_from_body(body)
+
+
+def benchmark(n: int = 10000) -> float:
+    """
+    解碼吞吐量（框架/秒），以 32-byte 無線封包框架量測
+
+    用法: python -m services.frame_decoder
+    """
+    payload = bytes(range(1, 33))
+    stream = b''.join(encode_frame(FRAME_TYPE_RADIO, i * 10000, payload) for i in range(n))
+
+    decoder = FrameDecoder()
+    t0 = time.perf_counter()
+    for i in range(0, len(stream), 256):  # 模擬 serial.read() 區塊
+        decoder.feed(stream[i:i + 256])
+    elapsed = time.perf_counter() - t0
+    assert decoder.stats['frames'] == n
+    return n / elapsed
+
+
+if __name__ == '__main__':
+    rate = benchmark()
+    print(f"{rate:,.0f} frames/s ({rate / 100:,.0f}x a 100 Hz stream)")
@@ -0,0 +1,152 @@
+"""
+Hex Line Decoder
+解碼 Base 十六進位輸出模式（!M2，OUTPUT_MODE_HEX）的固定寬度 $ 行
+
+格式參考: docs/stage2/SERIAL_FORMAT.md（十六進位模式）、firmware/base/csv_format.h
+    $ssss,tttttttt,ff,xxxx×12,pp,bbbbbbbb\r\n（每行固定 91 字元）
+    去掉 $ 與逗號後為 72 個十六進位數字 = 36 bytes big-endian:
+    seq:uint16, t_remote_ms:uint32, flags:uint8, imu:int16×12, pipe:uint8, t_base_us:uint32
+
+每個欄位位置固定：單行用 bytes.fromhex 一次轉換；
+大量資料（錄製檔、一次讀出的多行）以 numpy 在固定欄位位置查表，不逐字元掃描。
+"""
+
+import struct
+import time
+from typing import Optional
+
+import numpy as np
+
+HEX_LINE_LEN = 91                 # 含 \r\n
+HEX_LINE_BODY = HEX_LINE_LEN - 2
+HEX_LINE_PREFIX = '$'
+
+# 去掉 $ 與逗號後的二進位內容
+HEX_SAMPLE = struct.Struct('>HIB12hBI')
+
+HEX_SAMPLE_DTYPE = np.dtype([
+    ('seq', '>u2'),
+    ('t_remote_ms', '>u4'),
+    ('flags', 'u1'),
+    ('imu', '>i2', (12,)),
+    ('pipe', 'u1'),
+    ('t_base_us', '>u4'),
+])
+
+# 各欄位寬度（十六進位字元數），欄位之間一個逗號
+_FIELD_WIDTHS = (4, 8, 2) + (4,) * 12 + (2, 8)
+
+
+def _digit_columns() -> np.ndarray:
+    columns = []
+    pos = 1  # 跳過 $
+    for width in _FIELD_WIDTHS:
+        columns.extend(range(pos, pos + width))
+        pos += width + 1
+    return np.array(columns)
+
+
+# 72 個十六進位數字在行內的位置
+HEX_DIGIT_COLUMNS = _digit_columns()
+# 逗號位置（用於驗證行格式）
+HEX_COMMA_COLUMNS = np.array([c for c in range(1, HEX_LINE_BODY)
+                              if c not in set(HEX_DIGIT_COLUMNS.tolist())])
+
+
+def _nibble_table() -> np.ndarray:
+    table = np.full(256, 0xFF, dtype=np.uint8)
+    for i, c in enumerate(b'0123456789abcdef'):
+        table[c] = i
+    for i, c in enumerate(b'ABCDEF'):
+        table[c] = 10 + i
+    return table
+
+
+_NIBBLE = _nibble_table()
+
+
+def parse_hex_line(line: str) -> Optional[tuple]:
+    """
+    解析一行十六進位資料（不含 \r\n）
+
+    Args:
+        line: $ 開頭的一行
+
+    Returns:
+        (seq, t_remote_ms, flags, ax1, ..., gz2, pipe, t_base_us) 或 None（長度 / 格式錯誤）
+    """
+    if len(line) != HEX_LINE_BODY or line[0] != HEX_LINE_PREFIX:
+        return None
+    try:
+        return HEX_SAMPLE.unpack(bytes.fromhex(line[1:].replace(',', '')))
+    except (ValueError, struct.error):
+        return None
+
+
+def decode_hex_block(data: bytes) -> np.ndarray:
+    """
+    批次解碼連續的 $ 行（每行 HEX_LINE_LEN bytes，長度須為其整數倍）
+
+    只取固定位置的十六進位數字查表組成位元組，再直接以結構化 dtype 檢視；
+    格式不符的行（非 $ 開頭、逗號錯位、非十六進位字元）丟棄。
+
+    Args:
+        data: 對齊行首的原始位元組
+
+    Returns:
+        HEX_SAMPLE_DTYPE 結構化陣列
+    """
+    if len(data) % HEX_LINE_LEN:
+        raise ValueError(f"data length {len(data)} is not a multiple of {HEX_LINE_LEN}")
+
+    rows = np.frombuffer(data, dtype=np.uint8).reshape(-1, HEX_LINE_LEN)
+    nibbles = _NIBBLE[rows[:, HEX_DIGIT_COLUMNS]]
+
+    ok = (rows[:, 0] == ord(HEX_LINE_PREFIX)) & (nibbles != 0xFF).all(axis=1)
+    ok &= (rows[:, HEX_COMMA_COLUMNS] == ord(',')).all(axis=1)
+
+    packed = (nibbles[ok, 0::2] << 4) | nibbles[ok, 1::2]
+    return np.ascontiguousarray(packed).view(HEX_SAMPLE_DTYPE).reshape(-1)
+
+
+def benchmark(n: int = 10000) -> dict:
+    """
+    十六進位行與十進位 CSV 行的解析吞吐量（行/秒）
+
+    用法: python -m services.hex_decoder
+    """
+    from services.serial_ingest import SerialIngest
+
+    values = (-16384, 250, 16200, -31, 7, 1200, 16380, -5, -16000, 88, -900, 3)
+    csv_lines = [f"{i & 0xFFFF},{i * 10},0," + ",".join(map(str, values)) + f",3,1,{i * 10000}"
+                 for i in range(n)]
+    hex_lines = [HEX_LINE_PREFIX + ",".join(
+        [f"{i & 0xFFFF:04x}", f"{i * 10:08x}", "c0"] +
+        [f"{v & 0xFFFF:04x}" for v in values] + ["01", f"{i * 10000 & 0xFFFFFFFF:08x}"])
+        for i in range(n)]
+    block = "".join(line + "\r\n" for line in hex_lines).encode()
+
+    ingest = SerialIngest("/dev/null")
+    rates = {}
+
+    t0 = time.perf_counter()
+    for line in csv_lines:
+        ingest.parse_line(line)
+    rates['csv'] = n / (time.perf_counter() - t0)
+
+    t0 = time.perf_counter()
+    for line in hex_lines:
+        ingest.parse_line(line)
+    rates['hex'] = n / (time.perf_counter() - t0)
+
+    t0 = time.perf_counter()
+    samples = decode_hex_block(block)
+    rates['hex_block'] = n / (time.perf_counter() - t0)
+    assert len(samples) == n
+
+    return rates
+
+
+if __name__ == '__main__':
+    for name, rate in benchmark().items():
+        print(f"{name:>9}: {rate:,.0f} lines/s")
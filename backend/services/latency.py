@@ -0,0 +1,101 @@
+"""
+端到端延遲分段統計
+
+每筆樣本帶有四個時間點：
+    t_remote_ms   遠距端採樣時間（遠距端 millis()）
+    t_base_us     Base 收到無線封包（Base micros()，CSV 第 18 欄 / 二進位框架標頭）
+    t_read_ns     桌面端從 Serial 讀出該行 / 該批位元組（time.time_ns()）
+    t_received_ns 解析完成、交給回調之前（time.time_ns()）
+
+分段：
+    radio  = t_base - t_remote    遠距端採樣 → Base 收到（含重傳、TDMA 等待）
+    serial = t_read - t_base      Base 收到 → 桌面端讀出（UART 佇列、USB 轉接、OS 緩衝）
+    host   = t_received - t_read  讀出 → 回調（解碼、解析）
+
+radio / serial 跨越兩個時鐘，絕對值沒有意義：每段各自減去視窗內的最小值，
+回報「超出最快一筆的額外延遲」。時鐘漂移在視窗長度內可忽略
+（16 MHz 晶振 ±50 ppm，500 筆 @100Hz = 5 秒 → 0.25 ms）。
+host 段在同一時鐘上，回報絕對值。
+"""
+from collections import deque
+from typing import Optional
+
+LATENCY_WINDOW = 500   # 每段保留的樣本數
+
+WRAP_32 = 1 << 32
+
+
+def _wrap_diff(value: int, ref: int) -> int:
+    """32-bit 時間差（處理 micros() 溢位），回傳有號值"""
+    diff = (value - ref) % WRAP_32
+    return diff - WRAP_32 if diff >= WRAP_32 // 2 else diff
+
+
+class LatencyBreakdown:
+    """
+    逐段延遲統計
+
+    update() 在讀取線程對每筆樣本 O(1) 記錄；snapshot() 才計算統計
+    """
+
+    def __init__(self, window: int = LATENCY_WINDOW):
+        self.window = window
+        self._radio: dict[int, deque] = {}    # 以管道為鍵（各遠距端時鐘不同）
+        self._radio_ref: dict[int, int] = {}
+        self._serial: deque = deque(maxlen=window)
+        self._serial_ref: Optional[int] = None
+        self._host: deque = deque(maxlen=window)
+
+    def update(self, sample) -> None:
+        """
+        記錄一筆樣本（需已填入 t_base_us / t_read_ns / t_received_ns）
+
+        Args:
+            sample: SerialSample
+        """
+        if not sample.t_base_us or not sample.t_read_ns:
+            return  # 舊格式（沒有 t_base_us）無法分段
+
+        # 遠距端 ms → us 後與 Base micros() 相減，兩者皆以 32-bit 溢位
+        remote_us = (sample.t_remote_ms * 1000) % WRAP_32
+        raw = (sample.t_base_us - remote_us) % WRAP_32
+        ref = self._radio_ref.setdefault(sample.pipe, raw)
+        self._radio.setdefault(sample.pipe, deque(maxlen=self.window)).append(_wrap_diff(raw, ref))
+
+        raw = (sample.t_read_ns // 1000 - sample.t_base_us) % WRAP_32
+        if self._serial_ref is None:
+            self._serial_ref = raw
+        self._serial.append(_wrap_diff(raw, self._serial_ref))
+
+        if sample.t_received_ns:
+            self._host.append((sample.t_received_ns - sample.t_read_ns) // 1000)
+
+    def reset(self) -> None:
+        """清除所有樣本"""
+        self._radio.clear()
+        self._radio_ref.clear()
+        self._serial.clear()
+        self._serial_ref = None
+        self._host.clear()
+
+    @staticmethod
+    def _summary(values, relative: bool) -> dict:
+        if not values:
+            return {'n': 0, 'mean_us': 0.0, 'max_us': 0}
+        base = min(values) if relative else 0
+        total = sum(values) - base * len(values)
+        return {'n': len(values), 'mean_us': total / len(values), 'max_us': max(values) - base}
+
+    def snapshot(self) -> dict:
+        """
+        目前視窗的分段統計
+
+        Returns:
+            {'radio': {pipe: {...}}, 'serial': {...}, 'host': {...}}
+            每段 {'n', 'mean_us', 'max_us'}；radio / serial 為相對視窗最小值的額外延遲
+        """
+        return {
+            'radio': {pipe: self._summary(values, True) for pipe, values in self._radio.items()},
+            'serial': self._summary(self._serial, True),
+            'host': self._summary(self._host, False),
+        }
@@ -8,7 +8,8 @@
 import math
 from dataclasses import dataclass
 from typing import Optional
-from services.serial_ingest import SerialSample
+from services.serial_ingest import SerialSample, VALID_MPU1, VALID_MPU2
+import config
 
 
 @dataclass
@@ -53,12 +54,12 @@ class Processor:
     4. 計算模長
     """
 
-    # MPU6050 量程常數（依據 CONFIG_PARAMS.md）
-    # Accel Range: ±2g → LSB Sensitivity = 16384 LSB/g
-    ACCEL_SCALE = 16384.0
+    # MPU6050 量程常數（來源: firmware/common/imu_scale.h，經 config.py 對應）
+    # 預設 Accel Range: ±2g → LSB Sensitivity = 16384 LSB/g
+    ACCEL_SCALE = config.ACCEL_SCALE
 
-    # Gyro Range: ±250°/s → LSB Sensitivity = 131 LSB/(°/s)
-    GYRO_SCALE = 131.0
+    # 預設 Gyro Range: ±250°/s → LSB Sensitivity = 131 LSB/(°/s)
+    GYRO_SCALE = config.GYRO_SCALE
 
     def __init__(self, sample_rate: int = 100):
         """
@@ -78,6 +79,10 @@ class Processor:
             'gx2': 0.0, 'gy2': 0.0, 'gz2': 0.0,
         }
 
+        # 最後一筆有效的 IMU 原始值（IMU 暫時無效時沿用）
+        self._hold_imu1 = (0, 0, 0, 0, 0, 0)
+        self._hold_imu2 = (0, 0, 0, 0, 0, 0)
+
         # 濾波器狀態（上一次的值）
         self._prev_g1_mag: Optional[float] = None
         self._prev_g2_mag: Optional[float] = None
@@ -112,25 +117,33 @@ class Processor:
         Returns:
             處理後的資料（含物理單位與濾波後的模長）
         """
+        # 0. 無效的 IMU 沿用最後一筆有效值（避免填 0 造成模長突降）
+        if raw.valid & VALID_MPU1:
+            self._hold_imu1 = (raw.ax1, raw.ay1, raw.az1, raw.gx1, raw.gy1, raw.gz1)
+        if raw.valid & VALID_MPU2:
+            self._hold_imu2 = (raw.ax2, raw.ay2, raw.az2, raw.gx2, raw.gy2, raw.gz2)
+        ax1, ay1, az1, gx1, gy1, gz1 = self._hold_imu1
+        ax2, ay2, az2, gx2, gy2, gz2 = self._hold_imu2
+
         # 1. 單位換算
-        ax1_g = raw.ax1 / self.ACCEL_SCALE
-        ay1_g = raw.ay1 / self.ACCEL_SCALE
-        az1_g = raw.az1 / self.ACCEL_SCALE
+        ax1_g = ax1 / self.ACCEL_SCALE
+        ay1_g = ay1 / self.ACCEL_SCALE
+        az1_g = az1 / self.ACCEL_SCALE
 
-        ax2_g = raw.ax2 / self.ACCEL_SCALE
-        ay2_g = raw.ay2 / self.ACCEL_SCALE
-        az2_g = raw.az2 / self.ACCEL_SCALE
+        ax2_g = ax2 / self.ACCEL_SCALE
+        ay2_g = ay2 / self.ACCEL_SCALE
+        az2_g = az2 / self.ACCEL_SCALE
 
-        gx1_dps = raw.gx1 / self.GYRO_SCALE
-        gy1_dps = raw.gy1 / self.GYRO_SCALE
-        gz1_dps = raw.gz1 / self.GYRO_SCALE
+        gx1_dps = gx1 / self.GYRO_SCALE
+        gy1_dps = gy1 / self.GYRO_SCALE
+        gz1_dps = gz1 / self.GYRO_SCALE
 
-        gx2_dps = raw.gx2 / self.GYRO_SCALE
-        gy2_dps = raw.gy2 / self.GYRO_SCALE
-        gz2_dps = raw.gz2 / self.GYRO_SCALE
+        gx2_dps = gx2 / self.GYRO_SCALE
+        gy2_dps = gy2 / self.GYRO_SCALE
+        gz2_dps = gz2 / self.GYRO_SCALE
 
-        # 2. Gyro bias 校正（如果有校正資料）
-        if self._calibrating:
+        # 2. Gyro bias 校正（如果有校正資料；只收集兩顆皆有效的樣本）
+        if self._calibrating and (raw.valid & VALID_MPU1) and (raw.valid & VALID_MPU2):
             # 收集校正樣本
             self._calib_samples.append({
                 'gx1': gx1_dps, 'gy1': gy1_dps, 'gz1': gz1_dps,
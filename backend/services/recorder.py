@@ -14,7 +14,7 @@ from pathlib import Path
 import logging
 
 from services.serial_ingest import SerialSample
-from services.processor import ProcessedSample
+from services.processor import Processor, ProcessedSample
 
 logger = logging.getLogger(__name__)
 
@@ -131,18 +131,18 @@ class Recorder:
                     # 原始值（反算回 raw，假設已經換算過）
                     # 如果需要原始值，應該在 ProcessedSample 中保留
                     # 這裡簡化處理，只記錄處理後的值
-                    int(sample.ax1_g * 16384),
-                    int(sample.ay1_g * 16384),
-                    int(sample.az1_g * 16384),
-                    int(sample.gx1_dps * 131),
-                    int(sample.gy1_dps * 131),
-                    int(sample.gz1_dps * 131),
-                    int(sample.ax2_g * 16384),
-                    int(sample.ay2_g * 16384),
-                    int(sample.az2_g * 16384),
-                    int(sample.gx2_dps * 131),
-                    int(sample.gy2_dps * 131),
-                    int(sample.gz2_dps * 131),
+                    int(sample.ax1_g * Processor.ACCEL_SCALE),
+                    int(sample.ay1_g * Processor.ACCEL_SCALE),
+                    int(sample.az1_g * Processor.ACCEL_SCALE),
+                    int(sample.gx1_dps * Processor.GYRO_SCALE),
+                    int(sample.gy1_dps * Processor.GYRO_SCALE),
+                    int(sample.gz1_dps * Processor.GYRO_SCALE),
+                    int(sample.ax2_g * Processor.ACCEL_SCALE),
+                    int(sample.ay2_g * Processor.ACCEL_SCALE),
+                    int(sample.az2_g * Processor.ACCEL_SCALE),
+                    int(sample.gx2_dps * Processor.GYRO_SCALE),
+                    int(sample.gy2_dps * Processor.GYRO_SCALE),
+                    int(sample.gz2_dps * Processor.GYRO_SCALE),
                     # 處理後的值（物理單位）
                     sample.ax1_g,
                     sample.ay1_g,
@@ -180,18 +180,18 @@ class Recorder:
                     sample.gy2,
                     sample.gz2,
                     # 物理單位（自動換算）
-                    sample.ax1 / 16384.0,
-                    sample.ay1 / 16384.0,
-                    sample.az1 / 16384.0,
-                    sample.gx1 / 131.0,
-                    sample.gy1 / 131.0,
-                    sample.gz1 / 131.0,
-                    sample.ax2 / 16384.0,
-                    sample.ay2 / 16384.0,
-                    sample.az2 / 16384.0,
-                    sample.gx2 / 131.0,
-                    sample.gy2 / 131.0,
-                    sample.gz2 / 131.0,
+                    sample.ax1 / Processor.ACCEL_SCALE,
+                    sample.ay1 / Processor.ACCEL_SCALE,
+                    sample.az1 / Processor.ACCEL_SCALE,
+                    sample.gx1 / Processor.GYRO_SCALE,
+                    sample.gy1 / Processor.GYRO_SCALE,
+                    sample.gz1 / Processor.GYRO_SCALE,
+                    sample.ax2 / Processor.ACCEL_SCALE,
+                    sample.ay2 / Processor.ACCEL_SCALE,
+                    sample.az2 / Processor.ACCEL_SCALE,
+                    sample.gx2 / Processor.GYRO_SCALE,
+                    sample.gy2 / Processor.GYRO_SCALE,
+                    sample.gz2 / Processor.GYRO_SCALE,
                     0.0,  # g1_mag（未計算）
                     0.0,  # g2_mag
                     0.0,  # a1_mag
@@ -0,0 +1,132 @@
+"""
+序號重排緩衝
+
+Base 保留最近 REPLAY_DEPTH 筆已轉送的感測封包（firmware/base/replay.h），
+桌面端發現序號缺口時以 !P<pipe>,<seq>,<count> 要求重送；重送的樣本比後面的樣本晚到，
+這裡依各遠距端序號重新排序後再交給回調。
+
+- 每個缺口只要求一次（on_gap 回調），重送失敗不重試
+- 暫存跨度超過 depth 筆仍未補齊時放棄缺口（Base 也已覆蓋），照順序放出後面的樣本
+- 已放出序號之後才到的樣本（放棄後才補到的重送、重複封包）丟棄
+
+延遲代價只發生在有缺口時：連續序號直接放出，不經暫存。
+"""
+from typing import Callable, Optional
+
+SEQ_MOD = 65536
+
+
+class _PipeState:
+    __slots__ = ('next', 'highest', 'pending')
+
+    def __init__(self, seq: int):
+        self.next = seq          # 下一個要放出的序號
+        self.highest = (seq - 1) % SEQ_MOD  # 已收到的最大序號（含暫存）
+        self.pending: dict = {}  # seq → sample
+
+
+class ReorderBuffer:
+    """
+    各遠距端序號重排
+
+    push() 在讀取線程對每筆樣本呼叫，回傳依序號可放出的樣本
+    """
+
+    def __init__(self, depth: int, on_gap: Optional[Callable[[int, int, int], None]] = None):
+        """
+        Args:
+            depth: 最多暫存筆數（每個遠距端），通常 = Base REPLAY_DEPTH
+            on_gap: 發現新缺口時呼叫 on_gap(pipe, first_seq, count)
+        """
+        self.depth = depth
+        self.on_gap = on_gap
+        self._pipes: dict[int, _PipeState] = {}
+        self._stats = {'reordered': 0, 'skipped': 0, 'late': 0}
+
+    def push(self, sample) -> list:
+        """
+        加入一筆樣本
+
+        Args:
+            sample: SerialSample（需有 pipe、seq）
+
+        Returns:
+            依序號排好、可以交給回調的樣本（可能為空）
+        """
+        state = self._pipes.get(sample.pipe)
+        if state is None:
+            state = self._pipes[sample.pipe] = _PipeState(sample.seq)
+
+        ahead = (sample.seq - state.next) % SEQ_MOD
+        if ahead >= SEQ_MOD // 2 or sample.seq in state.pending:
+            self._stats['late'] += 1
+            return []
+
+        if ahead == 0 and not state.pending:
+            state.next = (sample.seq + 1) % SEQ_MOD
+            state.highest = sample.seq
+            return [sample]
+
+        state.pending[sample.seq] = sample
+
+        # 新缺口（已收到的最大序號之後到這筆之前）：要求重送暫存範圍內的序號
+        beyond = (sample.seq - state.highest) % SEQ_MOD
+        if beyond >= SEQ_MOD // 2:
+            self._stats['reordered'] += 1
+        else:
+            missing = min(beyond - 1, self.depth - 1)
+            if missing > 0 and self.on_gap:
+                self.on_gap(sample.pipe, (sample.seq - missing) % SEQ_MOD, missing)
+            state.highest = sample.seq
+
+        # 只保留最後 depth 個序號（含最大序號）的缺口，更早的放棄
+        floor = (state.highest - self.depth + 1) % SEQ_MOD
+        released = []
+        if 0 < (floor - state.next) % SEQ_MOD < SEQ_MOD // 2:
+            released = self._advance(state, floor)
+        return released + self._release(state)
+
+    def flush(self) -> list:
+        """放出所有暫存樣本（放棄剩下的缺口）並重新開始追蹤序號，例如切換到降頻輸出時"""
+        released = []
+        for state in self._pipes.values():
+            if state.pending:
+                released += self._advance(state, (state.highest + 1) % SEQ_MOD)
+        self._pipes.clear()
+        return released
+
+    def reset(self) -> None:
+        """清除所有狀態與統計"""
+        self._pipes.clear()
+        self._stats = {'reordered': 0, 'skipped': 0, 'late': 0}
+
+    @property
+    def stats(self) -> dict:
+        """
+        Returns:
+            {
+                'reordered': int,  # 補上缺口的樣本數（重送成功）
+                'skipped': int,    # 放棄的序號數（交由掉包統計計入）
+                'late': int,       # 丟棄的晚到 / 重複樣本數
+            }
+        """
+        return self._stats.copy()
+
+    def _advance(self, state: _PipeState, target: int) -> list:
+        """放棄 target 之前的缺口：依序放出其間的暫存樣本，next 移到 target"""
+        released = []
+        for seq in sorted(state.pending, key=lambda s: (s - state.next) % SEQ_MOD):
+            if (seq - state.next) % SEQ_MOD >= (target - state.next) % SEQ_MOD:
+                break
+            released.append(state.pending.pop(seq))
+        self._stats['skipped'] += (target - state.next) % SEQ_MOD - len(released)
+        state.next = target
+        return released
+
+    @staticmethod
+    def _release(state: _PipeState) -> list:
+        released = []
+        while state.next in state.pending:
+            released.append(state.pending.pop(state.next))
+            state.next = (state.next + 1) % SEQ_MOD
+        return released
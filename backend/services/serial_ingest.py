@@ -1,27 +1,113 @@
 """
 Serial Ingest Service
-從 Arduino Uno 讀取 CSV 格式的 IMU 資料
+從 Arduino Uno 讀取 CSV 格式（或 COBS 二進位框架）的 IMU 資料
 
 資料格式參考: docs/stage2/SERIAL_FORMAT.md
 """
 
 import asyncio
+import copy
 import serial
+import struct
 import time
 from typing import Callable, Optional
 from dataclasses import dataclass
-from threading import Thread, Event
+from threading import Thread, Event, Lock
 import logging
 
+from services.frame_decoder import (
+    FrameDecoder, Frame, STATS_FRAME, STATS_FRAME_LEGACY, BASE_STATS_FRAME, LINK_FRAME,
+    RPD_FRAME, SURVEY_FRAME, SURVEY_CHANNELS, ENVELOPE_FRAME, ENVELOPE_STATS,
+    FRAME_TYPE_RADIO, FRAME_TYPE_STATS, FRAME_TYPE_EVENT, FRAME_TYPE_BASE_STATS, FRAME_TYPE_LINK,
+    FRAME_TYPE_RPD, FRAME_TYPE_SURVEY, FRAME_TYPE_ENVELOPE,
+    FRAME_EVENT_BAUD, FRAME_EVENT_BAUD_OK, FRAME_EVENT_CMD_OK, FRAME_EVENT_CMD_ERR,
+    parse_frame_line,
+)
+from services.hex_decoder import parse_hex_line, HEX_LINE_PREFIX
+from services.latency import LatencyBreakdown
+from services.reorder import ReorderBuffer
+
 logger = logging.getLogger(__name__)
 
+# IMU 有效位元
+VALID_MPU1 = 0x01
+VALID_MPU2 = 0x02
+VALID_BOTH = VALID_MPU1 | VALID_MPU2
+
+# CSV 欄位數（15 = v2.0 舊格式，16 = 含 valid 欄位，17 = 含 pipe 欄位，18 = 含 t_base_us 欄位）
+CSV_FIELDS_LEGACY = 15
+CSV_FIELDS_VALID = 16
+CSV_FIELDS_PIPE = 17
+CSV_FIELDS = 18
+
+# 未標示管道的舊格式視為 pipe 1（單一遠距端時的位址 "MECH1"）
+DEFAULT_PIPE = 1
+
+# 無線封包（對應 firmware/common/packet.h）
+PROTOCOL_VERSION = 0x02
+PACKET_TYPE_PROFILE = 0x81
+PACKET_TYPE_HEALTH = 0x82
+SENSOR_PACKET = struct.Struct('<BHIB12h')
+PROFILE_PACKET = struct.Struct('<BBHHH8HII')
+HEALTH_PACKET = struct.Struct('<BBHIIIIHHHHHH')
+
+# 鮑率協商（對應 firmware/base/baud.h BAUD_RATES，索引即二進位事件參數）
+BAUD_RATES = (115200, 500000, 1000000, 2000000)
+BAUD_REPLY_TIMEOUT = 0.5   # 等待 Base 回覆 (秒)，須小於 BAUD_CONFIRM_MS
+COMMAND_REPLY_TIMEOUT = 0.5  # 等待 #ok / #err 回覆 (秒)
+
+# Base 指令碼（對應 firmware/base/command.h）
+COMMAND_MODE = 'M'
+COMMAND_INTERVAL = 'I'
+COMMAND_SNAPSHOT = 'S'
+COMMAND_CHANNEL = 'C'
+COMMAND_REMOTE = 'R'
+COMMAND_SURVEY = 'V'
+COMMAND_DECIMATE = 'D'
+COMMAND_RESEND = 'P'
+
+# 輸出模式（對應 firmware/base/main_base.ino OUTPUT_MODE_*）
+OUTPUT_MODE_CSV = 0
+OUTPUT_MODE_BINARY = 1
+OUTPUT_MODE_HEX = 2
+
+# 降頻輸出模式（對應 firmware/base/decimate.h）
+DECIMATE_MODE_ALL = 0
+DECIMATE_MODE_AVERAGE = 1
+DECIMATE_MODE_ENVELOPE = 2
+DECIMATE_WINDOW_MAX = 100
+
+# Base 重送緩衝筆數（firmware/base/replay.h REPLAY_DEPTH，所有遠距端共用）
+REPLAY_DEPTH = 6
+
+# 遠距端指令碼（對應 firmware/common/remote_command.h）
+REMOTE_CMD_CHANNEL = 'C'
+REMOTE_CMD_SAVE = 'W'
+
+# 遠距端迴圈階段（對應 firmware/common/packet.h PROFILE_PHASE_*）
+PROFILE_PHASES = ('imu', 'fill', 'rf')
+
+# #health 行欄位 → telemetry['health'] 鍵名
+HEALTH_FIELDS = {
+    'status': 'status',
+    'epoch': 'seq_epoch',
+    'up': 'uptime_ms',
+    'retx': 'retransmits',
+    'txfail': 'tx_fail',
+    'reinit': 'rf_reinit',
+    'i2c1': 'i2c_err1',
+    'i2c2': 'i2c_err2',
+    'overrun': 'overruns',
+    'busrec': 'bus_recoveries',
+}
+
 
 @dataclass
 class SerialSample:
     """
     Serial 資料樣本（對應實際 CSV 格式）
 
-    Format: seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2
+    Format: seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2[,valid[,pipe[,t_base_us]]]
     """
     seq: int            # 封包序號 (0~65535)
     t_remote_ms: int    # 遠距端時間戳 (ms)
@@ -43,29 +129,47 @@ class SerialSample:
     gy2: int            # 陀螺儀 Y raw
     gz2: int            # 陀螺儀 Z raw
 
+    # IMU 有效位元（bit0=MPU1, bit1=MPU2；無效的 IMU 欄位為 0）
+    valid: int = VALID_BOTH
+
+    # Base 接收管道（遠距端編號 0-5）
+    pipe: int = DEFAULT_PIPE
+
+    # Base 收到封包的時間（Base micros()，0 = 舊格式未提供）
+    t_base_us: int = 0
+
     # 接收時間戳（本地）
-    t_received_ns: int = 0  # 本地接收時間 (ns)
+    t_read_ns: int = 0      # 從 Serial 讀出的時間 (ns)
+    t_received_ns: int = 0  # 解析完成、回調前的時間 (ns)
 
 
 class SerialIngest:
     """
     Serial 讀取服務
 
-    從 Arduino Uno (115200 baud) 讀取 CSV 格式資料，
+    從 Arduino Uno (115200 baud) 讀取 CSV 格式資料（或二進位框架），
     提供統計資訊（pps, dropped, parse_err）
     """
 
-    def __init__(self, port: str, baud: int = 115200):
+    def __init__(self, port: str, baud: int = 115200, binary: bool = False,
+                 target_baud: Optional[int] = None, reorder_depth: int = 0):
         """
         初始化 Serial 連接
 
         Args:
             port: Serial port (e.g. "/dev/ttyUSB0", "COM3")
             baud: Baud rate (default: 115200)
+            binary: Base 是否為二進位輸出模式 (OUTPUT_MODE_BINARY)
+            target_baud: 開啟後與 Base 協商的鮑率（None = 不協商）
+            reorder_depth: 序號缺口時向 Base 要求重送並重排的暫存筆數
+                           （0 = 不重排，照收到順序回調；建議 REPLAY_DEPTH）
         """
         self.port = port
         self.baud = baud
+        self.binary = binary
+        self.target_baud = target_baud
         self.serial: Optional[serial.Serial] = None
+        self._decoder = FrameDecoder()
 
         # 執行控制
         self._running = False
@@ -77,11 +181,36 @@ class SerialIngest:
             'pps': 0.0,          # 每秒封包數
             'dropped': 0,        # 累計掉包數
             'parse_err': 0,      # 累計解析錯誤
+            'frame_err': 0,      # 累計框架錯誤（二進位模式 CRC / COBS）
             'total_rx': 0,       # 累計接收封包數
         }
 
-        # 掉包檢測
-        self._last_seq: Optional[int] = None
+        # 掉包檢測（每個遠距端各自追蹤序號）
+        self._last_seq: dict[int, int] = {}
+
+        # Base 降頻輸出：平均模式每筆樣本的序號間隔為視窗筆數
+        self._decimate_mode = DECIMATE_MODE_ALL
+        self._decimate_window = 1
+        self._pending_decimate: Optional[tuple[int, int]] = None
+
+        # 端到端延遲分段（遠距端 → Base → Serial 讀出 → 回調）
+        self._latency = LatencyBreakdown()
+
+        # 缺號重送與重排（見 services/reorder.py）
+        self._reorder: Optional[ReorderBuffer] = (
+            ReorderBuffer(reorder_depth, self._request_gap) if reorder_depth > 0 else None)
+
+        # 遠距端遙測（由 # 行解析），profile / health / remotes 以管道號碼為鍵
+        # 讀取線程寫入、API 線程取快照，兩邊都持有 _telemetry_lock（新管道會插入鍵，不能邊寫邊走訪）
+        self._telemetry_lock = Lock()
+        self._telemetry: dict = {'profile': {}, 'health': {}, 'remotes': {}, 'link': {}, 'base': {},
+                                 'rpd': {}, 'survey': {}, 'envelope': {}}
+
+        # 指令回覆（讀取線程解析 #ok / #err 後通知 send_command）
+        self._reply_event = Event()
+        self._reply_op: Optional[str] = None
+        self._reply_ok: Optional[bool] = None
+        self._pending_binary: Optional[bool] = None
 
         # PPS 計算
         self._pps_window_start = 0.0
@@ -117,6 +246,10 @@ class SerialIngest:
             logger.error(f"Failed to open serial port {self.port}: {e}")
             raise
 
+        # 鮑率協商（失敗時維持原鮑率）
+        if self.target_baud and self.target_baud != self.baud:
+            self.negotiate_baud(self.target_baud)
+
         # 初始化統計
         self._reset_stats()
         self._running = True
@@ -150,6 +283,239 @@ class SerialIngest:
 
         self._thread = None
 
+    def negotiate_baud(self, rate: int) -> bool:
+        """
+        與 Base 協商提高鮑率（見 firmware/base/baud.h）
+
+        !B<rate> → 等待 #baud=<rate> → 切換 → !K → 等待 #baud-ok=<rate>
+
+        Args:
+            rate: 目標鮑率（須在 BAUD_RATES 中）
+
+        Returns:
+            True = 已切換到 rate；False = 維持原鮑率（Base 逾時後也會自行退回）
+        """
+        if rate not in BAUD_RATES:
+            logger.warning(f"Unsupported baud rate: {rate}")
+            return False
+
+        original = self.serial.baudrate
+        self.serial.reset_input_buffer()
+        self.serial.write(f"!B{rate}\n".encode())
+        if not self._await_baud_reply(FRAME_EVENT_BAUD, rate):
+            logger.warning(f"Base did not accept baud {rate}, staying at {original}")
+            return False
+
+        self.serial.baudrate = rate
+        self.serial.reset_input_buffer()
+        self.serial.write(b"!K\n")
+        if not self._await_baud_reply(FRAME_EVENT_BAUD_OK, rate):
+            logger.warning(f"Baud {rate} not confirmed, falling back to {original}")
+            self.serial.baudrate = original
+            return False
+
+        self.baud = rate
+        logger.info(f"Serial baud negotiated: {rate}")
+        return True
+
+    def send_command(self, op: str, args: str = '',
+                     timeout: float = COMMAND_REPLY_TIMEOUT) -> Optional[bool]:
+        """
+        送出 Base 指令並等待回覆（見 firmware/base/command.h）
+
+        讀取線程執行中時由它解析回覆；尚未 start() 時在這裡直接讀取
+        （期間收到的樣本只更新遙測，不回調）。
+
+        Args:
+            op: 指令碼（COMMAND_*）
+            args: 參數字串
+            timeout: 等待回覆秒數
+
+        Returns:
+            True = #ok，False = #err，None = 逾時
+        """
+        self._reply_op = op
+        self._reply_ok = None
+        self._reply_event.clear()
+        self.serial.write(f"!{op}{args}\n".encode())
+
+        if self._running:
+            self._reply_event.wait(timeout)
+        else:
+            deadline = time.monotonic() + timeout
+            while not self._reply_event.is_set() and time.monotonic() < deadline:
+                self._pump_once()
+
+        self._reply_op = None
+        return self._reply_ok
+
+    def set_output_mode(self, binary: bool, hex_lines: bool = False) -> Optional[bool]:
+        """
+        切換 Base 輸出模式（!M）；Base 以原模式回覆，收到 #ok 後本地跟著切換
+
+        Args:
+            binary: True = 二進位框架
+            hex_lines: 文字模式下改用固定寬度十六進位 $ 行（見 services/hex_decoder.py）
+        """
+        self._pending_binary = binary
+        if binary:
+            mode = OUTPUT_MODE_BINARY
+        else:
+            mode = OUTPUT_MODE_HEX if hex_lines else OUTPUT_MODE_CSV
+        return self.send_command(COMMAND_MODE, str(mode))
+
+    def set_stats_interval(self, interval_ms: int, text: Optional[bool] = None) -> Optional[bool]:
+        """
+        設定統計輸出間隔（!I，100 ~ 60000 ms）
+
+        Args:
+            interval_ms: 輸出間隔
+            text: 文字模式的統計格式 True = key=value 文字行（除錯用，不解析）、
+                  False = #f 框架行（預設）、None = 不變
+        """
+        args = str(interval_ms) if text is None else f"{interval_ms},{int(text)}"
+        return self.send_command(COMMAND_INTERVAL, args)
+
+    def request_stats(self) -> Optional[bool]:
+        """立即輸出一次統計（!S），結果更新 telemetry"""
+        return self.send_command(COMMAND_SNAPSHOT)
+
+    def set_channel(self, channel: int) -> Optional[bool]:
+        """
+        切換頻道（!C）：Base 先經 ACK payload 通知所有在線遠距端，
+        全部送達（最多 200 ms）後自己再切換；離線的遠距端需另行設定
+
+        新頻道只存在 Base 的 RAM：Base 重新上電回到預設頻道 RF_CHANNEL。
+        遠距端可用 send_remote_command(pipe, 'W') 把頻道寫入 EEPROM，但 Base 重新上電後
+        遠距端連續 3 秒（RF_CHANNEL_FALLBACK_MS）收不到 ACK 就在儲存的頻道與 RF_CHANNEL 之間輪流嘗試，
+        不會因此失聯；要長期使用其他頻道，每次 Base 上電後再送一次 !C
+        """
+        return self.send_command(COMMAND_CHANNEL, str(channel))
+
+    def send_remote_command(self, pipe: int, op: str, arg: Optional[int] = None) -> Optional[bool]:
+        """
+        轉送遠距端指令（!R），隨該遠距端下一個封包的 ACK 送達
+
+        Args:
+            pipe: 遠距端編號 0-5（須在線）
+            op: REMOTE_CMD_*
+            arg: 0 ~ 65535（None = 無參數）
+        """
+        return self.send_command(COMMAND_REMOTE, f"{pipe}{op}{'' if arg is None else arg}")
+
+    def request_survey(self) -> Optional[bool]:
+        """
+        請 Base 掃描 0-125 頻道（!V，約 4 秒）
+
+        結果以 #survey 行 / SURVEY 框架回報，存入 telemetry['survey']
+        """
+        return self.send_command(COMMAND_SURVEY)
+
+    def set_decimation(self, mode: int, window: int = 1) -> Optional[bool]:
+        """
+        設定 Base 降頻輸出（!D<mode>[,<n>]）
+
+        - DECIMATE_MODE_ALL：每筆輸出（window 忽略）
+        - DECIMATE_MODE_AVERAGE：每 window 筆輸出一筆平均樣本（格式不變，序號間隔 = window）
+        - DECIMATE_MODE_ENVELOPE：每 window 筆輸出各軸 min / max / mean，存入 telemetry['envelope']
+
+        Args:
+            mode: DECIMATE_MODE_*
+            window: 視窗筆數 1 ~ DECIMATE_WINDOW_MAX
+        """
+        if mode == DECIMATE_MODE_ALL:
+            window = 1
+        self._pending_decimate = (mode, window)
+        args = str(mode) if mode == DECIMATE_MODE_ALL else f"{mode},{window}"
+        return self.send_command(COMMAND_DECIMATE, args)
+
+    def request_resend(self, pipe: int, seq: int, count: int = 1) -> Optional[bool]:
+        """
+        要求 Base 重送最近轉送過的感測樣本（!P，見 firmware/base/replay.h）
+
+        重送的樣本在回覆之前送達，照一般樣本解析；降頻模式下 Base 不保留樣本（回覆 #err）
+
+        Args:
+            pipe: 遠距端管道
+            seq: 起始序號
+            count: 筆數 1 ~ REPLAY_DEPTH
+
+        Returns:
+            True = 至少重送一筆，False = 參數錯誤或都已被覆蓋，None = 逾時
+        """
+        return self.send_command(COMMAND_RESEND, f"{pipe},{seq},{count}")
+
+    def _request_gap(self, pipe: int, seq: int, count: int):
+        """
+        重排緩衝發現缺口（讀取線程）：送出 !P 不等回覆
+
+        讀取線程無法等待自己解析的回覆；重送失敗時由重排緩衝放棄缺口
+        """
+        try:
+            self.serial.write(f"!{COMMAND_RESEND}{pipe},{seq},{count}\n".encode())
+        except serial.SerialException as e:
+            logger.debug(f"Resend request failed: {e}")
+
+    def _pump_once(self):
+        """讀取一次可用資料並解析（讀取線程未執行時使用）"""
+        if self.binary:
+            data = self.serial.read(max(1, self.serial.in_waiting))
+            for frame in self._decoder.feed(data):
+                self.handle_frame(frame)
+        else:
+            line = self.serial.readline().decode('utf-8', errors='ignore').strip()
+            self.parse_line(line)
+
+    def _command_reply(self, op: str, ok: bool):
+        """
+        收到 #ok / #err：通知等待中的 send_command
+
+        Args:
+            op: 指令碼
+            ok: 是否成功
+        """
+        if op != self._reply_op:
+            return
+        if op == COMMAND_DECIMATE and ok and self._pending_decimate is not None:
+            self._decimate_mode, self._decimate_window = self._pending_decimate
+            self._last_seq = {}
+        if op == COMMAND_MODE and ok and self._pending_binary is not None:
+            # Base 回覆後即切換輸出格式
+            self.binary = self._pending_binary
+            self._decoder = FrameDecoder()
+        self._pending_binary = None
+        self._reply_ok = ok
+        self._reply_event.set()
+
+    def _await_baud_reply(self, event: int, rate: int) -> bool:
+        """
+        等待 Base 的鮑率回覆（文字行或二進位事件框架）
+
+        Args:
+            event: FRAME_EVENT_BAUD（#baud=）或 FRAME_EVENT_BAUD_OK（#baud-ok=）
+            rate: 預期的鮑率
+        """
+        tag = b'#baud-ok=' if event == FRAME_EVENT_BAUD_OK else b'#baud='
+        text = tag + str(rate).encode() + b'\r'
+        expected = bytes((event, BAUD_RATES.index(rate)))
+        decoder = FrameDecoder()
+        tail = b''
+
+        deadline = time.monotonic() + BAUD_REPLY_TIMEOUT
+        while time.monotonic() < deadline:
+            data = self.serial.read(max(1, self.serial.in_waiting))
+            if not data:
+                continue
+            if self.binary:
+                for frame in decoder.feed(data):
+                    if frame.type == FRAME_TYPE_EVENT and frame.payload[:2] == expected:
+                        return True
+            else:
+                tail = (tail + data)[-64:]
+                if text in tail:
+                    return True
+        return False
+
     def _read_loop(self, on_sample: Callable[[SerialSample], None]):
         """
         讀取循環（運行在獨立線程）
@@ -172,7 +538,12 @@ class SerialIngest:
                         logger.error("[ReadLoop] Serial not open!")
                         break
 
+                    if self.binary:
+                        self._read_frames(on_sample)
+                        continue
+
                     line_bytes = self.serial.readline()
+                    t_read_ns = time.time_ns()
 
                     # 記錄 timeout 情況
                     if not line_bytes:
@@ -201,25 +572,8 @@ class SerialIngest:
                     if sample:
                         # 重置連續錯誤計數
                         consecutive_errors = 0
-
-                        # 記錄接收時間
-                        sample.t_received_ns = time.time_ns()
-
-                        # 掉包檢測
-                        dropped = self._check_drop(sample.seq)
-                        if dropped > 0:
-                            self._stats['dropped'] += dropped
-                            logger.warning(f"Dropped {dropped} packets (seq: {self._last_seq} -> {sample.seq})")
-
-                        # 更新統計
-                        self._stats['total_rx'] += 1
-                        self._update_pps()
-
-                        # 回調
-                        try:
-                            on_sample(sample)
-                        except Exception as e:
-                            logger.error(f"Callback error: {e}")
+                        sample.t_read_ns = t_read_ns
+                        self._deliver(sample, on_sample)
 
                 except serial.SerialException as e:
                     consecutive_errors += 1
@@ -242,6 +596,177 @@ class SerialIngest:
             self._running = False
             logger.info("Read loop ended")
 
+    def _read_frames(self, on_sample: Callable[[SerialSample], None]):
+        """
+        二進位模式：讀取可用位元組並解碼框架
+
+        Args:
+            on_sample: 回調函數
+        """
+        data = self.serial.read(max(1, self.serial.in_waiting))
+        if not data:
+            return
+        t_read_ns = time.time_ns()
+
+        # 同一批讀出的框架共用讀出時間
+        for frame in self._decoder.feed(data):
+            sample = self.handle_frame(frame)
+            if sample:
+                sample.t_read_ns = t_read_ns
+                self._deliver(sample, on_sample)
+
+        errors = self._decoder.stats
+        self._stats['frame_err'] = errors['crc_err'] + errors['cobs_err'] + errors['overflow']
+
+    def _deliver(self, sample: SerialSample, on_sample: Callable[[SerialSample], None]):
+        """
+        記錄接收時間，需要時依序號重排後交給 _emit
+
+        Args:
+            sample: 解析完成的樣本
+            on_sample: 回調函數
+        """
+        # 記錄接收時間
+        sample.t_received_ns = time.time_ns()
+        self._latency.update(sample)
+
+        # 重排：降頻輸出的序號本來就不連續，也沒有重送
+        if self._reorder is not None and self._decimate_mode == DECIMATE_MODE_ALL:
+            for ordered in self._reorder.push(sample):
+                self._emit(ordered, on_sample)
+        else:
+            if self._reorder is not None:
+                for pending in self._reorder.flush():
+                    self._emit(pending, on_sample)
+            self._emit(sample, on_sample)
+
+    def _emit(self, sample: SerialSample, on_sample: Callable[[SerialSample], None]):
+        """
+        依序號順序交出一筆樣本：掉包檢測、更新統計並回調
+
+        Args:
+            sample: 樣本
+            on_sample: 回調函數
+        """
+        # 掉包檢測
+        last_seq = self._last_seq.get(sample.pipe)
+        dropped = self._check_drop(sample.seq, sample.pipe)
+        if dropped > 0:
+            self._stats['dropped'] += dropped
+            logger.warning(f"Dropped {dropped} packets on pipe {sample.pipe} (seq: {last_seq} -> {sample.seq})")
+
+        # 更新統計
+        self._stats['total_rx'] += 1
+        self._update_pps()
+
+        # 回調
+        try:
+            on_sample(sample)
+        except Exception as e:
+            logger.error(f"Callback error: {e}")
+
+    def handle_frame(self, frame: Frame) -> Optional[SerialSample]:
+        """
+        處理一個二進位框架
+
+        Args:
+            frame: FrameDecoder 解碼結果
+
+        Returns:
+            感測封包轉為 SerialSample；遙測 / 統計 / 事件框架更新狀態後回傳 None
+        """
+        if frame.type == FRAME_TYPE_RADIO:
+            sample = self.parse_payload(frame.payload, frame.pipe)
+            if sample:
+                sample.t_base_us = frame.t_base_us
+            return sample
+
+        if frame.type == FRAME_TYPE_STATS and len(frame.payload) == STATS_FRAME.size:
+            rx, lost, pps_x10, dup, late = STATS_FRAME.unpack(frame.payload)
+            self._set_telemetry('remotes', frame.pipe, {
+                'rx': rx, 'lost': lost, 'pps': pps_x10 / 10.0, 'dup': dup, 'late': late,
+            })
+        elif frame.type == FRAME_TYPE_STATS and len(frame.payload) == STATS_FRAME_LEGACY.size:
+            rx, lost, pps_x10 = STATS_FRAME_LEGACY.unpack(frame.payload)
+            self._set_telemetry('remotes', frame.pipe, {'rx': rx, 'lost': lost, 'pps': pps_x10 / 10.0})
+        elif frame.type == FRAME_TYPE_LINK and len(frame.payload) == LINK_FRAME.size:
+            values = LINK_FRAME.unpack(frame.payload)
+            self._set_telemetry('link', frame.pipe, {
+                'iat_min_us': values[0], 'iat_max_us': values[1], 'jitter_us': values[2],
+                'gap_max': values[3], 'bursts': values[4], 'burst_hist': list(values[5:11]),
+                'ge_p_permille': values[11], 'ge_r_permille': values[12],
+            })
+        elif frame.type == FRAME_TYPE_BASE_STATS and len(frame.payload) == BASE_STATS_FRAME.size:
+            tx_drop, tx_bytes, tx_high_water, rx_overflow = BASE_STATS_FRAME.unpack(frame.payload)
+            self._set_telemetry('base', None, {
+                'tx_drop': tx_drop, 'tx_bytes': tx_bytes,
+                'tx_high_water': tx_high_water, 'rx_overflow': rx_overflow,
+            })
+        elif frame.type == FRAME_TYPE_RPD and len(frame.payload) == RPD_FRAME.size:
+            channel, samples, hits = RPD_FRAME.unpack(frame.payload)
+            busy = (hits * 1000 + samples // 2) // samples if samples else 0
+            self._set_telemetry('rpd', None, {'channel': channel, 'samples': samples, 'busy_permille': busy})
+        elif frame.type == FRAME_TYPE_ENVELOPE and len(frame.payload) == ENVELOPE_FRAME.size:
+            seq, count, flags, *values = ENVELOPE_FRAME.unpack(frame.payload)
+            stat = (flags >> 1) & 0x03
+            if stat < len(ENVELOPE_STATS):
+                self._store_envelope(frame.pipe, seq, count, flags >> 6, flags & 0x01,
+                                     ENVELOPE_STATS[stat], values)
+        elif frame.type == FRAME_TYPE_SURVEY and len(frame.payload) == SURVEY_FRAME.size:
+            start, passes, packed = SURVEY_FRAME.unpack(frame.payload)
+            hits = []
+            for byte in packed:
+                hits += [byte & 0x0F, byte >> 4]
+            self._store_survey(start, passes, hits)
+        elif frame.type == FRAME_TYPE_EVENT and len(frame.payload) >= 2:
+            code, arg = frame.payload[0], frame.payload[1]
+            if code in (FRAME_EVENT_CMD_OK, FRAME_EVENT_CMD_ERR):
+                self._command_reply(chr(arg), code == FRAME_EVENT_CMD_OK)
+            else:
+                logger.info(f"Base event {code} (arg={arg})")
+        else:
+            self._stats['parse_err'] += 1
+        return None
+
+    def parse_payload(self, payload: bytes, pipe: int = DEFAULT_PIPE) -> Optional[SerialSample]:
+        """
+        解析 32-byte 無線封包原始內容（依 Byte 0 分派）
+
+        Args:
+            payload: RadioPayload 原始位元組
+            pipe: 接收管道（遠距端編號）
+
+        Returns:
+            SerialSample 或 None（遙測封包存入 telemetry）
+        """
+        if len(payload) != SENSOR_PACKET.size:
+            self._stats['parse_err'] += 1
+            return None
+
+        kind = payload[0]
+        if kind == PROTOCOL_VERSION:
+            _, seq, t_remote_ms, flags, *imu = SENSOR_PACKET.unpack(payload)
+            return SerialSample(seq, t_remote_ms, flags & 0x01, *imu, valid=flags >> 6, pipe=pipe)
+
+        if kind == PACKET_TYPE_PROFILE:
+            _, phase, count, min_us, max_us, *rest = PROFILE_PACKET.unpack(payload)
+            name = PROFILE_PHASES[phase] if phase < len(PROFILE_PHASES) else str(phase)
+            self._set_profile(pipe, name, {
+                'count': count,
+                'min_us': min_us,
+                'max_us': max_us,
+                'window_ms': rest[8],
+                'hist': list(rest[:8]),
+            })
+        elif kind == PACKET_TYPE_HEALTH:
+            values = HEALTH_PACKET.unpack(payload)
+            # 跳過 type / seq / reserved，其餘順序與 HEALTH_FIELDS 相同
+            fields = (values[1],) + values[3:-1]
+            self._set_telemetry('health', pipe, dict(zip(HEALTH_FIELDS.values(), fields)))
+        else:
+            self._stats['parse_err'] += 1
+        return None
+
     def parse_line(self, line: str) -> Optional[SerialSample]:
         """
         解析一行 CSV 資料
@@ -252,15 +777,20 @@ class SerialIngest:
         Returns:
             SerialSample 或 None（忽略 # 開頭或格式錯誤）
         """
-        # 忽略空行和狀態行
-        if not line or line.startswith('#'):
+        # 忽略空行；狀態行只解析遙測內容
+        if not line:
+            return None
+        if line.startswith('#'):
+            self._parse_status_line(line)
             return None
+        if line.startswith(HEX_LINE_PREFIX):
+            return self._parse_hex_line(line)
 
         # 分割 CSV
         parts = line.split(',')
-        if len(parts) != 15:
+        if len(parts) not in (CSV_FIELDS_LEGACY, CSV_FIELDS_VALID, CSV_FIELDS_PIPE, CSV_FIELDS):
             self._stats['parse_err'] += 1
-            logger.debug(f"Invalid CSV format (expected 15 fields, got {len(parts)}): {line[:50]}")
+            logger.debug(f"Invalid CSV format (expected {CSV_FIELDS} fields, got {len(parts)}): {line[:50]}")
             return None
 
         # 解析各欄位
@@ -281,35 +811,194 @@ class SerialIngest:
                 gx2=int(parts[12]),
                 gy2=int(parts[13]),
                 gz2=int(parts[14]),
+                valid=int(parts[15]) if len(parts) > CSV_FIELDS_LEGACY else VALID_BOTH,
+                pipe=int(parts[16]) if len(parts) > CSV_FIELDS_VALID else DEFAULT_PIPE,
+                t_base_us=int(parts[17]) if len(parts) > CSV_FIELDS_PIPE else 0,
             )
         except ValueError as e:
             self._stats['parse_err'] += 1
             logger.debug(f"Parse error: {e}, line: {line[:50]}")
             return None
 
-    def _check_drop(self, current_seq: int) -> int:
+    def _parse_hex_line(self, line: str) -> Optional[SerialSample]:
+        """
+        解析一行固定寬度十六進位資料（OUTPUT_MODE_HEX）
+
+        Args:
+            line: $ 開頭的一行
+
+        Returns:
+            SerialSample 或 None（格式錯誤）
+        """
+        values = parse_hex_line(line)
+        if values is None:
+            self._stats['parse_err'] += 1
+            logger.debug(f"Invalid hex line: {line[:50]}")
+            return None
+        seq, t_remote_ms, flags, *imu, pipe, t_base_us = values
+        return SerialSample(seq, t_remote_ms, flags & 0x01, *imu,
+                            valid=flags >> 6, pipe=pipe, t_base_us=t_base_us)
+
+    def _parse_status_line(self, line: str):
         """
-        檢測掉包
+        解析遙測狀態行（其餘 # 行忽略）
+
+        #prof,pipe=<p>,phase=<n>,n=<count>,min=<us>,max=<us>,win=<ms>,h=<b0>/.../<b7>
+        #health,pipe=<p>,status=<s>,epoch=<n>,up=<ms>,retx=<n>,txfail=<n>,reinit=<n>,i2c1=<n>,i2c2=<n>,overrun=<n>,busrec=<n>
+        #link,pipe=<p>,iat=<min>/<max>,jit=<us>,gap=<n>,h=<b0>/.../<b5>,ge=<p%>/<r%>
+        #rpd,ch=<channel>,n=<samples>,busy=<x.x>%
+        #survey,ch=<start>,n=<passes>,rpd=<每頻道一個十六進位數字>
+        #env,<pipe>,<seq>,<n>,<valid>,<btn>,<min|max|mean>,<ax1>,...,<gz2>（降頻包絡，依位置）
+        #f,<hex>（統計框架行，內容同二進位框架，交給 handle_frame）
+        #ok,<op> / #err,<op>（指令回覆）
+        （無 pipe 欄位的舊格式視為 DEFAULT_PIPE）
+
+        Args:
+            line: 以 # 開頭的一行
+        """
+        tag, _, body = line[1:].partition(',')
+        if tag == 'f':
+            frame = parse_frame_line(line)
+            if frame is None:
+                logger.debug(f"Bad frame line: {line[:80]}")
+            elif frame.type != FRAME_TYPE_RADIO:
+                self.handle_frame(frame)
+            return
+        if tag in ('ok', 'err'):
+            self._command_reply(body[:1], tag == 'ok')
+            return
+        if tag == 'env':
+            parts = body.split(',')
+            if len(parts) == 6 + 12 and parts[5] in ENVELOPE_STATS:
+                try:
+                    pipe, seq, count, valid, btn = (int(v) for v in parts[:5])
+                    self._store_envelope(pipe, seq, count, valid, btn, parts[5],
+                                         [int(v) for v in parts[6:]])
+                except ValueError as e:
+                    logger.debug(f"Bad envelope line: {e}, line: {line[:80]}")
+            return
+        if tag not in ('prof', 'health', 'link', 'rpd', 'survey'):
+            return
+
+        try:
+            fields = dict(kv.split('=', 1) for kv in body.split(','))
+            pipe = int(fields.get('pipe', DEFAULT_PIPE))
+            if tag == 'rpd':
+                self._set_telemetry('rpd', None, {
+                    'channel': int(fields['ch']),
+                    'samples': int(fields['n']),
+                    'busy_permille': round(float(fields['busy'].rstrip('%')) * 10),
+                })
+            elif tag == 'survey':
+                self._store_survey(int(fields['ch']), int(fields['n']),
+                                   [int(c, 16) for c in fields['rpd']])
+            elif tag == 'prof':
+                phase = int(fields['phase'])
+                name = PROFILE_PHASES[phase] if phase < len(PROFILE_PHASES) else str(phase)
+                self._set_profile(pipe, name, {
+                    'count': int(fields['n']),
+                    'min_us': int(fields['min']),
+                    'max_us': int(fields['max']),
+                    'window_ms': int(fields['win']),
+                    'hist': [int(v) for v in fields['h'].split('/')],
+                })
+            elif tag == 'link':
+                iat_min, iat_max = (int(v) for v in fields['iat'].split('/'))
+                hist = [int(v) for v in fields['h'].split('/')]
+                ge_p, ge_r = (round(float(v) * 10) for v in fields['ge'].split('/'))
+                self._set_telemetry('link', pipe, {
+                    'iat_min_us': iat_min, 'iat_max_us': iat_max, 'jitter_us': int(fields['jit']),
+                    'gap_max': int(fields['gap']), 'bursts': sum(hist), 'burst_hist': hist,
+                    'ge_p_permille': ge_p, 'ge_r_permille': ge_r,
+                })
+            else:
+                self._set_telemetry('health', pipe, {
+                    name: int(fields[key]) for key, name in HEALTH_FIELDS.items()
+                })
+        except (KeyError, ValueError) as e:
+            logger.debug(f"Bad telemetry line: {e}, line: {line[:80]}")
+
+    def _store_survey(self, start: int, passes: int, hits: list[int]):
+        """
+        存入一段頻譜掃描結果（每次掃描分 3 段送達）
+
+        Args:
+            start: 第一個頻道
+            passes: 每頻道取樣次數
+            hits: 各頻道 RPD 命中次數
+        """
+        with self._telemetry_lock:
+            survey = self._telemetry['survey']
+            if survey.get('passes') != passes or 'hits' not in survey:
+                survey['passes'] = passes
+                survey['hits'] = [None] * SURVEY_CHANNELS
+            end = min(start + len(hits), SURVEY_CHANNELS)
+            survey['hits'][start:end] = hits[:end - start]
+
+    def _store_envelope(self, pipe: int, seq: int, count: int, valid: int, btn: int,
+                        stat: str, values: list[int]):
+        """
+        存入一筆包絡統計（每個視窗 min / max / mean 三筆，以 seq 歸組）
+
+        Args:
+            pipe: 接收管道
+            seq: 視窗最後一筆序號
+            count: 視窗筆數
+            valid: IMU 有效位元（視窗內取 AND）
+            btn: 按鈕狀態（視窗內取 OR）
+            stat: 'min' / 'max' / 'mean'
+            values: 12 軸數值（ax1 ... gz2）
+        """
+        with self._telemetry_lock:
+            envelope = self._telemetry['envelope'].get(pipe)
+            if envelope is None or envelope['seq'] != seq:
+                envelope = {'seq': seq, 'n': count, 'valid': valid, 'btn': btn}
+                self._telemetry['envelope'][pipe] = envelope
+            envelope[stat] = values
+
+    def _set_telemetry(self, section: str, pipe: Optional[int], value: dict):
+        """
+        寫入一筆遙測（讀取線程；與 telemetry / stats 的快照互斥）
+
+        Args:
+            section: telemetry 的分類鍵（'remotes'、'link'、'base' ...）
+            pipe: 接收管道；None = 整個分類只有一筆（'base'、'rpd'）
+            value: 最新內容
+        """
+        with self._telemetry_lock:
+            if pipe is None:
+                self._telemetry[section] = value
+            else:
+                self._telemetry[section][pipe] = value
+
+    def _set_profile(self, pipe: int, name: str, value: dict):
+        """寫入一個迴圈階段的耗時統計（telemetry['profile'][pipe][name]）"""
+        with self._telemetry_lock:
+            self._telemetry['profile'].setdefault(pipe, {})[name] = value
+
+    def _check_drop(self, current_seq: int, pipe: int = DEFAULT_PIPE) -> int:
+        """
+        檢測掉包（各遠距端序號獨立）
 
         Args:
             current_seq: 當前封包序號
+            pipe: 接收管道（遠距端編號）
 
         Returns:
-            掉包數量
+            掉包數量（重複或晚到的序號回傳 0，不倒退最新序號）
         """
-        if self._last_seq is None:
-            self._last_seq = current_seq
+        last_seq = self._last_seq.get(pipe)
+        if last_seq is None:
+            self._last_seq[pipe] = current_seq
             return 0
 
-        expected = (self._last_seq + 1) % 65536
-        if current_seq != expected:
-            # 計算掉包數（處理 uint16 溢位）
-            dropped = (current_seq - expected) % 65536
-            self._last_seq = current_seq
-            return dropped
-
-        self._last_seq = current_seq
-        return 0
+        # 計算掉包數（處理 uint16 溢位）；距離超過半圈視為舊序號
+        # 平均降頻時每筆樣本涵蓋 window 個序號
+        gap = (current_seq - last_seq - self._decimate_window) % 65536
+        if gap >= 32768:
+            return 0
+        self._last_seq[pipe] = current_seq
+        return gap
 
     def _update_pps(self):
         """更新 PPS 統計（每秒計算一次）"""
@@ -335,9 +1024,17 @@ class SerialIngest:
             'pps': 0.0,
             'dropped': 0,
             'parse_err': 0,
+            'frame_err': 0,
             'total_rx': 0,
         }
-        self._last_seq = None
+        self._last_seq = {}
+        self._latency.reset()
+        if self._reorder is not None:
+            self._reorder.reset()
+        self._decoder = FrameDecoder()
+        with self._telemetry_lock:
+            self._telemetry = {'profile': {}, 'health': {}, 'remotes': {}, 'link': {}, 'base': {},
+                               'rpd': {}, 'survey': {}, 'envelope': {}}
         self._pps_window_start = 0.0
         self._pps_window_count = 0
 
@@ -356,7 +1053,76 @@ class SerialIngest:
                 'pps': float,          # 每秒封包數
                 'dropped': int,        # 累計掉包數
                 'parse_err': int,      # 累計解析錯誤
+                'frame_err': int,      # 累計框架錯誤（二進位模式）
                 'total_rx': int,       # 累計接收封包數
+                'radio_lost': int,     # Base 統計的無線掉包數（各遠距端合計，STATS 框架）
+                'base_tx_drop': int,   # Base 端 Serial 傳送緩衝丟棄數（BASE_STATS 框架）
+            }
+        """
+        stats = self._stats.copy()
+        with self._telemetry_lock:
+            stats['radio_lost'] = sum(r['lost'] for r in self._telemetry['remotes'].values())
+            stats['base_tx_drop'] = self._telemetry['base'].get('tx_drop', 0)
+        return stats
+
+    @property
+    def latency(self) -> dict:
+        """
+        取得端到端延遲分段（見 services/latency.py）
+
+        Returns:
+            {
+                'radio': {pipe: {'n', 'mean_us', 'max_us'}},  # 採樣 → Base 收到（相對最小值）
+                'serial': {'n', 'mean_us', 'max_us'},         # Base 收到 → Serial 讀出（相對最小值）
+                'host': {'n', 'mean_us', 'max_us'},           # Serial 讀出 → 回調
+            }
+        """
+        return self._latency.snapshot()
+
+    @property
+    def reorder(self) -> dict:
+        """
+        取得缺號重送 / 重排統計（reorder_depth = 0 時為空）
+
+        Returns:
+            {'reordered': int, 'skipped': int, 'late': int}  # 見 services/reorder.py
+        """
+        return self._reorder.stats if self._reorder is not None else {}
+
+    @property
+    def telemetry(self) -> dict:
+        """
+        取得遠距端遙測（各遠距端最新一筆，以管道號碼為鍵）
+
+        Returns:
+            {
+                'profile': {
+                    pipe: {
+                        'imu' | 'fill' | 'rf': {
+                            'count', 'min_us', 'max_us', 'window_ms',
+                            'hist': [8 個對數分桶計數],
+                        },
+                    },
+                },
+                'health': {
+                    pipe: {
+                        'status', 'seq_epoch', 'uptime_ms', 'retransmits', 'tx_fail',
+                        'rf_reinit', 'i2c_err1', 'i2c_err2', 'overruns', 'bus_recoveries',
+                    },
+                },
+                'remotes': {pipe: {'rx', 'lost', 'pps', 'dup', 'late'}},  # 二進位模式 STATS 框架
+                'link': {
+                    pipe: {
+                        'iat_min_us', 'iat_max_us', 'jitter_us', 'gap_max', 'bursts',
+                        'burst_hist': [6 個叢集長度分桶：1, 2, 3-4, 5-8, 9-16, 17+],
+                        'ge_p_permille', 'ge_r_permille',  # Gilbert-Elliott 轉移機率
+                    },
+                },
+                'base': {'tx_drop', 'tx_bytes', 'tx_high_water', 'rx_overflow'},  # 二進位模式 BASE_STATS 框架
+                'rpd': {'channel', 'samples', 'busy_permille'},  # 工作頻道 RPD 佔用率
+                'survey': {'passes', 'hits': [126 個頻道的 RPD 命中次數，未收到為 None]},
+                'envelope': {pipe: {'seq', 'n', 'valid', 'btn', 'min', 'max', 'mean'}},  # 各 12 軸
             }
         """
-        return self._stats.copy()
+        with self._telemetry_lock:
+            return copy.deepcopy(self._telemetry)
@@ -0,0 +1,51 @@
+"""
+Test Frame Decoder
+測試二進位輸出模式的 COBS 框架解碼
+"""
+from services.frame_decoder import (
+    FrameDecoder, cobs_encode, cobs_decode, crc16, encode_frame,
+    FRAME_TYPE_RADIO, FRAME_TYPE_EVENT,
+)
+
+
+def test_crc16_check_value():
+    """CRC-16/CCITT-FALSE 檢查值與韌體 common/crc.h 相同"""
+    assert crc16(b"123456789") == 0x29B1
+
+
+def test_cobs_roundtrip():
+    """COBS 編碼不含 0x00，解碼還原"""
+    for data in (b"", b"\x00", b"\x11\x00\x22", bytes(range(256)), b"\x01" * 300):
+        encoded = cobs_encode(data)
+        assert b"\x00" not in encoded
+        assert cobs_decode(encoded) == data
+
+
+def test_decode_split_stream():
+    """框架跨多次 feed 仍可解碼"""
+    payload = bytes(range(32))
+    stream = encode_frame(FRAME_TYPE_RADIO, 123456, payload) * 3
+
+    decoder = FrameDecoder()
+    frames = []
+    for i in range(0, len(stream), 7):
+        frames += decoder.feed(stream[i:i + 7])
+
+    assert len(frames) == 3
+    assert frames[0].type == FRAME_TYPE_RADIO
+    assert frames[0].t_base_us == 123456
+    assert frames[0].payload == payload
+
+
+def test_resync_after_corruption():
+    """損毀框架計入 crc_err，下一個分隔符後立即重新同步"""
+    good = encode_frame(FRAME_TYPE_EVENT, 1, b"\x01\x02")
+    bad = bytearray(good)
+    bad[3] ^= 0x40
+
+    decoder = FrameDecoder()
+    frames = decoder.feed(b"\x55\x66\x00" + bytes(bad) + good)
+
+    assert len(frames) == 1
+    assert frames[0].payload == b"\x01\x02"
+    assert decoder.stats['crc_err'] + decoder.stats['cobs_err'] == 2
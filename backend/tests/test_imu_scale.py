@@ -0,0 +1,34 @@
+"""
+Test IMU Scale Table
+確認 backend/config.py 的比例尺與 firmware/common/imu_scale.h 一致
+"""
+import re
+from pathlib import Path
+
+import config
+
+IMU_SCALE_H = Path(__file__).resolve().parents[2] / "firmware" / "common" / "imu_scale.h"
+
+
+def _read_table(name: str) -> tuple[float, ...]:
+    """從標頭檔取出 constexpr 陣列內容"""
+    text = IMU_SCALE_H.read_text(encoding="utf-8")
+    match = re.search(name + r"\[\d+\]\s*=\s*\{([^}]*)\}", text)
+    assert match, f"{name} not found in {IMU_SCALE_H}"
+    return tuple(float(v.strip().rstrip("f")) for v in match.group(1).split(","))
+
+
+def test_accel_table_matches_firmware():
+    """加速度比例尺與韌體一致"""
+    assert _read_table("IMU_ACCEL_LSB_PER_G") == config.IMU_ACCEL_LSB_PER_G
+
+
+def test_gyro_table_matches_firmware():
+    """陀螺儀比例尺與韌體一致"""
+    assert _read_table("IMU_GYRO_LSB_PER_DPS") == config.IMU_GYRO_LSB_PER_DPS
+
+
+def test_default_scale():
+    """預設量程 ±2g / ±250 dps"""
+    assert config.ACCEL_SCALE == 16384.0
+    assert config.GYRO_SCALE == 131.0
@@ -0,0 +1,29 @@
+"""
+Test Processor
+測試前處理（IMU 有效位元處理）
+"""
+from services.serial_ingest import SerialSample, VALID_MPU1, VALID_BOTH
+from services.processor import Processor
+
+
+def make_raw(seq: int, gx1: int, gx2: int, valid: int = VALID_BOTH) -> SerialSample:
+    """建立測試用 SerialSample"""
+    return SerialSample(
+        seq=seq, t_remote_ms=seq * 10, btn=0,
+        ax1=0, ay1=0, az1=16384, gx1=gx1, gy1=0, gz1=0,
+        ax2=0, ay2=0, az2=16384, gx2=gx2, gy2=0, gz2=0,
+        valid=valid,
+    )
+
+
+def test_invalid_imu_holds_last_value():
+    """無效的 IMU 沿用最後一筆有效值，另一顆照常更新"""
+    proc = Processor()
+    proc.process(make_raw(0, gx1=131, gx2=262))
+
+    # MPU2 失效：韌體填 0，處理器應沿用上一筆
+    out = proc.process(make_raw(1, gx1=393, gx2=0, valid=VALID_MPU1))
+    assert out.gx1_dps == 3.0
+    assert out.gx2_dps == 2.0
+    assert out.az2_g == 1.0
+
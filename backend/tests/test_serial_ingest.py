@@ -0,0 +1,391 @@
+"""
+Test SerialIngest
+測試 Serial 資料行解析
+"""
+from threading import Thread
+
+from services.serial_ingest import (
+    SerialIngest, VALID_MPU1, VALID_BOTH,
+    SENSOR_PACKET, HEALTH_PACKET, PROTOCOL_VERSION, PACKET_TYPE_HEALTH,
+    REMOTE_CMD_CHANNEL, REMOTE_CMD_SAVE, DECIMATE_MODE_AVERAGE, REPLAY_DEPTH,
+)
+from services.hex_decoder import decode_hex_block
+from services.frame_decoder import (
+    FrameDecoder, encode_frame, FRAME_TYPE_RADIO, FRAME_TYPE_STATS, STATS_FRAME,
+    FRAME_TYPE_LINK, LINK_FRAME, FRAME_TYPE_RPD, RPD_FRAME, FRAME_TYPE_SURVEY, SURVEY_FRAME,
+    FRAME_TYPE_EVENT, FRAME_EVENT_CMD_OK, FRAME_EVENT_CMD_ERR,
+    FRAME_TYPE_ENVELOPE, ENVELOPE_FRAME, FRAME_TYPE_BASE_STATS, BASE_STATS_FRAME, Frame,
+)
+
+
+def test_parse_line_valid_field():
+    """CSV 第 16 欄為 valid；15 欄舊格式視為兩顆皆有效"""
+    ingest = SerialIngest("/dev/null")
+
+    legacy = ingest.parse_line("1,10,0,1,2,3,4,5,6,7,8,9,10,11,12")
+    assert legacy.valid == VALID_BOTH
+
+    partial = ingest.parse_line("1,10,0,1,2,3,4,5,6,0,0,0,0,0,0,1")
+    assert partial.valid == VALID_MPU1
+    assert partial.gz1 == 6
+
+
+def test_parse_profile_line():
+    """#prof 遙測行解析為階段統計，不產生樣本"""
+    ingest = SerialIngest("/dev/null")
+
+    line = "#prof,phase=0,n=100,min=820,max=1460,win=3000,h=0/0/0/0/0/70/30/0"
+    assert ingest.parse_line(line) is None
+
+    prof = ingest.telemetry['profile'][1]['imu']
+    assert prof['count'] == 100
+    assert prof['max_us'] == 1460
+    assert prof['hist'][5] == 70
+
+
+def test_parse_health_line():
+    """#health 遙測行解析為遠距端健康計數"""
+    ingest = SerialIngest("/dev/null")
+
+    line = ("#health,status=0,epoch=2,up=1500000,retx=37,txfail=4,reinit=1,"
+            "i2c1=0,i2c2=12,overrun=0,busrec=1")
+    assert ingest.parse_line(line) is None
+
+    health = ingest.telemetry['health'][1]
+    assert health['seq_epoch'] == 2
+    assert health['i2c_err2'] == 12
+    assert health['rf_reinit'] == 1
+
+
+def test_binary_sensor_frame():
+    """二進位模式：RADIO 框架中的感測封包轉為 SerialSample"""
+    ingest = SerialIngest("/dev/null", binary=True)
+
+    payload = SENSOR_PACKET.pack(PROTOCOL_VERSION, 7, 7000, 0x41, *range(1, 13))
+    frame, = FrameDecoder().feed(encode_frame(FRAME_TYPE_RADIO, 99, payload))
+    sample = ingest.handle_frame(frame)
+
+    assert sample.seq == 7
+    assert sample.btn == 1
+    assert sample.valid == VALID_MPU1
+    assert sample.gz2 == 12
+
+
+def test_multi_remote_pipes():
+    """多個遠距端交錯：pipe 隨樣本輸出，序號各自追蹤不誤判掉包"""
+    ingest = SerialIngest("/dev/null")
+    samples = []
+    for seq in range(3):
+        for pipe in (1, 2):
+            line = f"{seq + pipe * 100},10,0,1,2,3,4,5,6,7,8,9,10,11,12,3,{pipe}"
+            sample = ingest.parse_line(line)
+            ingest._deliver(sample, samples.append)
+    assert [s.pipe for s in samples[:2]] == [1, 2]
+    assert ingest.stats['dropped'] == 0
+
+    ingest.parse_line("#health,pipe=2,status=1,epoch=0,up=5,retx=0,txfail=0,reinit=0,"
+                      "i2c1=3,i2c2=0,overrun=0,busrec=0")
+    assert ingest.telemetry['health'][2]['i2c_err1'] == 3
+    assert 1 not in ingest.telemetry['health']
+
+    binary = SerialIngest("/dev/null", binary=True)
+    payload = SENSOR_PACKET.pack(PROTOCOL_VERSION, 7, 7000, 0xC0, *range(1, 13))
+    frame, = FrameDecoder().feed(encode_frame(FRAME_TYPE_RADIO | (4 << 4), 99, payload))
+    assert frame.type == FRAME_TYPE_RADIO
+    assert binary.handle_frame(frame).pipe == 4
+
+
+def test_base_arrival_time_and_latency():
+    """t_base_us：CSV 第 18 欄與框架標頭相同；分段延遲以視窗最小值為基準"""
+    ingest = SerialIngest("/dev/null")
+    line = ingest.parse_line("5,50,0,1,2,3,4,5,6,7,8,9,10,11,12,3,2,4294967000")
+    assert line.t_base_us == 4294967000 and line.pipe == 2
+
+    binary = SerialIngest("/dev/null", binary=True)
+    payload = SENSOR_PACKET.pack(PROTOCOL_VERSION, 5, 50, 0xC0, *range(1, 13))
+    frame, = FrameDecoder().feed(encode_frame(FRAME_TYPE_RADIO | (2 << 4), 4294967000, payload))
+    assert binary.handle_frame(frame).t_base_us == 4294967000
+
+    # Base micros() 於第二筆溢位；第二筆在無線段多 300 us、Serial 段多 1000 us
+    for seq, t_remote_ms, t_base_us, t_read_us in ((1, 10, 4294967000, 5_000_000),
+                                                   (2, 20, 10004, 5_011_300)):
+        sample = ingest.parse_line(f"{seq},{t_remote_ms},0,1,2,3,4,5,6,7,8,9,10,11,12,3,1,{t_base_us}")
+        sample.t_read_ns = t_read_us * 1000
+        ingest._deliver(sample, lambda s: None)
+
+    latency = ingest.latency
+    assert latency['radio'][1] == {'n': 2, 'mean_us': 150.0, 'max_us': 300}
+    assert latency['serial']['max_us'] == 1000
+    assert latency['host']['n'] == 2
+
+
+def test_envelope_line_matches_frame():
+    """#env 行與 ENVELOPE 框架解析結果相同；平均降頻時序號間隔為視窗筆數"""
+    values = list(range(-6, 6))
+    text = SerialIngest("/dev/null")
+    for stat in ('min', 'max', 'mean'):
+        text.parse_line(f"#env,2,500,10,1,1,{stat}," + ",".join(str(v) for v in values))
+
+    binary = SerialIngest("/dev/null", binary=True)
+    decoder = FrameDecoder()
+    for stat in range(3):
+        payload = ENVELOPE_FRAME.pack(500, 10, 0x41 | (stat << 1), *values)
+        frame, = decoder.feed(encode_frame(FRAME_TYPE_ENVELOPE | (2 << 4), 0, payload))
+        binary.handle_frame(frame)
+
+    envelope = text.telemetry['envelope'][2]
+    assert envelope == binary.telemetry['envelope'][2]
+    assert envelope['n'] == 10 and envelope['valid'] == VALID_MPU1 and envelope['btn'] == 1
+    assert envelope['max'] == values
+
+    text.serial = FakeBaseSerial()
+    assert text.set_decimation(DECIMATE_MODE_AVERAGE, 10) is True
+    assert text.set_decimation(3, 10) is False
+    assert [text._check_drop(seq) for seq in (10, 20, 31, 41)] == [0, 0, 1, 0]
+
+
+def test_hex_line_matches_csv():
+    """十六進位 $ 行（韌體 csv_format_sensor_hex 輸出）與十進位 CSV 行解析結果相同"""
+    ingest = SerialIngest("/dev/null")
+    hex_line = ("$beef,075bcd15,c1,ffff,0001,0000,0000,0000,0000,"
+                "0000,0000,0000,0000,8000,4000,05,ffffffff")
+    csv_line = "48879,123456789,1,-1,1,0,0,0,0,0,0,0,0,-32768,16384,3,5,4294967295"
+
+    sample = ingest.parse_line(hex_line)
+    expected = ingest.parse_line(csv_line)
+    assert sample == expected
+    assert ingest.parse_line(hex_line[:-1]) is None
+    assert ingest.parse_line(hex_line.replace('c1', 'g1')) is None
+    assert ingest.stats['parse_err'] == 2
+
+    block = (hex_line + "\r\n" + hex_line.replace(',', ';', 1) + "\r\n" + hex_line + "\r\n").encode()
+    samples = decode_hex_block(block)
+    assert len(samples) == 2
+    assert samples[0]['seq'] == 48879
+    assert list(samples[1]['imu'][-2:]) == [-32768, 16384]
+    assert samples[1]['t_base_us'] == 4294967295
+
+
+def test_stats_frame_line_matches_frame():
+    """文字模式 #f 框架行（韌體 frame_print）與二進位 STATS / BASE_STATS 框架解析結果相同，併入 stats"""
+    text = SerialIngest("/dev/null")
+    binary = SerialIngest("/dev/null", binary=True)
+    records = [
+        (FRAME_TYPE_STATS | (2 << 4), STATS_FRAME.pack(4925, 2, 985, 1, 0)),
+        (FRAME_TYPE_BASE_STATS, BASE_STATS_FRAME.pack(3, 270, 180, 0)),
+    ]
+    for frame_type, payload in records:
+        header = bytes((frame_type,)) + (123456).to_bytes(4, 'little')
+        assert text.parse_line("#f," + (header + payload).hex()) is None
+        frame, = FrameDecoder().feed(encode_frame(frame_type, 123456, payload))
+        binary.handle_frame(frame)
+
+    assert text.telemetry['remotes'] == binary.telemetry['remotes']
+    assert text.telemetry['remotes'][2] == {'rx': 4925, 'lost': 2, 'pps': 98.5, 'dup': 1, 'late': 0}
+    assert text.telemetry['base'] == binary.telemetry['base']
+    assert text.stats['radio_lost'] == 2
+    assert text.stats['base_tx_drop'] == 3
+
+    text.parse_line("#f,02zz")
+    text.parse_line("#pps=98.5,dropped=2,rx=4925,loss=0.0%,pipe=2,dup=1,late=0")  # 除錯文字行忽略
+    assert text.telemetry['remotes'][2]['rx'] == 4925
+
+
+def test_duplicate_and_late_seq_not_counted_as_drop():
+    """重複 / 晚到的序號不算掉包（舊版 Base 未過濾重複封包時）"""
+    ingest = SerialIngest("/dev/null")
+    drops = [ingest._check_drop(seq) for seq in (65534, 65535, 1, 1, 0, 2)]
+    assert drops == [0, 0, 1, 0, 0, 0]
+    assert ingest._check_drop(3) == 0
+    assert ingest._check_drop(6) == 2
+
+    binary = SerialIngest("/dev/null", binary=True)
+    frame, = FrameDecoder().feed(
+        encode_frame(FRAME_TYPE_STATS | (1 << 4), 0, STATS_FRAME.pack(100, 2, 995, 3, 1)))
+    binary.handle_frame(frame)
+    assert binary.telemetry['remotes'][1] == {'rx': 100, 'lost': 2, 'pps': 99.5, 'dup': 3, 'late': 1}
+
+
+def test_link_line_matches_frame():
+    """#link 行與 LINK 框架解析結果相同"""
+    text = SerialIngest("/dev/null")
+    text.parse_line("#link,pipe=2,iat=9800/12040,jit=35,gap=5,h=4/1/0/1/0/0,ge=0.6/50.0")
+
+    binary = SerialIngest("/dev/null", binary=True)
+    payload = LINK_FRAME.pack(9800, 12040, 35, 5, 6, 4, 1, 0, 1, 0, 0, 6, 500)
+    frame, = FrameDecoder().feed(encode_frame(FRAME_TYPE_LINK | (2 << 4), 0, payload))
+    binary.handle_frame(frame)
+
+    assert text.telemetry['link'][2] == binary.telemetry['link'][2]
+    assert binary.telemetry['link'][2]['ge_r_permille'] == 500
+
+
+def test_survey_line_matches_frame():
+    """#survey / #rpd 行與 SURVEY / RPD 框架解析結果相同"""
+    text = SerialIngest("/dev/null")
+    text.parse_line("#rpd,ch=76,n=500,busy=12.4%")
+    text.parse_line("#survey,ch=42,n=8,rpd=" + "0123456789abcdef" + "0" * 26)
+
+    binary = SerialIngest("/dev/null", binary=True)
+    frames = FrameDecoder().feed(
+        encode_frame(FRAME_TYPE_RPD, 0, RPD_FRAME.pack(76, 500, 62))
+        + encode_frame(FRAME_TYPE_SURVEY, 0,
+                       SURVEY_FRAME.pack(42, 8, bytes([0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE]))))
+    for frame in frames:
+        binary.handle_frame(frame)
+
+    assert text.telemetry['rpd'] == binary.telemetry['rpd'] == {
+        'channel': 76, 'samples': 500, 'busy_permille': 124}
+    survey = binary.telemetry['survey']
+    assert survey == text.telemetry['survey']
+    assert survey['hits'][42:58] == list(range(16))
+    assert survey['hits'][0] is None and survey['hits'][58] == 0
+
+
+def test_binary_health_matches_text():
+    """二進位 HEALTH 封包與 #health 行解析結果相同"""
+    text = SerialIngest("/dev/null")
+    text.parse_line("#health,status=4,epoch=2,up=1500000,retx=37,txfail=4,reinit=1,"
+                    "i2c1=0,i2c2=12,overrun=3,busrec=1")
+
+    binary = SerialIngest("/dev/null", binary=True)
+    payload = HEALTH_PACKET.pack(PACKET_TYPE_HEALTH, 4, 500, 2, 1500000, 37, 4, 1, 0, 12, 3, 1, 0)
+    assert binary.parse_payload(payload) is None
+
+    assert binary.telemetry['health'] == text.telemetry['health']
+
+
+class FakeBaseSerial:
+    """模擬 Base 的鮑率協商與指令回覆"""
+
+    def __init__(self, accept: bool = True, confirm: bool = True):
+        self.baudrate = 115200
+        self.accept = accept
+        self.confirm = confirm
+        self.binary = False
+        self.replay: dict[int, bytes] = {}   # seq → 已轉送的 CSV 行（重送緩衝）
+        self._rx = b''
+
+    @property
+    def in_waiting(self) -> int:
+        return len(self._rx)
+
+    def read(self, n: int = 1) -> bytes:
+        data, self._rx = self._rx[:n], self._rx[n:]
+        return data
+
+    def readline(self) -> bytes:
+        line, sep, self._rx = self._rx.partition(b'\n')
+        return line + sep
+
+    def reply(self, op: bytes, ok: bool):
+        if self.binary:
+            code = FRAME_EVENT_CMD_OK if ok else FRAME_EVENT_CMD_ERR
+            self._rx += encode_frame(FRAME_TYPE_EVENT, 0, bytes((code, op[0])))
+        else:
+            self._rx += (b'#ok,' if ok else b'#err,') + op + b'\r\n'
+
+    def write(self, data: bytes):
+        if data.startswith(b'!B') and self.accept:
+            self._rx += b'1,10,0,1,2,3,4,5,6,7,8,9,10,11,12,3\r\n#baud=' + data[2:-1] + b'\r\n'
+        elif data == b'!K\n' and self.confirm:
+            self._rx += b'#baud-ok=' + str(self.baudrate).encode() + b'\r\n'
+        elif data.startswith(b'!M'):
+            self.reply(b'M', True)
+            self.binary = data[2:3] == b'1'
+        elif data.startswith(b'!I'):
+            interval, _, fmt = data[2:-1].partition(b',')
+            self.reply(b'I', 100 <= int(interval) <= 60000 and fmt in (b'', b'0', b'1'))
+        elif data.startswith(b'!R'):
+            self.reply(b'R', data[2:3] == b'1')
+        elif data.startswith(b'!D'):
+            self.reply(b'D', data[2:3] in (b'0', b'1', b'2'))
+        elif data.startswith(b'!P'):
+            _, seq, count = map(int, data[2:-1].split(b','))
+            lines = [self.replay[s] for s in range(seq, seq + count) if s in self.replay]
+            self._rx += b''.join(lines)
+            self.reply(b'P', bool(lines))
+
+    def reset_input_buffer(self):
+        self._rx = b''
+
+
+def test_negotiate_baud():
+    """!B → #baud= → 切換 → !K → #baud-ok="""
+    ingest = SerialIngest("/dev/null")
+    ingest.serial = FakeBaseSerial()
+
+    assert ingest.negotiate_baud(1000000)
+    assert ingest.serial.baudrate == 1000000
+    assert ingest.baud == 1000000
+
+
+def test_commands():
+    """指令回覆 #ok / #err；切換輸出模式後改以 EVENT 框架回覆"""
+    ingest = SerialIngest("/dev/null")
+    ingest.serial = FakeBaseSerial()
+
+    assert ingest.set_output_mode(True) is True
+    assert ingest.binary
+    assert ingest.set_stats_interval(1000) is True
+    assert ingest.set_stats_interval(50) is False
+    assert ingest.set_stats_interval(1000, text=True) is True
+    assert ingest.send_remote_command(1, REMOTE_CMD_SAVE) is True
+    assert ingest.send_remote_command(3, REMOTE_CMD_CHANNEL, 80) is False
+    assert ingest.send_command('S', timeout=0.05) is None  # 無回覆 → 逾時
+
+
+def test_resend_and_reorder():
+    """序號缺口 → !P 要求重送 → 重送的樣本依序號排回原位"""
+    ingest = SerialIngest("/dev/null", reorder_depth=REPLAY_DEPTH)
+    base = ingest.serial = FakeBaseSerial()
+    lines = {seq: f"{seq},{seq * 10},0,1,2,3,4,5,6,7,8,9,10,11,12,3,1\r\n".encode()
+             for seq in range(1, 8)}
+    base.replay = {seq: lines[seq] for seq in (3, 4)}   # 5 已被覆蓋
+
+    received = []
+    for seq in (1, 2, 6, 7):
+        ingest._deliver(ingest.parse_line(lines[seq].decode().strip()), received.append)
+        while base.in_waiting:   # 讀取線程讀到重送的樣本與回覆
+            sample = ingest.parse_line(base.readline().decode().strip())
+            if sample:
+                ingest._deliver(sample, received.append)
+
+    assert [s.seq for s in received] == [1, 2, 3, 4]
+    for seq in range(8, 8 + REPLAY_DEPTH):
+        ingest._deliver(ingest.parse_line(lines[1].decode().replace('1,10,', f'{seq},0,', 1).strip()),
+                        received.append)
+    assert [s.seq for s in received][:7] == [1, 2, 3, 4, 6, 7, 8]
+    assert ingest.reorder == {'reordered': 2, 'skipped': 1, 'late': 0}
+    assert ingest.stats['dropped'] == 1
+    assert ingest.request_resend(1, 5) is False
+
+
+def test_negotiate_baud_fallback():
+    """新鮑率未確認時退回原鮑率"""
+    ingest = SerialIngest("/dev/null")
+    ingest.serial = FakeBaseSerial(confirm=False)
+
+    assert not ingest.negotiate_baud(2000000)
+    assert ingest.serial.baudrate == 115200
+    assert not ingest.negotiate_baud(9600)
+
+
+def test_telemetry_snapshot_while_reading():
+    """讀取線程不斷新增管道時，API 線程取 stats / telemetry 快照不會因字典變動而失敗"""
+    ingest = SerialIngest("/dev/null")
+    done = []
+
+    def reader():
+        for i in range(20000):
+            pipe = i % 5000   # 實際只有 0-5；鍵越多，快照期間插入新鍵的機會越大
+            ingest.handle_frame(Frame(FRAME_TYPE_STATS, 0, STATS_FRAME.pack(i, 1, 985, 0, 0), pipe))
+        done.append(True)
+
+    thread = Thread(target=reader)
+    thread.start()
+    while not done:
+        ingest.stats
+        ingest.telemetry
+    thread.join()
+    assert len(ingest.telemetry['remotes']) == 5000
@@ -0,0 +1,91 @@
+#include "baud.h"
+#include "uart.h"
+
+const uint32_t BAUD_RATES[BAUD_RATE_COUNT] = { BAUD_DEFAULT, 500000UL, 1000000UL, 2000000UL };
+
+// 協商狀態
+#define BAUD_STATE_IDLE       0  // 使用 current
+#define BAUD_STATE_SWITCH     1  // 等待回覆送完後切換到 pending
+#define BAUD_STATE_PROBATION  2  // 已切換，等待主機確認
+
+static uint8_t state = BAUD_STATE_IDLE;
+static uint32_t current = BAUD_DEFAULT;
+static uint32_t pending = BAUD_DEFAULT;
+static uint32_t state_start_ms = 0;
+
+// framing error 監控
+static uint32_t fe_window_start = 0;
+static uint16_t fe_window_base = 0;
+
+uint8_t baud_rate_index(uint32_t rate) {
+    for (uint8_t i = 0; i < BAUD_RATE_COUNT; i++) {
+        if (BAUD_RATES[i] == rate) return i;
+    }
+    return 0xFF;
+}
+
+bool baud_request(uint32_t rate) {
+    if (baud_rate_index(rate) == 0xFF) return false;
+    pending = rate;
+    state = BAUD_STATE_SWITCH;
+    return true;
+}
+
+static void fe_window_reset(uint32_t now_ms) {
+    fe_window_start = now_ms;
+    fe_window_base = uart_rx_frame_errors();
+}
+
+bool baud_confirm(uint32_t now_ms) {
+    if (state != BAUD_STATE_PROBATION) return false;
+    current = pending;
+    state = BAUD_STATE_IDLE;
+    fe_window_reset(now_ms);
+    return true;
+}
+
+static uint8_t fallback(uint32_t now_ms) {
+    uart_set_baud(BAUD_DEFAULT);
+    current = BAUD_DEFAULT;
+    pending = BAUD_DEFAULT;
+    state = BAUD_STATE_IDLE;
+    fe_window_reset(now_ms);
+    return BAUD_EVENT_FALLBACK;
+}
+
+uint8_t baud_service(uint32_t now_ms) {
+    switch (state) {
+    case BAUD_STATE_SWITCH:
+        // 回覆以舊鮑率完整送出後才切換
+        if (uart_tx_idle()) {
+            uart_set_baud(pending);
+            state = BAUD_STATE_PROBATION;
+            state_start_ms = now_ms;
+            fe_window_reset(now_ms);
+        }
+        break;
+
+    case BAUD_STATE_PROBATION:
+        if (now_ms - state_start_ms >= BAUD_CONFIRM_MS) return fallback(now_ms);
+        break;
+
+    default:
+        if (current == BAUD_DEFAULT) break;
+        // 高鮑率下 framing error 過多：線路或轉接晶片撐不住，退回預設
+        if (now_ms - fe_window_start >= BAUD_FE_WINDOW_MS) {
+            uint16_t errors = uart_rx_frame_errors() - fe_window_base;
+            if (errors >= BAUD_FE_LIMIT) return fallback(now_ms);
+            fe_window_reset(now_ms);
+        }
+        break;
+    }
+    return BAUD_EVENT_NONE;
+}
+
+uint32_t baud_current(void) {
+    return (state == BAUD_STATE_IDLE) ? current : pending;
+}
+
+bool baud_switching(void) {
+    return state == BAUD_STATE_SWITCH;
+}
@@ -0,0 +1,51 @@
+#ifndef BAUD_H
+#define BAUD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 鮑率協商
+//
+//   1. Base 以 BAUD_DEFAULT 開機
+//   2. 主機送 "!B<rate>"；Base 接受時以舊鮑率回覆 #baud=<rate>，送完後切換
+//   3. 主機切換後送 "!K"；Base 回覆 #baud-ok=<rate>，協商完成
+//   4. BAUD_CONFIRM_MS 內未收到 !K，或使用中 framing error 過多 → 退回 BAUD_DEFAULT 並回覆 #baud=<BAUD_DEFAULT>
+//
+// ATmega328P @ 16 MHz 倍速模式下 500k / 1M / 2M 無鮑率誤差。
+
+#define BAUD_DEFAULT        115200
+#define BAUD_RATE_COUNT     4
+#define BAUD_CONFIRM_MS     1000   // 切換後等待 !K 的時間
+#define BAUD_FE_WINDOW_MS   1000   // framing error 統計區間
+#define BAUD_FE_LIMIT       4      // 區間內 framing error 達此數即退回預設鮑率
+
+// baud_service() 回傳值
+#define BAUD_EVENT_NONE      0
+#define BAUD_EVENT_FALLBACK  1   // 已退回 BAUD_DEFAULT，呼叫端應回報
+
+// 支援的鮑率（索引即二進位模式事件參數）
+extern const uint32_t BAUD_RATES[BAUD_RATE_COUNT];
+
+// 鮑率 → 索引
+// 回傳: 0xFF = 不支援
+uint8_t baud_rate_index(uint32_t rate);
+
+// 主機請求切換（呼叫端先回覆 #baud=<rate>，切換在回覆送完後由 baud_service() 執行）
+// 回傳: false = 不支援的鮑率
+bool baud_request(uint32_t rate);
+
+// 主機確認新鮑率
+// 回傳: true = 協商完成
+bool baud_confirm(uint32_t now_ms);
+
+// 每次 loop 呼叫
+// 回傳: BAUD_EVENT_*
+uint8_t baud_service(uint32_t now_ms);
+
+// 目前鮑率（協商中為新鮑率）
+uint32_t baud_current(void);
+
+// 是否正等待回覆送完以切換鮑率（期間呼叫端暫停輸出，讓傳送緩衝能清空）
+bool baud_switching(void);
+
+#endif
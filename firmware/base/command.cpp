@@ -0,0 +1,77 @@
+#include "command.h"
+#include "uart.h"
+
+static char line[COMMAND_LINE_MAX + 1];
+static uint8_t line_len = 0;
+static bool in_command = false;   // 目前這行以 ! 開頭
+static bool overflow = false;     // 目前這行過長，丟棄
+
+bool command_poll(Command* cmd) {
+    int16_t c;
+    while ((c = uart_read()) >= 0) {
+        if (c == '\r') continue;
+
+        if (c == '\n') {
+            bool ok = in_command && !overflow && line_len > 0;
+            line[line_len] = '\0';
+            line_len = 0;
+            in_command = false;
+            overflow = false;
+            if (!ok) continue;
+
+            cmd->op = line[0];
+            uint8_t i = 0;
+            for (const char* p = &line[1]; *p; p++) cmd->args[i++] = *p;
+            cmd->args[i] = '\0';
+            return true;
+        }
+
+        if (!in_command && line_len == 0 && !overflow) {
+            // 行首必須是 !
+            if (c == '!') {
+                in_command = true;
+            } else {
+                overflow = true;  // 非指令行，丟棄到行尾
+            }
+            continue;
+        }
+
+        if (line_len < COMMAND_LINE_MAX) {
+            line[line_len++] = (char)c;
+        } else {
+            overflow = true;
+        }
+    }
+    return false;
+}
+
+bool command_parse_u32(const char* s, uint32_t* value) {
+    if (*s == '\0') return false;
+
+    uint32_t v = 0;
+    for (; *s; s++) {
+        if (*s < '0' || *s > '9') return false;
+        v = v * 10 + (uint32_t)(*s - '0');
+    }
+    *value = v;
+    return true;
+}
+
+uint8_t command_parse_list(const char* s, uint32_t* values, uint8_t max) {
+    uint8_t n = 0;
+    uint32_t v = 0;
+    bool digit = false;
+    for (;; s++) {
+        if (*s >= '0' && *s <= '9') {
+            v = v * 10 + (uint32_t)(*s - '0');
+            digit = true;
+        } else if ((*s == ',' || *s == '\0') && digit && n < max) {
+            values[n++] = v;
+            if (*s == '\0') return n;
+            v = 0;
+            digit = false;
+        } else {
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 主機 → Base 指令
+//
+// 格式: !<op><args>\n（\r 忽略），例如 "!B1000000\n"
+// 不以 ! 開頭或超過 COMMAND_LINE_MAX 的行整行丟棄。
+// B / K 以 #baud 行回覆；其餘指令執行後回覆 #ok,<op> 或 #err,<op>
+// （二進位模式為 FRAME_EVENT_CMD_OK / FRAME_EVENT_CMD_ERR 事件框架，arg = 指令碼）
+
+#define COMMAND_LINE_MAX  32   // 指令行上限（不含 ! 與換行）
+
+// 指令碼
+#define COMMAND_BAUD     'B'   // !B<rate>   請求切換鮑率
+#define COMMAND_CONFIRM  'K'   // !K         確認新鮑率可用
+#define COMMAND_SURVEY   'V'   // !V         開始頻譜掃描（約 4 秒，結果以 #survey 行回報）
+#define COMMAND_MODE     'M'   // !M<0-2>    輸出模式 0=CSV 1=二進位 2=十六進位（以原模式回覆後切換）
+#define COMMAND_INTERVAL 'I'   // !I<ms>[,<fmt>]  統計輸出間隔 (COMMAND_INTERVAL_MIN ~ MAX)；fmt 0=#f 框架行 1=文字行
+#define COMMAND_SNAPSHOT 'S'   // !S         立即輸出一次統計
+#define COMMAND_CHANNEL  'C'   // !C<ch>     切換頻道 0-125（先通知所有遠距端，再切換 Base）
+#define COMMAND_REMOTE   'R'   // !R<pipe><op>[arg]  轉送遠距端指令，例如 !R1W（見 common/remote_command.h）
+#define COMMAND_DECIMATE 'D'   // !D<mode>[,<n>]  降頻輸出 0=每筆 1=n 筆平均 2=n 筆包絡（見 decimate.h）
+#define COMMAND_RESEND   'P'   // !P<pipe>,<seq>[,<count>]  重送最近轉送過的感測封包（見 replay.h）
+
+#define COMMAND_INTERVAL_MIN  100
+#define COMMAND_INTERVAL_MAX  60000
+
+typedef struct {
+    char op;                        // 指令碼
+    char args[COMMAND_LINE_MAX];    // 參數（\0 結尾）
+} Command;
+
+// 讀取接收緩衝並組行（每次 loop 呼叫，不阻塞）
+// 回傳: true = cmd 內有一筆完整指令
+bool command_poll(Command* cmd);
+
+// 解析十進位無號整數參數
+// 回傳: false = 空字串或含非數字字元
+bool command_parse_u32(const char* s, uint32_t* value);
+
+// 解析以逗號分隔的十進位無號整數（例如 "1,1234,4"）
+// 回傳: 數值個數；0 = 格式錯誤或超過 max 個
+uint8_t command_parse_list(const char* s, uint32_t* values, uint8_t max);
+
+#endif
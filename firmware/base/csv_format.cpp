@@ -0,0 +1,210 @@
+#include "csv_format.h"
+#include "uart.h"
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define pow10_read32(p) pgm_read_dword(p)
+#define pow10_read16(p) pgm_read_word(p)
+#define text_read(p)    ((char)pgm_read_byte(p))
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define pow10_read32(p) (*(p))
+#define pow10_read16(p) (*(p))
+#define text_read(p)    (*(p))
+#endif
+
+static const uint32_t POW10_32[9] PROGMEM = {
+    1000000000UL, 100000000UL, 10000000UL, 1000000UL,
+    100000UL, 10000UL, 1000UL, 100UL, 10UL
+};
+
+static const uint16_t POW10_16[4] PROGMEM = { 10000, 1000, 100, 10 };
+
+static const char HEX_DIGITS[16] PROGMEM = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+uint8_t fmt_u16(char* dst, uint16_t value) {
+    char* p = dst;
+    bool started = false;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        uint16_t pow = pow10_read16(&POW10_16[i]);
+        char digit = '0';
+        while (value >= pow) {
+            value -= pow;
+            digit++;
+        }
+        if (started || digit != '0') {
+            *p++ = digit;
+            started = true;
+        }
+    }
+    *p++ = (char)('0' + value);
+    return (uint8_t)(p - dst);
+}
+
+uint8_t fmt_u32(char* dst, uint32_t value) {
+    // 16-bit 範圍內改走較快的 16-bit 路徑
+    if (value <= 0xFFFFUL) return fmt_u16(dst, (uint16_t)value);
+
+    char* p = dst;
+    bool started = false;
+
+    for (uint8_t i = 0; i < 9; i++) {
+        uint32_t pow = pow10_read32(&POW10_32[i]);
+        char digit = '0';
+        while (value >= pow) {
+            value -= pow;
+            digit++;
+        }
+        if (started || digit != '0') {
+            *p++ = digit;
+            started = true;
+        }
+    }
+    *p++ = (char)('0' + value);
+    return (uint8_t)(p - dst);
+}
+
+uint8_t fmt_i16(char* dst, int16_t value) {
+    if (value < 0) {
+        dst[0] = '-';
+        // -32768 取負在 uint16 中仍正確
+        return (uint8_t)(1 + fmt_u16(dst + 1, (uint16_t)(0U - (uint16_t)value)));
+    }
+    return fmt_u16(dst, (uint16_t)value);
+}
+
+uint8_t csv_format_sensor(char* buf, const SensorPacket* p, uint8_t pipe, uint32_t t_base_us) {
+    char* out = buf;
+
+    out += fmt_u16(out, p->seq);
+    *out++ = ',';
+    out += fmt_u32(out, p->timestamp);
+    *out++ = ',';
+    *out++ = (p->flags & PACKET_FLAG_BUTTON) ? '1' : '0';
+
+    // MPU1 / MPU2 欄位在封包中連續排列（Bytes 8-31，packed 結構以 memcpy 取值）
+    const uint8_t* axes = (const uint8_t*)p + 8;
+    for (uint8_t i = 0; i < 12; i++) {
+        int16_t v;
+        memcpy(&v, axes + i * 2, sizeof(v));
+        *out++ = ',';
+        out += fmt_i16(out, v);
+    }
+
+    *out++ = ',';
+    *out++ = (char)('0' + (p->flags >> 6));
+    *out++ = ',';
+    *out++ = (char)('0' + pipe);
+    *out++ = ',';
+    out += fmt_u32(out, t_base_us);
+    *out++ = '\r';
+    *out++ = '\n';
+    return (uint8_t)(out - buf);
+}
+
+void fmt_hex16(char* dst, uint16_t value) {
+    uint8_t hi = (uint8_t)(value >> 8);
+    uint8_t lo = (uint8_t)value;
+    dst[0] = text_read(&HEX_DIGITS[hi >> 4]);
+    dst[1] = text_read(&HEX_DIGITS[hi & 0x0F]);
+    dst[2] = text_read(&HEX_DIGITS[lo >> 4]);
+    dst[3] = text_read(&HEX_DIGITS[lo & 0x0F]);
+}
+
+void fmt_hex32(char* dst, uint32_t value) {
+    fmt_hex16(dst, (uint16_t)(value >> 16));
+    fmt_hex16(dst + 4, (uint16_t)value);
+}
+
+uint8_t csv_format_sensor_hex(char* buf, const SensorPacket* p, uint8_t pipe, uint32_t t_base_us) {
+    char* out = buf;
+
+    *out++ = '$';
+    fmt_hex16(out, p->seq);
+    out += 4;
+    *out++ = ',';
+    fmt_hex32(out, p->timestamp);
+    out += 8;
+    *out++ = ',';
+    *out++ = text_read(&HEX_DIGITS[p->flags >> 4]);
+    *out++ = text_read(&HEX_DIGITS[p->flags & 0x0F]);
+
+    const uint8_t* axes = (const uint8_t*)p + 8;
+    for (uint8_t i = 0; i < 12; i++) {
+        uint16_t v;
+        memcpy(&v, axes + i * 2, sizeof(v));
+        *out++ = ',';
+        fmt_hex16(out, v);
+        out += 4;
+    }
+
+    *out++ = ',';
+    *out++ = text_read(&HEX_DIGITS[pipe >> 4]);
+    *out++ = text_read(&HEX_DIGITS[pipe & 0x0F]);
+    *out++ = ',';
+    fmt_hex32(out, t_base_us);
+    out += 8;
+    *out++ = '\r';
+    *out++ = '\n';
+    return (uint8_t)(out - buf);
+}
+
+// 保留 \r\n 的空間
+#define LINE_BODY_MAX (CSV_LINE_MAX - 2)
+
+void line_init(TextLine* line) {
+    line->len = 0;
+}
+
+void line_put_char(TextLine* line, char c) {
+    if (line->len < LINE_BODY_MAX) line->buf[line->len++] = c;
+}
+
+void line_put_P(TextLine* line, const char* pstr) {
+    char c;
+    while ((c = text_read(pstr++)) != 0 && line->len < LINE_BODY_MAX) {
+        line->buf[line->len++] = c;
+    }
+}
+
+void line_put_u32(TextLine* line, uint32_t value) {
+    char digits[10];
+    uint8_t n = fmt_u32(digits, value);
+    for (uint8_t i = 0; i < n; i++) line_put_char(line, digits[i]);
+}
+
+void line_put_i32(TextLine* line, int32_t value) {
+    if (value < 0) {
+        line_put_char(line, '-');
+        line_put_u32(line, 0UL - (uint32_t)value);
+    } else {
+        line_put_u32(line, (uint32_t)value);
+    }
+}
+
+void line_put_x10(TextLine* line, uint32_t value_x10) {
+    // 定點數的整數部分需要一次除法，狀態行頻率低可接受
+    line_put_u32(line, value_x10 / 10);
+    line_put_char(line, '.');
+    line_put_char(line, (char)('0' + value_x10 % 10));
+}
+
+void line_put_hex(TextLine* line, const void* data, uint8_t len) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (uint8_t i = 0; i < len; i++) {
+        line_put_char(line, text_read(&HEX_DIGITS[bytes[i] >> 4]));
+        line_put_char(line, text_read(&HEX_DIGITS[bytes[i] & 0x0F]));
+    }
+}
+
+bool line_send(TextLine* line) {
+    line->buf[line->len++] = '\r';
+    line->buf[line->len++] = '\n';
+    return uart_write_record((const uint8_t*)line->buf, line->len);
+}
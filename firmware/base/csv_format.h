@@ -0,0 +1,87 @@
+#ifndef CSV_FORMAT_H
+#define CSV_FORMAT_H
+
+#include <stdint.h>
+#include "../common/packet.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>   // line_put_str() 展開為 PSTR()，引用端不一定有 Arduino.h
+#elif !defined(PSTR)
+#define PSTR(s) (s)
+#endif
+
+// CSV 行格式化（取代逐欄 Serial.print）
+//
+// 整行先組進一個緩衝區再一次寫出；數字轉換以「減去 10 的冪次」逐位求值，
+// 不使用除法（ATmega328P 沒有硬體除法，Print::printNumber 每位數要一次 32-bit 除法）。
+// 輸出與原本的 Serial.print / println 序列逐位元組相同（含結尾 \r\n），
+// 由主機端測試 csv_legacy 對照 Print::printNumber 逐位元組比對，耗時比較見 tests/bench_csv.cpp。
+
+// 最長 CSV 行：5 + 10 + 1 + 12×6 + 1 + 1 + 10 位數，17 個逗號，\r\n（= UART_RECORD_MAX）
+#define CSV_LINE_MAX 120
+
+// 無號整數轉十進位字串（不含結尾 \0）
+// 回傳: 寫入的字元數
+uint8_t fmt_u16(char* dst, uint16_t value);
+uint8_t fmt_u32(char* dst, uint32_t value);
+
+// 有號 16-bit 整數轉十進位字串（負數帶 '-'）
+uint8_t fmt_i16(char* dst, int16_t value);
+
+// 格式化一筆感測資料為 CSV 行（含 \r\n，不含 \0）
+// 格式: seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2,valid,pipe,t_base_us
+// pipe: 接收管道（遠距端編號 0-5）
+// t_base_us: 封包到達時間（Base micros()，IRQ 中斷進入時）
+// buf 長度至少 CSV_LINE_MAX
+// 回傳: 行長度
+uint8_t csv_format_sensor(char* buf, const SensorPacket* p, uint8_t pipe, uint32_t t_base_us);
+
+// ========== 固定寬度十六進位行 ==========
+// $ssss,tttttttt,ff,xxxx×12,pp,bbbbbbbb\r\n，每行固定 HEX_LINE_LEN 字元
+//   ssss = seq、tttttttt = t_remote_ms、ff = flags 原值（bit0 btn、bit6-7 valid）、
+//   xxxx = ax1 ... gz2（int16 二補數）、pp = pipe、bbbbbbbb = t_base_us
+// 每個欄位位置固定，主機端不必逐字元掃描逗號；每個 nibble 一次查表，不需除法。
+// 十六進位小寫；去掉 $ 與逗號後恰為 36 bytes（big-endian）。
+
+#define HEX_LINE_LEN      91
+#define HEX_OFFSET_SEQ    1
+#define HEX_OFFSET_TIME   6
+#define HEX_OFFSET_FLAGS  15
+#define HEX_OFFSET_AXES   18    // 第 i 軸位於 HEX_OFFSET_AXES + 5 × i
+#define HEX_OFFSET_PIPE   78
+#define HEX_OFFSET_TBASE  81
+
+// 無號整數轉固定寬度十六進位（4 / 8 字元）
+void fmt_hex16(char* dst, uint16_t value);
+void fmt_hex32(char* dst, uint32_t value);
+
+// 格式化一筆感測資料為十六進位行（含 \r\n，不含 \0）
+// buf 長度至少 HEX_LINE_LEN
+// 回傳: HEX_LINE_LEN
+uint8_t csv_format_sensor_hex(char* buf, const SensorPacket* p, uint8_t pipe, uint32_t t_base_us);
+
+// ========== 狀態行組裝 ==========
+// # 狀態行同樣先組進緩衝區，再以一筆記錄寫出（uart_write_record）
+// 超過 CSV_LINE_MAX 的內容截斷
+
+typedef struct {
+    char    buf[CSV_LINE_MAX];
+    uint8_t len;
+} TextLine;
+
+void line_init(TextLine* line);
+void line_put_char(TextLine* line, char c);
+void line_put_P(TextLine* line, const char* pstr);      // PROGMEM 字串
+void line_put_u32(TextLine* line, uint32_t value);
+void line_put_i32(TextLine* line, int32_t value);
+void line_put_x10(TextLine* line, uint32_t value_x10);  // 定點數，輸出一位小數（985 → "98.5"）
+void line_put_hex(TextLine* line, const void* data, uint8_t len);  // 逐位元組兩位十六進位（記憶體順序）
+
+// 加上 \r\n 並寫出
+// 回傳: false = 傳送緩衝區不足，整行被丟棄
+bool line_send(TextLine* line);
+
+// 字串常數放在 flash
+#define line_put_str(line, s) line_put_P((line), PSTR(s))
+
+#endif
@@ -0,0 +1,168 @@
+#include "decimate.h"
+#include "csv_format.h"
+#include "replay.h"
+#include <string.h>
+
+#define VALID_MASK (PACKET_FLAG_MPU1_VALID | PACKET_FLAG_MPU2_VALID)
+#define NO_SLOT    0xFF
+
+typedef struct {
+    int32_t sum[DECIMATE_AXES];
+    int16_t min[DECIMATE_AXES];
+    int16_t max[DECIMATE_AXES];
+    uint8_t count;
+    uint8_t flags;   // btn OR、valid AND
+} Window;
+
+// 視窗借用重送緩衝的記憶體（降頻期間不重送），DECIMATE_MODE_ALL 時為 NULL
+static_assert(sizeof(Window) * DECIMATE_SLOTS <= REPLAY_STORAGE_SIZE, "decimate windows exceed replay storage");
+static_assert(alignof(Window) <= REPLAY_STORAGE_ALIGN, "decimate windows need stricter alignment than replay storage");
+static Window* windows = 0;
+static uint8_t slot_of[RF_PIPE_COUNT];
+static uint8_t slots_used = 0;
+static uint8_t mode = DECIMATE_MODE_ALL;
+static uint8_t window_len = 1;
+
+// mean = sum / n 改為 ((sum >> shift) × recip) >> 15
+// shift = ceil(log2 n) 讓 sum >> shift 落在 int16 範圍，recip = 2^(15+shift) / n < 2^16，
+// 乘積不超過 int32（AVR 上一次 32×16 乘法，比 32-bit 除法快約 10 倍）
+static uint8_t mean_shift = 0;
+static uint16_t mean_recip = 1U << 15;
+
+bool decimate_configure(uint8_t new_mode, uint8_t n) {
+    if (new_mode > DECIMATE_MODE_ENVELOPE) return false;
+    if (new_mode == DECIMATE_MODE_ALL) n = 1;
+    if (n < 1 || n > DECIMATE_WINDOW_MAX) return false;
+
+    mode = new_mode;
+    window_len = n;
+    mean_shift = 0;
+    while ((1U << mean_shift) < n) mean_shift++;
+    mean_recip = (uint16_t)(((1UL << (15 + mean_shift)) + n / 2) / n);
+
+    memset(slot_of, NO_SLOT, sizeof(slot_of));
+    slots_used = 0;
+    if (mode == DECIMATE_MODE_ALL) {
+        if (windows) replay_restore();
+        windows = 0;
+    } else if (!windows) {
+        windows = (Window*)replay_borrow();
+    }
+    return true;
+}
+
+uint8_t decimate_mode(void) {
+    return mode;
+}
+
+uint8_t decimate_window(void) {
+    return window_len;
+}
+
+static Window* window_of(uint8_t pipe) {
+    return (pipe < RF_PIPE_COUNT && slot_of[pipe] != NO_SLOT) ? &windows[slot_of[pipe]] : 0;
+}
+
+bool decimate_add(uint8_t pipe, const SensorPacket* p) {
+    if (mode == DECIMATE_MODE_ALL || pipe >= RF_PIPE_COUNT) return false;
+    if (slot_of[pipe] == NO_SLOT) {
+        if (slots_used >= DECIMATE_SLOTS) return false;
+        slot_of[pipe] = slots_used;
+        windows[slots_used++].count = 0;
+    }
+    Window* w = &windows[slot_of[pipe]];
+
+    int16_t v[DECIMATE_AXES];
+    memcpy(v, &p->mpu1_ax, sizeof(v));
+
+    if (w->count >= window_len) w->count = 0;   // 上一個視窗已輸出
+    if (w->count == 0) {
+        w->flags = p->flags;
+        for (uint8_t i = 0; i < DECIMATE_AXES; i++) {
+            w->sum[i] = v[i];
+            w->min[i] = v[i];
+            w->max[i] = v[i];
+        }
+    } else {
+        w->flags = (uint8_t)((w->flags & p->flags & VALID_MASK) |
+                             ((w->flags | p->flags) & PACKET_FLAG_BUTTON));
+        for (uint8_t i = 0; i < DECIMATE_AXES; i++) {
+            w->sum[i] += v[i];
+            if (v[i] < w->min[i]) w->min[i] = v[i];
+            if (v[i] > w->max[i]) w->max[i] = v[i];
+        }
+    }
+    return ++w->count == window_len;
+}
+
+static int16_t window_mean(int32_t sum) {
+    if (mean_shift > 0) sum = (sum + (1L << (mean_shift - 1))) >> mean_shift;
+    return (int16_t)((sum * (int32_t)mean_recip + (1L << 14)) >> 15);
+}
+
+// 無效 IMU 的軸輸出 0（與原始 CSV 相同）
+static bool axis_valid(const Window* w, uint8_t axis) {
+    return w->flags & (axis < DECIMATE_AXES / 2 ? PACKET_FLAG_MPU1_VALID : PACKET_FLAG_MPU2_VALID);
+}
+
+static int16_t window_stat(const Window* w, uint8_t stat, uint8_t axis) {
+    if (!axis_valid(w, axis)) return 0;
+    switch (stat) {
+    case ENVELOPE_MIN: return w->min[axis];
+    case ENVELOPE_MAX: return w->max[axis];
+    default:           return window_mean(w->sum[axis]);
+    }
+}
+
+void decimate_fill_average(uint8_t pipe, const SensorPacket* last, SensorPacket* out) {
+    const Window* w = window_of(pipe);
+    int16_t v[DECIMATE_AXES];
+    for (uint8_t i = 0; i < DECIMATE_AXES; i++) {
+        v[i] = w ? window_stat(w, ENVELOPE_MEAN, i) : 0;
+    }
+    out->version = PROTOCOL_VERSION;
+    out->seq = last->seq;
+    out->timestamp = last->timestamp;
+    out->flags = w ? w->flags : 0;
+    memcpy(&out->mpu1_ax, v, sizeof(v));
+}
+
+void decimate_fill_envelope(uint8_t pipe, uint8_t stat, uint16_t seq, EnvelopeFrame* frame) {
+    const Window* w = window_of(pipe);
+    frame->seq = seq;
+    frame->count = w ? w->count : 0;
+    frame->flags = (uint8_t)((w ? w->flags : 0) | (stat << ENVELOPE_FLAG_STAT_SHIFT));
+    for (uint8_t i = 0; i < DECIMATE_AXES; i++) {
+        frame->value[i] = w ? window_stat(w, stat, i) : 0;
+    }
+}
+
+void decimate_print_envelope(const EnvelopeFrame* frame, uint8_t pipe) {
+    // #env,pipe,seq,n,valid,btn,stat,ax1,...,gz2（最長約 108 字元）
+    uint8_t stat = (frame->flags >> ENVELOPE_FLAG_STAT_SHIFT) & 0x03;
+    TextLine line;
+    line_init(&line);
+    line_put_str(&line, "#env,");
+    line_put_u32(&line, pipe);
+    line_put_char(&line, ',');
+    line_put_u32(&line, frame->seq);
+    line_put_char(&line, ',');
+    line_put_u32(&line, frame->count);
+    line_put_char(&line, ',');
+    line_put_u32(&line, frame->flags >> 6);
+    line_put_char(&line, ',');
+    line_put_u32(&line, frame->flags & PACKET_FLAG_BUTTON);
+    line_put_char(&line, ',');
+    if (stat == ENVELOPE_MIN) {
+        line_put_str(&line, "min");
+    } else if (stat == ENVELOPE_MAX) {
+        line_put_str(&line, "max");
+    } else {
+        line_put_str(&line, "mean");
+    }
+    for (uint8_t i = 0; i < DECIMATE_AXES; i++) {
+        line_put_char(&line, ',');
+        line_put_i32(&line, frame->value[i]);
+    }
+    line_send(&line);
+}
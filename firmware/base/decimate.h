@@ -0,0 +1,67 @@
+#ifndef DECIMATE_H
+#define DECIMATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../common/packet.h"
+#include "../common/rf_address.h"
+
+// 感測樣本降頻輸出（!D 指令，主機只需要即時概覽時使用）
+//
+// - DECIMATE_MODE_ALL：每筆輸出（預設）
+// - DECIMATE_MODE_AVERAGE：每 n 筆輸出一筆平均，格式與原始樣本相同
+//   （CSV 行 / RADIO 框架；seq、t_remote_ms、t_base_us 取視窗最後一筆）
+// - DECIMATE_MODE_ENVELOPE：每 n 筆輸出各軸 min / max / mean 三筆（#env 行 / ENVELOPE 框架）
+//
+// 視窗內 btn 取 OR、valid 取 AND（任一筆無效的 IMU 整個視窗輸出 0）。
+// 平均以定點倒數乘法計算（不做除法），誤差 ±1 LSB。
+// RAM：每個視窗約 98 bytes，只配置 DECIMATE_SLOTS 個，依收到順序分給遠距端；
+// 超過的遠距端在降頻模式下不輸出樣本（統計照常），!D 重新分配。
+// 視窗不另外配置，借用重送緩衝（replay.h）的記憶體：降頻期間 !P 無法重送，!D0 後恢復。
+
+#define DECIMATE_MODE_ALL       0
+#define DECIMATE_MODE_AVERAGE   1
+#define DECIMATE_MODE_ENVELOPE  2
+
+#define DECIMATE_WINDOW_MAX     100  // 視窗上限（筆），100Hz 下 1 秒
+#define DECIMATE_SLOTS          2    // 同時降頻的遠距端數（250kbps TDMA 容量）
+#define DECIMATE_AXES           12   // 兩顆 IMU × 6 軸
+
+// 包絡統計種類
+#define ENVELOPE_MIN    0
+#define ENVELOPE_MAX    1
+#define ENVELOPE_MEAN   2
+#define ENVELOPE_STATS  3
+
+// EnvelopeFrame.flags：沿用 SensorPacket.flags 的 btn / valid 位元，bit1-2 為統計種類
+#define ENVELOPE_FLAG_STAT_SHIFT  1
+
+// 二進位包絡框架內容 (FRAME_TYPE_ENVELOPE，每個視窗 ENVELOPE_STATS 筆)
+typedef struct __attribute__((packed)) {
+    uint16_t seq;                      // 視窗最後一筆序號
+    uint8_t  count;                    // 視窗筆數
+    uint8_t  flags;                    // PACKET_FLAG_* | stat << ENVELOPE_FLAG_STAT_SHIFT
+    int16_t  value[DECIMATE_AXES];     // ax1 ay1 az1 gx1 gy1 gz1 ax2 ... gz2
+} EnvelopeFrame;
+
+// 設定模式與視窗筆數（DECIMATE_MODE_ALL 忽略 n），清除所有視窗
+// 回傳: false = 參數超出範圍（設定不變）
+bool decimate_configure(uint8_t mode, uint8_t n);
+
+uint8_t decimate_mode(void);
+uint8_t decimate_window(void);
+
+// 加入一筆感測樣本
+// 回傳: true = 視窗已滿，呼叫端接著以 decimate_fill_* 取出結果
+bool decimate_add(uint8_t pipe, const SensorPacket* p);
+
+// 取出平均樣本（last = 視窗最後一筆，提供 seq / timestamp）
+void decimate_fill_average(uint8_t pipe, const SensorPacket* last, SensorPacket* out);
+
+// 取出包絡統計
+void decimate_fill_envelope(uint8_t pipe, uint8_t stat, uint16_t seq, EnvelopeFrame* frame);
+
+// 輸出到 Serial（#env 行）
+void decimate_print_envelope(const EnvelopeFrame* frame, uint8_t pipe);
+
+#endif
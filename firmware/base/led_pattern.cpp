@@ -0,0 +1,2 @@
+// 共用 LED 樣式表（見 common/led_pattern.cpp）
+#include "../common/led_pattern.cpp"
@@ -7,127 +7,654 @@
 #include "../common/packet.h"
 #include "rf_receiver.h"
 #include "stats.h"
+#include "serial_frame.h"
+#include "csv_format.h"
+#include "uart.h"
+#include "command.h"
+#include "baud.h"
+#include "tdma_base.h"
+#include "rf_survey.h"
+#include "decimate.h"
+#include "replay.h"
+#include "../common/fast_gpio.h"
+#include "../common/led_pattern.h"
 
 // 配置參數
-#define SERIAL_BAUD     115200
+#define SERIAL_BAUD     BAUD_DEFAULT  // 開機鮑率，主機可協商提高（見 baud.h）
 #define LED_PIN         3        // 狀態 LED
-#define STATS_INTERVAL  5000     // 統計輸出間隔 (ms)
+#define STATS_INTERVAL  5000     // 統計輸出間隔預設值 (ms)，主機可以 !I 調整
+#define CHANNEL_SWITCH_DELAY_MS 200  // !C：通知遠距端後等待多久再切換 Base（每個遠距端約 20 筆封包）
 #define NO_DATA_TIMEOUT 1000     // 無資料超時 (ms)
+#define RF_RETRY_INTERVAL 1000   // RF 初始化失敗時重試間隔 (ms)
+
+// 輸出模式
+#define OUTPUT_MODE_CSV     0    // CSV 文字行 + # 狀態行（見 SERIAL_FORMAT.md）
+#define OUTPUT_MODE_BINARY  1    // COBS 二進位框架（見 serial_frame.h）
+#define OUTPUT_MODE_HEX     2    // 固定寬度十六進位 $ 行 + # 狀態行（見 csv_format.h）
+#define OUTPUT_MODE         OUTPUT_MODE_CSV
+
+// 文字模式（CSV / 十六進位）的統計輸出格式；二進位模式一律送框架
+#define STATS_FORMAT_FRAME  0    // #f,<hex> 框架行（與二進位框架內容相同，主機端解析）
+#define STATS_FORMAT_TEXT   1    // #pps / #link / #base / #rpd key=value 文字行（除錯用）
+
+typedef FastGpio<LED_PIN> LedGpio;
+
+// RAM 預算（ATmega328P 共 2048 bytes）
+// 下列大型靜態緩衝合計上限；其餘約 900 bytes 給小型狀態變數、RF24 物件、Arduino core 與堆疊
+// （最深的路徑：loop → output_packet → print_csv_line 的 CSV_LINE_MAX 行緩衝，加上 UART / RF IRQ 中斷框架）。
+// 主機端建置的結構對齊只會更大，主機能通過表示 AVR 也在預算內。
+// 整個韌體另以 avr-size 檢查，見 CONFIG_PARAMS.md「RAM 預算」。
+#define BASE_RAM_BUFFER_BUDGET 1152
+static_assert(UART_TX_RING_SIZE + UART_RX_RING_SIZE
+              + RF_RX_RING_SIZE * sizeof(RfPacket)
+              + REPLAY_STORAGE_SIZE                        // 含降頻視窗（借用同一塊）
+              + RF_PIPE_COUNT * sizeof(Stats)
+              + STATS_HEALTH_SLOTS * sizeof(RemoteHealth)
+              <= BASE_RAM_BUFFER_BUDGET, "base static buffers exceed the Uno RAM budget");
 
 // 狀態變數
-static SensorPacket packet;
-static Stats stats;
+static RfPacket rx_packet;
+static Stats stats[RF_PIPE_COUNT];   // 每個接收管道（遠距端）一份
+static BaseStats base_stats;
 static unsigned long last_receive_time = 0;
 static unsigned long last_stats_time = 0;
+static unsigned long rf_retry_time = 0;
+static bool rf_ok = false;
+static LedPattern led;
+static uint8_t output_mode = OUTPUT_MODE;
+static uint16_t tx_skipped = 0;   // Serial 壅塞期間略過的樣本（UART_OVERFLOW_SUMMARY）
+static uint16_t stats_interval = STATS_INTERVAL;
+static uint8_t stats_format = STATS_FORMAT_FRAME;
+static bool channel_switch_pending = false;  // !C：等待遠距端收到指令
+static uint8_t channel_switch_to = 0;
+static unsigned long channel_switch_time = 0;
 
-// 輸出 CSV 資料行（每筆一行，100Hz）
-// 格式: seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2
-void print_csv_line(const SensorPacket* p) {
-    Serial.print(p->seq);
-    Serial.print(',');
-    Serial.print(p->timestamp);
-    Serial.print(',');
-    Serial.print(p->button);
-    Serial.print(',');
-    // MPU1
-    Serial.print(p->mpu1_ax);
-    Serial.print(',');
-    Serial.print(p->mpu1_ay);
-    Serial.print(',');
-    Serial.print(p->mpu1_az);
-    Serial.print(',');
-    Serial.print(p->mpu1_gx);
-    Serial.print(',');
-    Serial.print(p->mpu1_gy);
-    Serial.print(',');
-    Serial.print(p->mpu1_gz);
-    Serial.print(',');
-    // MPU2
-    Serial.print(p->mpu2_ax);
-    Serial.print(',');
-    Serial.print(p->mpu2_ay);
-    Serial.print(',');
-    Serial.print(p->mpu2_az);
-    Serial.print(',');
-    Serial.print(p->mpu2_gx);
-    Serial.print(',');
-    Serial.print(p->mpu2_gy);
-    Serial.print(',');
-    Serial.println(p->mpu2_gz);
+// 輸出 CSV 資料行（每個遠距端每筆一行，100Hz）
+// 格式: seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2,valid,pipe,t_base_us
+// valid: bit0=MPU1 有效, bit1=MPU2 有效（無效的 IMU 欄位為 0）
+// pipe: 接收管道（遠距端編號）
+// t_base_us: 封包到達時間（Base micros()，與二進位訊框標頭相同）
+// 整行先格式化到緩衝區再一次寫出（見 csv_format.h）
+// OUTPUT_MODE_HEX 改為固定寬度十六進位行，欄位順序相同（btn / valid 合為 flags）
+// 回傳: false = 傳送緩衝不足，整行丟棄
+bool print_csv_line(const SensorPacket* p, uint8_t pipe, uint32_t t_base_us) {
+    char line[CSV_LINE_MAX];
+    uint8_t len = (output_mode == OUTPUT_MODE_HEX)
+        ? csv_format_sensor_hex(line, p, pipe, t_base_us)
+        : csv_format_sensor(line, p, pipe, t_base_us);
+    return uart_write_record((const uint8_t*)line, len);
 }
 
-void setup() {
-    // 初始化 Serial
-    Serial.begin(SERIAL_BAUD);
-    // 狀態訊息以 # 開頭（解析器忽略）
-    Serial.println(F("#Mechtronic Base Station v2.0"));
+// 輸出階段耗時統計（以 # 開頭）
+// 格式: #prof,pipe=<n>,phase=<n>,n=<count>,min=<us>,max=<us>,win=<ms>,h=<b0>/<b1>/.../<b7>
+void print_profile_line(const ProfilePacket* p, uint8_t pipe) {
+    TextLine line;
+    line_init(&line);
+    line_put_str(&line, "#prof,pipe=");
+    line_put_u32(&line, pipe);
+    line_put_str(&line, ",phase=");
+    line_put_u32(&line, p->phase);
+    line_put_str(&line, ",n=");
+    line_put_u32(&line, p->count);
+    line_put_str(&line, ",min=");
+    line_put_u32(&line, p->min_us);
+    line_put_str(&line, ",max=");
+    line_put_u32(&line, p->max_us);
+    line_put_str(&line, ",win=");
+    line_put_u32(&line, p->window_ms);
+    line_put_str(&line, ",h=");
+    for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) {
+        if (i != 0) line_put_char(&line, '/');
+        line_put_u32(&line, p->buckets[i]);
+    }
+    line_send(&line);
+}
 
-    // 初始化 LED
-    pinMode(LED_PIN, OUTPUT);
-    digitalWrite(LED_PIN, HIGH);  // 開機指示
-
-    // 初始化 RF 接收器
-    if (!rf_receiver_init()) {
-        Serial.println(F("#[ERROR] RF init failed!"));
-        while (1) {
-            digitalWrite(LED_PIN, HIGH);
-            delay(100);
-            digitalWrite(LED_PIN, LOW);
-            delay(100);
+// 輸出固定狀態行（PROGMEM 字串）
+void print_status(const char* pstr) {
+    TextLine line;
+    line_init(&line);
+    line_put_P(&line, pstr);
+    line_send(&line);
+}
+
+// 輸出資料行標題（以 # 開頭，解析器可選擇解析或忽略；二進位模式不輸出）
+void print_header(void) {
+    if (output_mode == OUTPUT_MODE_CSV) {
+        print_status(PSTR("#seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2,valid,pipe,t_base_us"));
+    } else if (output_mode == OUTPUT_MODE_HEX) {
+        print_status(PSTR("#$seq,t_remote_ms,flags,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2,pipe,t_base_us"));
+    }
+}
+
+// 回報 RF 初始化結果
+void report_rf_state(bool ok) {
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        frame_send_event(ok ? FRAME_EVENT_RF_OK : FRAME_EVENT_RF_ERROR, 0);
+    } else if (ok) {
+        print_status(PSTR("#[OK] RF receiver ready"));
+    } else {
+        print_status(PSTR("#[ERROR] RF init failed!"));
+    }
+}
+
+// 回報 Serial 壅塞期間略過的樣本數
+void report_tx_skipped(void) {
+    bool sent;
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        frame_send_event(FRAME_EVENT_TX_SKIP, tx_skipped > 0xFF ? 0xFF : (uint8_t)tx_skipped);
+        sent = true;
+    } else {
+        TextLine line;
+        line_init(&line);
+        line_put_str(&line, "#[WARN] TX overflow, skipped=");
+        line_put_u32(&line, tx_skipped);
+        sent = line_send(&line);
+    }
+    if (sent) {
+        tx_skipped = 0;
+        uart_clear_congestion();
+    }
+}
+
+// 降頻模式：樣本先累積到視窗，滿 n 筆輸出一筆平均或一組包絡
+void output_decimated(const SensorPacket* p, uint8_t pipe, uint32_t t_arrival_us) {
+    if (!decimate_add(pipe, p)) return;
+
+    if (decimate_mode() == DECIMATE_MODE_AVERAGE) {
+        RadioPayload mean;
+        decimate_fill_average(pipe, p, &mean.sensor);
+        if (output_mode == OUTPUT_MODE_BINARY) {
+            frame_send(FRAME_TYPE_PIPE(FRAME_TYPE_RADIO, pipe), t_arrival_us, &mean, PACKET_SIZE);
+        } else {
+            print_csv_line(&mean.sensor, pipe, t_arrival_us);
         }
+        return;
     }
-    Serial.println(F("#[OK] RF receiver ready"));
+
+    for (uint8_t stat = 0; stat < ENVELOPE_STATS; stat++) {
+        EnvelopeFrame frame;
+        decimate_fill_envelope(pipe, stat, p->seq, &frame);
+        if (output_mode == OUTPUT_MODE_BINARY) {
+            frame_send(FRAME_TYPE_PIPE(FRAME_TYPE_ENVELOPE, pipe), t_arrival_us, &frame, sizeof(frame));
+        } else {
+            decimate_print_envelope(&frame, pipe);
+        }
+    }
+}
+
+// 輸出收到的封包
+// 二進位模式原樣轉送（主機端自行解碼感測 / 遙測封包）；CSV 模式依 Byte 0 轉為文字行
+// pipe: 接收管道（遠距端編號），隨資料一起輸出
+// 回傳: false = 未放入傳送緩衝（鮑率切換中、壅塞略過或緩衝不足而丟棄）
+bool output_packet(const RadioPayload* p, uint8_t pipe, uint32_t t_arrival_us) {
+    // 等待鮑率切換：暫停輸出讓傳送緩衝清空
+    if (baud_switching()) return false;
+
+#if UART_OVERFLOW_POLICY == UART_OVERFLOW_SUMMARY
+    // Serial 壅塞：略過樣本直到緩衝區消化一半，再以一筆摘要回報略過數量
+    if (uart_congested()) {
+        if (uart_tx_free() < UART_TX_RING_SIZE / 2) {
+            if (tx_skipped < 0xFFFF) tx_skipped++;
+            return false;
+        }
+        report_tx_skipped();
+    }
+#endif
+
+    if (p->sensor.version == PROTOCOL_VERSION && decimate_mode() != DECIMATE_MODE_ALL) {
+        output_decimated(&p->sensor, pipe, t_arrival_us);
+        return true;    // 已累積到視窗
+    }
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        return frame_send(FRAME_TYPE_PIPE(FRAME_TYPE_RADIO, pipe), t_arrival_us, p, PACKET_SIZE);
+    }
+    if (p->sensor.version == PROTOCOL_VERSION) {
+        return print_csv_line(&p->sensor, pipe, t_arrival_us);
+    }
+    if (p->raw[0] == PACKET_TYPE_PROFILE) {
+        print_profile_line(&p->profile, pipe);
+    } else if (p->raw[0] != PACKET_TYPE_HEALTH) {
+        TextLine line;
+        line_init(&line);
+        line_put_str(&line, "#[WARN] Bad version: ");
+        line_put_u32(&line, p->raw[0]);
+        line_send(&line);
+    }
+    return true;
+}
+
+// 回報鮑率協商結果
+// event: FRAME_EVENT_BAUD（#baud=）或 FRAME_EVENT_BAUD_OK（#baud-ok=）
+void report_baud(uint8_t event, uint32_t rate) {
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        frame_send_event(event, baud_rate_index(rate));
+        return;
+    }
+    TextLine line;
+    line_init(&line);
+    if (event == FRAME_EVENT_BAUD_OK) {
+        line_put_str(&line, "#baud-ok=");
+    } else {
+        line_put_str(&line, "#baud=");
+    }
+    line_put_u32(&line, rate);
+    line_send(&line);
+}
+
+// 送出一筆定期輸出的型別資料：二進位模式為框架，文字模式為 #f 行
+void send_record(uint8_t type, const void* payload, uint8_t len) {
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        frame_send(type, micros(), payload, len);
+    } else {
+        frame_print(type, micros(), payload, len);
+    }
+}
+
+// 統計與頻譜掃描結果分批輸出：一次產生的多筆記錄可能超過傳送緩衝 (UART_TX_RING_SIZE)，
+// 整批寫入會依 DROP_OLDEST 擠掉自己較早的幾筆，因此改為每筆在緩衝有 UART_RECORD_MAX 空間時才送出
+// 傳送持續飽和（樣本已塞滿緩衝）時空間不會釋出，每送完一筆記錄的時間仍強制送一筆，統計不會停擺
+#define OUTPUT_IDLE          0xFF
+#define STATS_STEPS_PER_PIPE 3                                      // #pps / #link / #health
+#define STATS_STEP_BASE      (RF_PIPE_COUNT * STATS_STEPS_PER_PIPE)
+#define STATS_STEP_RPD       (STATS_STEP_BASE + 1)
+
+static uint8_t stats_step = OUTPUT_IDLE;
+static uint8_t survey_step = OUTPUT_IDLE;
+static uint32_t last_batch_us = 0;
+
+// 輸出統計的其中一筆記錄（無資料的步驟不輸出）
+static void output_stats_step(uint8_t step) {
+    bool text = output_mode != OUTPUT_MODE_BINARY && stats_format == STATS_FORMAT_TEXT;
+    if (step < STATS_STEP_BASE) {
+        uint8_t pipe = step / STATS_STEPS_PER_PIPE;
+        if (!stats_active(&stats[pipe])) return;
+        switch (step % STATS_STEPS_PER_PIPE) {
+        case 0:
+            if (text) {
+                stats_print_pps(&stats[pipe], pipe);
+            } else {
+                StatsFrame frame;
+                stats_fill_frame(&stats[pipe], &frame);
+                send_record(FRAME_TYPE_PIPE(FRAME_TYPE_STATS, pipe), &frame, sizeof(frame));
+            }
+            break;
+        case 1:
+            if (text) {
+                stats_print_link(&stats[pipe], pipe);
+            } else {
+                LinkFrame link;
+                stats_fill_link_frame(&stats[pipe], &link);
+                send_record(FRAME_TYPE_PIPE(FRAME_TYPE_LINK, pipe), &link, sizeof(link));
+            }
+            break;
+        default:
+            // 二進位模式健康封包已原樣轉送；文字模式另外輸出 #health 行
+            if (output_mode != OUTPUT_MODE_BINARY) stats_print_health(&stats[pipe], pipe);
+            break;
+        }
+    } else if (step == STATS_STEP_BASE) {
+        if (text) {
+            stats_print_base(&base_stats);
+        } else {
+            BaseStatsFrame frame;
+            stats_fill_base_frame(&base_stats, &frame);
+            send_record(FRAME_TYPE_BASE_STATS, &frame, sizeof(frame));
+        }
+    } else {
+        RpdFrame rpd;
+        rf_survey_take_rpd(&rpd);
+        if (text) {
+            rf_survey_print_rpd(&rpd);
+        } else {
+            send_record(FRAME_TYPE_RPD, &rpd, sizeof(rpd));
+        }
+    }
+}
+
+// 輸出頻譜掃描結果的其中一段
+static void output_survey_step(uint8_t chunk) {
+    SurveyFrame frame;
+    rf_survey_fill_frame(chunk, &frame);
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        frame_send(FRAME_TYPE_SURVEY, micros(), &frame, sizeof(frame));
+    } else {
+        rf_survey_print(&frame);
+    }
+}
+
+// 輸出統計：收過資料的遠距端各一筆，再加 Base 端統計
+// 文字模式預設同樣輸出型別框架（#f 行），!I<ms>,1 改回 key=value 文字行
+// 先快照 Base 統計再排入分批輸出；上一批尚未送完則略過這次
+void output_stats(void) {
+    if (stats_step != OUTPUT_IDLE) return;
+    stats_update_base(&base_stats);
+    stats_step = 0;
+}
+
+// 輸出頻譜掃描結果（排入分批輸出）
+void output_survey(void) {
+    survey_step = 0;
+}
+
+// 分批輸出服務（每次 loop 呼叫）：緩衝有空間就繼續送下一筆，鮑率切換期間暫停
+void output_service(void) {
+    if (baud_switching()) return;
+    if (stats_step == OUTPUT_IDLE && survey_step == OUTPUT_IDLE) return;
+
+    // 送出一筆記錄所需時間（10 bit/byte）：超過仍等不到空間就強制送出
+    uint32_t record_us = (uint32_t)UART_RECORD_MAX * 10UL * 1000000UL / baud_current();
+    bool force = micros() - last_batch_us >= record_us;
+    while (force || uart_tx_free() >= UART_RECORD_MAX) {
+        force = false;
+        if (stats_step != OUTPUT_IDLE) {
+            output_stats_step(stats_step);
+            stats_step = stats_step < STATS_STEP_RPD ? stats_step + 1 : OUTPUT_IDLE;
+        } else if (survey_step != OUTPUT_IDLE) {
+            output_survey_step(survey_step);
+            survey_step = survey_step + 1 < SURVEY_CHUNKS ? survey_step + 1 : OUTPUT_IDLE;
+        } else {
+            break;
+        }
+        last_batch_us = micros();
+    }
+}
+
+// 回覆主機指令結果（#ok,<op> / #err,<op>）
+void report_command(char op, bool ok) {
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        frame_send_event(ok ? FRAME_EVENT_CMD_OK : FRAME_EVENT_CMD_ERR, (uint8_t)op);
+        return;
+    }
+    TextLine line;
+    line_init(&line);
+    if (ok) {
+        line_put_str(&line, "#ok,");
+    } else {
+        line_put_str(&line, "#err,");
+    }
+    line_put_char(&line, op);
+    line_send(&line);
+}
+
+// 切換頻道：先經 ACK payload 通知所有使用中的遠距端，CHANNEL_SWITCH_DELAY_MS 後再切換 Base
+// 只改 RAM，重新上電回到 RF_CHANNEL；遠距端斷線後會自行回退到 RF_CHANNEL（RF_CHANNEL_FALLBACK_MS）
+bool start_channel_switch(uint32_t channel, unsigned long now) {
+    if (channel > 125) return false;
+    channel_switch_to = (uint8_t)channel;
+    channel_switch_time = now;
+    channel_switch_pending = true;
+#if RF_TDMA
+    for (uint8_t pipe = 0; pipe < RF_PIPE_COUNT; pipe++) {
+        if (tdma_slot_of(pipe) != 0xFF) {
+            tdma_send_command(pipe, REMOTE_CMD_CHANNEL, (uint16_t)channel);
+        }
+    }
+#endif
+    return true;
+}
+
+// 轉送遠距端指令：!R<pipe><op>[arg]
+bool forward_remote_command(const char* args) {
+#if RF_TDMA
+    if (args[0] < '0' || args[0] >= '0' + RF_PIPE_COUNT || args[1] == '\0') return false;
+    uint8_t pipe = (uint8_t)(args[0] - '0');
+    if (tdma_slot_of(pipe) == 0xFF) return false;  // 遠距端不在線
+
+    uint32_t arg = 0;
+    if (args[2] != '\0' && (!command_parse_u32(&args[2], &arg) || arg > 0xFFFF)) return false;
+    return tdma_send_command(pipe, (uint8_t)args[1], (uint16_t)arg);
+#else
+    (void)args;
+    return false;  // 需 ACK payload
+#endif
+}
+
+// 設定統計輸出：!I<ms>[,<format>]（format 省略時不變）
+bool configure_stats(const char* args) {
+    uint32_t v[2];
+    uint8_t n = command_parse_list(args, v, 2);
+    if (n == 0 || v[0] < COMMAND_INTERVAL_MIN || v[0] > COMMAND_INTERVAL_MAX) return false;
+    if (n == 2 && v[1] > STATS_FORMAT_TEXT) return false;
+    stats_interval = (uint16_t)v[0];
+    if (n == 2) stats_format = (uint8_t)v[1];
+    return true;
+}
+
+// 設定降頻輸出：!D<mode>[,<n>]
+bool configure_decimation(const char* args) {
+    if (args[0] < '0' || args[0] > '9') return false;
+    uint8_t mode = (uint8_t)(args[0] - '0');
+    uint32_t n = 1;
+    if (args[1] == ',') {
+        if (!command_parse_u32(&args[2], &n) || n > DECIMATE_WINDOW_MAX) return false;
+    } else if (args[1] != '\0' || mode != DECIMATE_MODE_ALL) {
+        return false;   // 降頻模式須指定 n
+    }
+    return decimate_configure(mode, (uint8_t)n);
+}
+
+// 重送最近轉送過的感測封包：!P<pipe>,<seq>[,<count>]
+// 依當下輸出模式原樣輸出（含原到達時間），找不到的序號略過；
+// 傳送緩衝剩不到一筆記錄的空間時停止（再寫會擠掉前面剛重送的記錄），只計實際放入緩衝的筆數
+// 回傳: false = 參數錯誤或一筆都沒送出
+bool resend_packets(const char* args) {
+    uint32_t v[3];
+    uint8_t n = command_parse_list(args, v, 3);
+    if (n < 2) return false;
+    uint32_t count = (n == 3) ? v[2] : 1;
+    if (v[0] >= RF_PIPE_COUNT || v[1] > 0xFFFF || count < 1 || count > REPLAY_DEPTH) return false;
+
+    uint8_t sent = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t t_us;
+        const uint8_t* data = replay_find((uint8_t)v[0], (uint16_t)(v[1] + i), &t_us);
+        if (!data) continue;
+        if (uart_tx_free() < UART_RECORD_MAX) break;
+        if (output_packet(rf_payload(data), (uint8_t)v[0], t_us)) sent++;
+    }
+    return sent > 0;
+}
+
+// 處理主機指令
+void handle_command(const Command* cmd, unsigned long now) {
+    uint32_t value;
+    bool ok;
+    switch (cmd->op) {
+    case COMMAND_BAUD:
+        if (command_parse_u32(cmd->args, &value) && baud_request(value)) {
+            report_baud(FRAME_EVENT_BAUD, value);
+        }
+        break;
+    case COMMAND_CONFIRM:
+        if (baud_confirm(now)) {
+            report_baud(FRAME_EVENT_BAUD_OK, baud_current());
+        }
+        break;
+    case COMMAND_SURVEY:
+        rf_survey_start();
+        report_command(cmd->op, true);
+        break;
+    case COMMAND_MODE:
+        ok = command_parse_u32(cmd->args, &value) && value <= OUTPUT_MODE_HEX;
+        report_command(cmd->op, ok);  // 以原模式回覆，主機收到後再切換解析方式
+        if (ok && value != output_mode) {
+            output_mode = (uint8_t)value;
+            print_header();
+        }
+        break;
+    case COMMAND_INTERVAL:
+        ok = configure_stats(cmd->args);
+        report_command(cmd->op, ok);
+        break;
+    case COMMAND_SNAPSHOT:
+        report_command(cmd->op, true);
+        output_stats();
+        break;
+    case COMMAND_CHANNEL:
+        report_command(cmd->op, command_parse_u32(cmd->args, &value) && start_channel_switch(value, now));
+        break;
+    case COMMAND_REMOTE:
+        report_command(cmd->op, forward_remote_command(cmd->args));
+        break;
+    case COMMAND_DECIMATE:
+        ok = configure_decimation(cmd->args);
+        report_command(cmd->op, ok);
+        if (ok && output_mode != OUTPUT_MODE_BINARY && decimate_mode() == DECIMATE_MODE_ENVELOPE) {
+            print_status(PSTR("#env,pipe,seq,n,valid,btn,stat,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2"));
+        }
+        break;
+    case COMMAND_RESEND:
+        // 先送封包再回覆，主機收到回覆即代表重送結束
+        report_command(cmd->op, resend_packets(cmd->args));
+        break;
+    default:
+        report_command(cmd->op, false);
+        break;
+    }
+}
+
+void setup() {
+    // 初始化 Serial（中斷驅動傳送緩衝，見 uart.h）
+    uart_init(SERIAL_BAUD);
+    if (output_mode == OUTPUT_MODE_BINARY) {
+        frame_send_event(FRAME_EVENT_BOOT, PROTOCOL_VERSION);
+    } else {
+        // 狀態訊息以 # 開頭（解析器忽略）
+        print_status(PSTR("#Mechtronic Base Station v2.0"));
+    }
+
+    // 初始化 LED
+    LedGpio::set_output();
+    LedGpio::high();  // 開機指示
+
+    // 初始化 RF 接收器（失敗時 LED 快閃，由 loop() 定期重試）
+    rf_ok = rf_receiver_init();
+    report_rf_state(rf_ok);
+    rf_survey_init();
+    replay_init();
+#if RF_TDMA
+    tdma_init(micros());
+#endif
 
     // 初始化統計
-    stats_init(&stats);
+    for (uint8_t pipe = 0; pipe < RF_PIPE_COUNT; pipe++) {
+        stats_init(&stats[pipe]);
+    }
 
-    // 輸出 CSV 標題（以 # 開頭，解析器可選擇解析或忽略）
-    Serial.println(F("#seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2"));
+    print_header();
 
-    digitalWrite(LED_PIN, LOW);
+    LedGpio::low();
     last_receive_time = millis();
     last_stats_time = millis();
+    rf_retry_time = millis();
+    led_pattern_init(&led, rf_ok ? LED_PATTERN_OFF : LED_PATTERN_FAST, millis());
+}
+
+// LED 狀態：RF 故障快閃、無資料常亮、接收中熄滅
+void update_led(unsigned long now) {
+    uint8_t pattern;
+    if (!rf_ok) {
+        pattern = LED_PATTERN_FAST;
+    } else if (now - last_receive_time > NO_DATA_TIMEOUT) {
+        pattern = LED_PATTERN_ON;
+    } else {
+        pattern = LED_PATTERN_OFF;
+    }
+    led_pattern_set(&led, pattern, now);
+    LedGpio::write(led_pattern_update(&led, now));
 }
 
 void loop() {
     unsigned long now = millis();
 
-    // 檢查是否有資料
-    if (rf_available()) {
-        // 讀取封包
-        rf_read(&packet, sizeof(SensorPacket));
-        last_receive_time = now;
-
-        // LED 快速閃爍表示收到資料
-        digitalWrite(LED_PIN, HIGH);
+    // RF 故障：定期重試初始化
+    if (!rf_ok) {
+        if (now - rf_retry_time >= RF_RETRY_INTERVAL) {
+            rf_retry_time = now;
+            rf_ok = rf_receiver_init();
+            if (rf_ok) {
+                report_rf_state(true);
+            }
+        }
+    } else {
+        // 封包由 IRQ 中斷搬入接收緩衝，這裡只負責消化
+        rf_service();
+        while (rf_receive(&rx_packet)) {
+            if (rx_packet.pipe >= RF_PIPE_COUNT) continue;
+            const RadioPayload* rx = rf_payload(rx_packet.data);
+            last_receive_time = now;
 
-        // 驗證協議版本
-        if (packet.version != PROTOCOL_VERSION) {
-            Serial.print(F("#[WARN] Bad version: "));
-            Serial.println(packet.version);
-        } else {
-            // 更新統計
-            stats_update(&stats, packet.seq);
+            // 依 Byte 0 更新該遠距端統計：感測封包驗證協議版本並分類序號，健康封包存入 Stats
+            Stats* s = &stats[rx_packet.pipe];
+            SeqClass seq_class = SEQ_NEW;
+            if (rx->sensor.version == PROTOCOL_VERSION) {
+                seq_class = stats_update(s, rx->sensor.seq, rx->sensor.timestamp, rx_packet.t_us);
+            } else if (rx->raw[0] == PACKET_TYPE_HEALTH) {
+                stats_update_health(s, &rx->health);
+            }
+#if RF_TDMA
+            // 量測到達相位並預載時槽同步 ACK payload（重複封包也帶走了一筆 ACK payload）
+            tdma_on_packet(rx_packet.pipe, rx, rx_packet.t_us, now);
+#endif
 
-            // 每筆都輸出 CSV（100Hz）
-            print_csv_line(&packet);
+            // 重複封包不輸出；其餘每筆都輸出（每個遠距端 100Hz，晚到的封包照收到順序）
+            if (seq_class == SEQ_DUPLICATE) continue;
+            output_packet(rx, rx_packet.pipe, rx_packet.t_us);
+            if (rx->sensor.version == PROTOCOL_VERSION) replay_record(&rx_packet);
         }
+#if RF_TDMA
+        tdma_service(micros(), now);
+#endif
+
+        // 頻道監測 / 掃描（每次最多探測一個頻道）
+        uint8_t survey = rf_survey_service(now);
+#if RF_TDMA
+        if (survey & RF_SURVEY_PROBED) tdma_ack_flushed();
+#endif
+        if (survey & RF_SURVEY_DONE) output_survey();
 
-        digitalWrite(LED_PIN, LOW);
+        // !C：遠距端都已收到指令（或逾時）後切換 Base
+        if (channel_switch_pending) {
+#if RF_TDMA
+            bool delivered = !tdma_command_pending();
+#else
+            bool delivered = true;
+#endif
+            if (delivered || now - channel_switch_time >= CHANNEL_SWITCH_DELAY_MS) {
+                channel_switch_pending = false;
+                rf_set_channel(channel_switch_to);
+#if RF_TDMA
+                tdma_ack_flushed();
+#endif
+            }
+        }
     }
 
     // 更新速率統計
-    stats_update_rate(&stats);
+    for (uint8_t pipe = 0; pipe < RF_PIPE_COUNT; pipe++) {
+        stats_update_rate(&stats[pipe]);
+    }
 
     // 定期輸出統計（以 # 開頭）
-    if (now - last_stats_time >= STATS_INTERVAL) {
-        stats_print(&stats);
+    if (now - last_stats_time >= stats_interval) {
+        output_stats();
         last_stats_time = now;
     }
+    output_service();
 
-    // 無資料超時指示
-    if (now - last_receive_time > NO_DATA_TIMEOUT) {
-        // LED 常亮表示無資料
-        digitalWrite(LED_PIN, HIGH);
+    // 主機指令與鮑率協商
+    Command cmd;
+    if (command_poll(&cmd)) {
+        handle_command(&cmd, now);
     }
+    if (baud_service(now) == BAUD_EVENT_FALLBACK) {
+        report_baud(FRAME_EVENT_BAUD, BAUD_DEFAULT);
+    }
+
+    // 非 AVR 平台：搬移傳送緩衝（AVR 由中斷送出）
+    uart_poll();
+
+    // LED 狀態指示
+    update_led(now);
 }
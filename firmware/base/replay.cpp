@@ -0,0 +1,65 @@
+#include "replay.h"
+#include "../common/packet.h"
+#include <string.h>
+
+static ReplayEntry ring[REPLAY_DEPTH] __attribute__((aligned(REPLAY_STORAGE_ALIGN)));
+static uint8_t head = 0;      // 下一筆寫入位置
+static uint8_t count = 0;     // 有效筆數
+static uint32_t last_t_us = 0; // 最新一筆的完整到達時間
+static bool recording = true;
+
+void replay_init(void) {
+    replay_restore();
+}
+
+// 第 n 新的一筆（0 = 最新）
+static uint8_t slot_back(uint8_t n) {
+    return (uint8_t)((head + REPLAY_DEPTH - 1 - n) % REPLAY_DEPTH);
+}
+
+void replay_record(const RfPacket* pkt) {
+    if (!recording) return;
+
+    // 捨棄距新封包超過 16-bit 時間範圍的舊筆（之後無法還原到達時間）
+    // 不變量：緩衝內每筆與 last_t_us 相差 < 65536 us，所以低 16 位元相減即為實際間隔
+    uint32_t advance = pkt->t_us - last_t_us;
+    while (count > 0) {
+        uint16_t age = (uint16_t)((uint16_t)last_t_us - ring[slot_back(count - 1)].t_us_low);
+        if (advance <= 0xFFFFUL - age) break;
+        count--;
+    }
+
+    ReplayEntry* e = &ring[head];
+    e->t_us_low = (uint16_t)pkt->t_us;
+    e->pipe = pkt->pipe;
+    memcpy(e->data, pkt->data, RF_PAYLOAD_SIZE);
+    last_t_us = pkt->t_us;
+    if (++head >= REPLAY_DEPTH) head = 0;
+    if (count < REPLAY_DEPTH) count++;
+}
+
+const uint8_t* replay_find(uint8_t pipe, uint16_t seq, uint32_t* t_us) {
+    if (!recording) return 0;
+    // 由新到舊找（同一序號只會有一筆，重複封包不記錄）
+    for (uint8_t n = 0; n < count; n++) {
+        const ReplayEntry* e = &ring[slot_back(n)];
+        const SensorPacket* p = (const SensorPacket*)e->data;
+        if (e->pipe == pipe && p->seq == seq) {
+            *t_us = last_t_us - (uint16_t)((uint16_t)last_t_us - e->t_us_low);
+            return e->data;
+        }
+    }
+    return 0;
+}
+
+void* replay_borrow(void) {
+    recording = false;
+    count = 0;
+    return ring;
+}
+
+void replay_restore(void) {
+    head = 0;
+    count = 0;
+    recording = true;
+}
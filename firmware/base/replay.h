@@ -0,0 +1,49 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rf_receiver.h"
+
+// 重送緩衝（!P 指令）
+//
+// 保留最近 REPLAY_DEPTH 筆已轉送的感測封包（含到達時間），主機讀取停頓或 USB 位元錯誤
+// 造成缺號時，可依序號範圍要求 Base 原樣重送（輸出格式與當下輸出模式相同）。
+// 重複封包不記錄；遙測封包不記錄。
+//
+// 每筆只存重送需要的內容：32 bytes 封包 + 管道 + 到達時間低 16 位元（35 bytes）。
+// 完整到達時間由最新一筆的 32-bit 時間往回推，所以緩衝內只保留最新一筆之前 65 ms 內的封包，
+// 更舊的在記錄新封包時捨棄（100Hz 下 1 個遠距端本來就只保留 60 ms）。
+//
+// RAM：REPLAY_DEPTH × 35 bytes。降頻模式（decimate.h）借用同一塊記憶體存放視窗，
+// 降頻期間不記錄也不能重送（降頻輸出本來就不追求無缺漏），!D0 後重新開始記錄。
+
+#define REPLAY_DEPTH   6    // 筆數；所有遠距端共用（1 個遠距端約 60 ms，6 個約 10 ms）
+
+typedef struct {
+    uint16_t t_us_low;                  // 到達時間 micros() 低 16 位元
+    uint8_t  pipe;
+    uint8_t  data[RF_PAYLOAD_SIZE];
+} ReplayEntry;
+
+#define REPLAY_STORAGE_SIZE (REPLAY_DEPTH * sizeof(ReplayEntry))
+#define REPLAY_STORAGE_ALIGN 4   // 緩衝起點對齊（ReplayEntry 本身只需 2，借用者可存放 int32_t）
+
+// 初始化（清空並開始記錄）
+void replay_init(void);
+
+// 記錄一筆已輸出的感測封包
+void replay_record(const RfPacket* pkt);
+
+// 依管道與序號找出封包
+// t_us: 輸出原到達時間 micros()
+// 回傳: 封包內容 (RF_PAYLOAD_SIZE bytes)，NULL = 已被覆蓋或從未收到
+const uint8_t* replay_find(uint8_t pipe, uint16_t seq, uint32_t* t_us);
+
+// 借出緩衝區（清空並停止記錄），回傳起點（REPLAY_STORAGE_SIZE bytes，對齊 REPLAY_STORAGE_ALIGN）
+void* replay_borrow(void);
+
+// 收回緩衝區：清空並恢復記錄
+void replay_restore(void);
+
+#endif
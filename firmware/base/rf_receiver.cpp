@@ -1,42 +1,212 @@
 #include "rf_receiver.h"
+#include <Arduino.h>
 #include <SPI.h>
 #include <RF24.h>
+#include "../common/fast_gpio.h"
+#include "../common/rf_address.h"
+
+#if (RF_RX_RING_SIZE & (RF_RX_RING_SIZE - 1)) != 0
+#error "RF_RX_RING_SIZE must be a power of two"
+#endif
+
+#define RING_MASK (RF_RX_RING_SIZE - 1)
 
 // RF24 物件
 static RF24 radio(RF_CE_PIN, RF_CSN_PIN);
 
-// 接收管道位址（與遠距端發送位址相同）
-static const uint8_t rx_addr[5] = {'M','E','C','H','1'};
+// 接收環形緩衝（中斷寫入 head，主迴圈讀取 tail）
+static RfPacket ring[RF_RX_RING_SIZE];
+static volatile uint8_t head = 0;
+static volatile uint8_t tail = 0;
+static volatile uint16_t rx_overflow = 0;
+
+typedef FastGpio<RF_IRQ_PIN> IrqGpio;
+
+static uint8_t channel = RF_CHANNEL;
+static uint8_t lock_depth = 0;
+static bool irq_attached = false;
+
+static void rf_irq_handler(void);
+
+#if defined(__AVR_ATmega328P__)
+#include <avr/io.h>
+#define rf_irq_mask()    (EIMSK &= ~_BV(INT0))
+#define rf_irq_unmask()  (EIMSK |= _BV(INT0))   // 遮蔽期間的下降邊緣由 INTF0 保留，解除後立即觸發
+#else
+#define rf_irq_mask()    detachInterrupt(digitalPinToInterrupt(RF_IRQ_PIN))
+#define rf_irq_unmask()  attachInterrupt(digitalPinToInterrupt(RF_IRQ_PIN), rf_irq_handler, FALLING)
+#endif
+
+// 搬移硬體 FIFO 內所有封包（中斷內或 rf_lock 狀態下呼叫）
+static void drain_fifo(void) {
+    uint32_t t_us = micros();
+
+    // 先清除 RX_DR 再讀取：讀取期間到達的新封包會重新拉低 IRQ，不會遺失
+    bool tx_ok, tx_fail, rx_ready;
+    radio.whatHappened(tx_ok, tx_fail, rx_ready);
+
+    uint8_t pipe;
+    while (radio.available(&pipe)) {
+        uint8_t next = (head + 1) & RING_MASK;
+        if (next == tail) {
+            // 緩衝滿：讀出丟棄，避免硬體 FIFO 卡住
+            uint8_t discard[RF_PAYLOAD_SIZE];
+            radio.read(discard, RF_PAYLOAD_SIZE);
+            rx_overflow++;
+            continue;
+        }
+        RfPacket* pkt = &ring[head];
+        pkt->t_us = t_us;
+        pkt->pipe = pipe;
+        radio.read(pkt->data, RF_PAYLOAD_SIZE);
+        head = next;
+    }
+}
+
+static void rf_irq_handler(void) {
+#if defined(__AVR_ATmega328P__)
+    // 只遮蔽自己後重新開放中斷，SPI 讀取期間 UART 中斷照常服務
+    rf_irq_mask();
+    interrupts();
+    drain_fifo();
+    noInterrupts();
+    rf_irq_unmask();
+#else
+    drain_fifo();
+#endif
+}
+
+void rf_lock(void) {
+    if (lock_depth++ == 0 && irq_attached) rf_irq_mask();
+}
+
+void rf_unlock(void) {
+    if (lock_depth > 0 && --lock_depth == 0 && irq_attached) rf_irq_unmask();
+}
 
 bool rf_receiver_init(void) {
+    rf_lock();
+
     if (!radio.begin()) {
+        rf_unlock();
         return false;
     }
 
-    // 設定參數（與遠距端相同）
-    radio.setChannel(RF_CHANNEL);
-    radio.setDataRate(RF24_250KBPS);
-    radio.setPALevel(RF24_PA_LOW);
-    radio.setPayloadSize(32);
+    // 設定參數（與遠距端共用 common/nrf24_config.h）
+    radio.setChannel(channel);
+    radio.setDataRate(RF_DATARATE);
+    radio.setPALevel(RF_PA_LEVEL);
+    radio.setPayloadSize(RF_PAYLOAD_SIZE);
     radio.setAutoAck(true);
-    radio.setCRCLength(RF24_CRC_16);
+    radio.setCRCLength(RF_CRC_LENGTH);
+#if RF_TDMA
+    // ACK payload 需動態長度（遠距端同樣啟用）
+    radio.enableDynamicPayloads();
+    radio.enableAckPayload();
+#endif
 
-    // 開啟接收管道
-    radio.openReadingPipe(1, rx_addr);
+    // IRQ 只反應 RX_DR（不反應 TX_DS / MAX_RT）
+    radio.maskIRQ(true, true, false);
+
+    // 開啟全部接收管道，每個遠距端一個（pipe 2-5 只寫入最低位元組）
+    uint8_t addr[5];
+    for (uint8_t pipe = 0; pipe < RF_PIPE_COUNT; pipe++) {
+        rf_pipe_address(pipe, addr);
+        radio.openReadingPipe(pipe, addr);
+    }
     radio.startListening();  // RX 模式
 
+    if (!irq_attached) {
+        IrqGpio::set_input_pullup();
+        attachInterrupt(digitalPinToInterrupt(RF_IRQ_PIN), rf_irq_handler, FALLING);
+        irq_attached = true;
+#if defined(__AVR_ATmega328P__)
+        rf_irq_mask();  // 由下方 rf_unlock() 開啟
+#endif
+    }
+
+    rf_unlock();
     return true;
 }
 
-bool rf_available(void) {
-    return radio.available();
+bool rf_receive(RfPacket* pkt) {
+    if (tail == head) return false;
+    *pkt = ring[tail];
+    tail = (tail + 1) & RING_MASK;
+    return true;
 }
 
-uint8_t rf_read(void* buffer, uint8_t len) {
-    if (!radio.available()) {
-        return 0;
-    }
+void rf_service(void) {
+    if (!irq_attached || IrqGpio::read()) return;
+    rf_lock();
+    drain_fifo();
+    rf_unlock();
+}
+
+bool rf_write_ack(uint8_t pipe, const void* data, uint8_t len) {
+#if RF_TDMA
+    rf_lock();
+    bool ok = radio.writeAckPayload(pipe, data, len);
+    rf_unlock();
+    return ok;
+#else
+    (void)pipe;
+    (void)data;
+    (void)len;
+    return false;
+#endif
+}
+
+void rf_flush_ack(void) {
+    rf_lock();
+    radio.flush_tx();
+    rf_unlock();
+}
+
+uint8_t rf_get_channel(void) {
+    return channel;
+}
+
+bool rf_set_channel(uint8_t ch) {
+    if (ch > 125) return false;
+    channel = ch;
+    rf_lock();
+    radio.stopListening();
+    radio.setChannel(channel);
+    radio.startListening();
+    rf_unlock();
+    return true;
+}
+
+bool rf_read_rpd(void) {
+    rf_lock();
+    bool rpd = radio.testRPD();
+    rf_unlock();
+    return rpd;
+}
+
+bool rf_probe_channel(uint8_t probe) {
+    // 停留期間不鎖住 IRQ：已在接收緩衝外的封包照常由中斷搬移
+    rf_lock();
+    radio.stopListening();
+    radio.setChannel(probe);
+    radio.startListening();
+    rf_unlock();
+
+    delayMicroseconds(RF_PROBE_DWELL_US);
+
+    rf_lock();
+    bool rpd = radio.testRPD();
+    radio.stopListening();
+    radio.setChannel(channel);
+    radio.startListening();
+    rf_unlock();
+    return rpd;
+}
 
-    radio.read(buffer, len);
-    return len;
+uint16_t rf_get_rx_overflow(void) {
+    noInterrupts();
+    uint16_t n = rx_overflow;
+    interrupts();
+    return n;
 }
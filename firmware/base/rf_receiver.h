@@ -3,27 +3,73 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "../common/packet.h"
+#include "../common/rf_address.h"
+#include "../common/nrf24_config.h"
 
 // nRF24 腳位（與遠距端相同）
 #define RF_CE_PIN   9
 #define RF_CSN_PIN  10
+#define RF_IRQ_PIN  2    // nRF24 IRQ（低電位有效）→ Uno D2 (INT0)
 
-// 無線參數（與遠距端相同）
-#define RF_CHANNEL     76
-#define RF_DATARATE    RF24_250KBPS
-#define RF_PA_LEVEL    RF24_PA_LOW
+// 無線參數（頻道、速率等）與遠距端共用，見 common/nrf24_config.h
 
-// 初始化 nRF24L01+ (RX 模式)
+// 頻道探測：切到目標頻道後等待 PLL 穩定 (130us) 與 AGC (40us) 再讀 RPD
+#define RF_PROBE_DWELL_US 200
+
+// 接收環形緩衝：IRQ 中斷把硬體 FIFO（3 筆）搬到這裡，Serial 輸出再慢也不會塞住無線接收
+#define RF_RX_RING_SIZE 4    // 筆數，須為 2 的冪次（加上硬體 FIFO 共 7 筆，6 個遠距端約 7 ms）
+
+// 接收到的封包
+typedef struct {
+    uint32_t t_us;                      // 到達時間 micros()（中斷進入時）
+    uint8_t  pipe;                      // 接收管道 0 ~ RF_PIPE_COUNT-1（= 遠距端編號）
+    uint8_t  data[RF_PAYLOAD_SIZE];
+} RfPacket;
+
+// 直接以 RadioPayload 檢視收到的內容（各封包結構皆 packed，對齊為 1，不必複製）
+static inline const RadioPayload* rf_payload(const uint8_t* data) {
+    return (const RadioPayload*)data;
+}
+
+// 初始化 nRF24L01+ (RX 模式，開啟全部 RF_PIPE_COUNT 個管道) 並啟用 IRQ 中斷
 // 回傳: true=成功, false=失敗
 bool rf_receiver_init(void);
 
-// 檢查是否有資料可讀
-bool rf_available(void);
+// 從接收緩衝取出一筆
+// 回傳: false = 緩衝為空
+bool rf_receive(RfPacket* pkt);
+
+// 補漏：IRQ 腳仍為低電位但中斷未觸發時（遺失邊緣）改由主迴圈搬移（每次 loop 呼叫）
+void rf_service(void);
+
+// 接收緩衝滿而丟棄的封包數
+uint16_t rf_get_rx_overflow(void);
+
+// 主迴圈存取 nRF24（SPI）前後呼叫，期間暫停 IRQ 中斷（可巢狀）
+void rf_lock(void);
+void rf_unlock(void);
+
+// 預載 ACK payload：該管道下一個封包的 ACK 會帶回此內容（需 RF_TDMA）
+// 回傳: false = TX FIFO 已滿
+bool rf_write_ack(uint8_t pipe, const void* data, uint8_t len);
+
+// 清空尚未送出的 ACK payload
+void rf_flush_ack(void);
+
+// 接收頻道
+uint8_t rf_get_channel(void);
+
+// 切換接收頻道（0-125，經過待機模式，預載的 ACK payload 會被清空）
+// 回傳: false = 頻道超出範圍
+bool rf_set_channel(uint8_t channel);
+
+// 接收功率偵測 (RPD)：接收頻道上是否有 > -64 dBm 的訊號（包含遠距端自己的封包）
+bool rf_read_rpd(void);
 
-// 讀取封包
-// buffer: 接收緩衝區指標
-// len: 要讀取的長度
-// 回傳: 實際讀取的長度
-uint8_t rf_read(void* buffer, uint8_t len);
+// 切到 channel 停留 RF_PROBE_DWELL_US 讀取 RPD，再切回接收頻道（約 1 ms，期間漏收）
+// 切換經過待機模式，預載的 ACK payload 會被清空
+// 回傳: RPD 結果
+bool rf_probe_channel(uint8_t channel);
 
 #endif
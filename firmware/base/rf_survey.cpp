@@ -0,0 +1,107 @@
+#include "rf_survey.h"
+#include "rf_receiver.h"
+#include "csv_format.h"
+#include <string.h>
+
+// 工作頻道 RPD
+static uint32_t rpd_last_ms = 0;
+static uint16_t rpd_samples = 0;
+static uint16_t rpd_hits = 0;
+
+// 頻譜掃描：每頻道 4 bits 命中次數
+static uint8_t survey_hits[SURVEY_CHANNELS / 2];
+static bool survey_active = false;
+static uint8_t survey_channel = 0;
+static uint8_t survey_pass = 0;
+static uint32_t survey_last_ms = 0;
+
+void rf_survey_init(void) {
+    rpd_samples = 0;
+    rpd_hits = 0;
+    survey_active = false;
+    memset(survey_hits, 0, sizeof(survey_hits));
+}
+
+static char hex_digit(uint8_t n) {
+    return (n < 10) ? (char)('0' + n) : (char)('a' + n - 10);
+}
+
+uint8_t rf_survey_service(uint32_t now_ms) {
+    if (now_ms - rpd_last_ms >= RF_RPD_PERIOD_MS) {
+        rpd_last_ms = now_ms;
+        if (rpd_samples < 0xFFFF) {
+            rpd_samples++;
+            if (rf_read_rpd()) rpd_hits++;
+        }
+    }
+
+    if (!survey_active || now_ms - survey_last_ms < SURVEY_STEP_MS) return 0;
+    survey_last_ms = now_ms;
+
+    if (rf_probe_channel(survey_channel)) {
+        survey_hits[survey_channel >> 1] += (survey_channel & 1) ? 0x10 : 0x01;
+    }
+    if (++survey_channel < SURVEY_CHANNELS) return RF_SURVEY_PROBED;
+
+    survey_channel = 0;
+    if (++survey_pass < SURVEY_PASSES) return RF_SURVEY_PROBED;
+
+    survey_active = false;
+    return RF_SURVEY_PROBED | RF_SURVEY_DONE;
+}
+
+void rf_survey_start(void) {
+    memset(survey_hits, 0, sizeof(survey_hits));
+    survey_channel = 0;
+    survey_pass = 0;
+    survey_active = true;
+}
+
+bool rf_survey_running(void) {
+    return survey_active;
+}
+
+void rf_survey_take_rpd(RpdFrame* frame) {
+    frame->channel = rf_get_channel();
+    frame->samples = rpd_samples;
+    frame->hits = rpd_hits;
+    rpd_samples = 0;
+    rpd_hits = 0;
+}
+
+void rf_survey_fill_frame(uint8_t chunk, SurveyFrame* frame) {
+    frame->start = chunk * SURVEY_CHUNK;
+    frame->passes = SURVEY_PASSES;
+    memcpy(frame->hits, &survey_hits[frame->start / 2], sizeof(frame->hits));
+}
+
+void rf_survey_print_rpd(const RpdFrame* frame) {
+    TextLine line;
+    line_init(&line);
+    line_put_str(&line, "#rpd,ch=");
+    line_put_u32(&line, frame->channel);
+    line_put_str(&line, ",n=");
+    line_put_u32(&line, frame->samples);
+    line_put_str(&line, ",busy=");
+    uint16_t permille = frame->samples
+        ? (uint16_t)((frame->hits * 1000UL + frame->samples / 2) / frame->samples) : 0;
+    line_put_x10(&line, permille);
+    line_put_char(&line, '%');
+    line_send(&line);
+}
+
+void rf_survey_print(const SurveyFrame* frame) {
+    // 每頻道一個十六進位數字
+    TextLine line;
+    line_init(&line);
+    line_put_str(&line, "#survey,ch=");
+    line_put_u32(&line, frame->start);
+    line_put_str(&line, ",n=");
+    line_put_u32(&line, frame->passes);
+    line_put_str(&line, ",rpd=");
+    for (uint8_t i = 0; i < SURVEY_CHUNK / 2; i++) {
+        line_put_char(&line, hex_digit(frame->hits[i] & 0x0F));
+        line_put_char(&line, hex_digit(frame->hits[i] >> 4));
+    }
+    line_send(&line);
+}
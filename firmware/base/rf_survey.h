@@ -0,0 +1,62 @@
+#ifndef RF_SURVEY_H
+#define RF_SURVEY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 頻道監測
+//
+// - 工作頻道：每 RF_RPD_PERIOD_MS 讀一次 RPD（不切頻道，不影響接收），
+//   統計輸出時回報佔用率（busy = RPD 命中比例，包含遠距端自己的封包，需對照 pps 判讀）
+// - 頻譜掃描（!V 指令）：每 SURVEY_STEP_MS 探測一個頻道（約 1 ms 漏收），
+//   0-125 輪流掃 SURVEY_PASSES 次，完成後輸出每個頻道的 RPD 命中次數
+
+#define RF_RPD_PERIOD_MS  10    // 工作頻道 RPD 取樣週期
+#define SURVEY_CHANNELS   126   // 頻道 0-125
+#define SURVEY_PASSES     8     // 每個頻道取樣次數（≤ 15，每頻道 4 bits）
+#define SURVEY_STEP_MS    4     // 探測間隔；一次掃描約 126 × 8 × 4 ms ≈ 4 秒
+#define SURVEY_CHUNK      42    // 每筆輸出的頻道數（3 筆涵蓋 126 個頻道）
+#define SURVEY_CHUNKS     (SURVEY_CHANNELS / SURVEY_CHUNK)
+
+// rf_survey_service 回傳旗標
+#define RF_SURVEY_PROBED  0x01  // 探測了一個頻道（預載的 ACK payload 已被清空）
+#define RF_SURVEY_DONE    0x02  // 一次掃描完成（呼叫端輸出結果）
+
+// 二進位工作頻道 RPD 框架內容 (FRAME_TYPE_RPD)
+typedef struct __attribute__((packed)) {
+    uint8_t  channel;           // 工作頻道
+    uint16_t samples;           // 取樣次數（上次輸出後）
+    uint16_t hits;              // RPD 命中次數
+} RpdFrame;
+
+// 二進位頻譜掃描框架內容 (FRAME_TYPE_SURVEY，每次掃描 SURVEY_CHUNKS 筆)
+typedef struct __attribute__((packed)) {
+    uint8_t start;                      // 第一個頻道
+    uint8_t passes;                     // 每頻道取樣次數
+    uint8_t hits[SURVEY_CHUNK / 2];     // 每頻道 4 bits 命中次數，低 4 位元為偶數頻道
+} SurveyFrame;
+
+// 初始化
+void rf_survey_init(void);
+
+// 每次 loop 呼叫（RF 正常時）：工作頻道 RPD 取樣、掃描推進
+// 回傳: RF_SURVEY_* 旗標
+uint8_t rf_survey_service(uint32_t now_ms);
+
+// 開始頻譜掃描（進行中則重新開始）
+void rf_survey_start(void);
+
+// 是否正在掃描
+bool rf_survey_running(void);
+
+// 取出工作頻道 RPD 統計並歸零（統計輸出時呼叫）
+void rf_survey_take_rpd(RpdFrame* frame);
+
+// 取得掃描結果的第 chunk 筆（0 ~ SURVEY_CHUNKS-1）
+void rf_survey_fill_frame(uint8_t chunk, SurveyFrame* frame);
+
+// 輸出到 Serial（#rpd 行 / #survey 行）
+void rf_survey_print_rpd(const RpdFrame* frame);
+void rf_survey_print(const SurveyFrame* frame);
+
+#endif
@@ -0,0 +1,55 @@
+#include "serial_frame.h"
+#include "../common/cobs.h"
+#include "../common/crc.h"
+#include "uart.h"
+#include "csv_format.h"
+#include <Arduino.h>
+#include <string.h>
+
+#define FRAME_RAW_MAX (FRAME_HEADER_LEN + FRAME_MAX_PAYLOAD + FRAME_CRC_LEN)
+
+bool frame_send(uint8_t type, uint32_t t_us, const void* payload, uint8_t len) {
+    if (len > FRAME_MAX_PAYLOAD) len = FRAME_MAX_PAYLOAD;
+
+    uint8_t raw[FRAME_RAW_MAX];
+    raw[0] = type;
+    raw[1] = (uint8_t)t_us;
+    raw[2] = (uint8_t)(t_us >> 8);
+    raw[3] = (uint8_t)(t_us >> 16);
+    raw[4] = (uint8_t)(t_us >> 24);
+    memcpy(&raw[FRAME_HEADER_LEN], payload, len);
+
+    uint8_t n = FRAME_HEADER_LEN + len;
+    uint16_t crc = crc16(raw, n);
+    raw[n++] = (uint8_t)crc;
+    raw[n++] = (uint8_t)(crc >> 8);
+
+    uint8_t out[COBS_MAX_ENCODED(FRAME_RAW_MAX) + 1];
+    uint8_t out_len = (uint8_t)cobs_encode(raw, n, out);
+    out[out_len++] = 0x00;  // 框架分隔符
+    return uart_write_record(out, out_len);
+}
+
+void frame_send_event(uint8_t code, uint8_t arg) {
+    uint8_t payload[2] = { code, arg };
+    frame_send(FRAME_TYPE_EVENT, micros(), payload, sizeof(payload));
+}
+
+void frame_print(uint8_t type, uint32_t t_us, const void* payload, uint8_t len) {
+    if (len > FRAME_MAX_PAYLOAD) len = FRAME_MAX_PAYLOAD;
+
+    uint8_t header[FRAME_HEADER_LEN];
+    header[0] = type;
+    header[1] = (uint8_t)t_us;
+    header[2] = (uint8_t)(t_us >> 8);
+    header[3] = (uint8_t)(t_us >> 16);
+    header[4] = (uint8_t)(t_us >> 24);
+
+    // 最長 3 + 2 × 37 = 77 字元
+    TextLine line;
+    line_init(&line);
+    line_put_str(&line, "#f,");
+    line_put_hex(&line, header, sizeof(header));
+    line_put_hex(&line, payload, len);
+    line_send(&line);
+}
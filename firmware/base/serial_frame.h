@@ -0,0 +1,54 @@
+#ifndef SERIAL_FRAME_H
+#define SERIAL_FRAME_H
+
+#include <stdint.h>
+
+// 二進位輸出框架（OUTPUT_MODE_BINARY）
+//
+// 編碼前: [type:1][t_base_us:4][payload:0-32][crc16:2]（多位元組欄位皆 little-endian）
+// 傳輸:   COBS(編碼前內容) + 0x00
+// CRC-16/CCITT 涵蓋 type 到 payload 結尾（common/crc.h）
+
+// 框架類型
+#define FRAME_TYPE_RADIO  0x01  // 收到的 32-byte 無線封包原樣轉送（感測 / 遙測）
+#define FRAME_TYPE_STATS  0x02  // 單一遠距端接收統計 (StatsFrame)
+#define FRAME_TYPE_EVENT  0x03  // 狀態事件 [code:1][arg:1]
+#define FRAME_TYPE_BASE_STATS 0x04  // Base 端 Serial / 接收緩衝統計 (BaseStatsFrame)
+#define FRAME_TYPE_LINK   0x05  // 單一遠距端鏈路品質 (LinkFrame)
+#define FRAME_TYPE_RPD    0x06  // 工作頻道 RPD 佔用率 (RpdFrame)
+#define FRAME_TYPE_SURVEY 0x07  // 頻譜掃描結果，每次掃描 3 筆 (SurveyFrame)
+#define FRAME_TYPE_ENVELOPE 0x08  // 降頻包絡，每個視窗 min / max / mean 3 筆 (EnvelopeFrame)
+
+// RADIO / STATS / LINK 框架的 type 高 4 位元為接收管道（遠距端編號 0-5），低 4 位元為框架類型
+#define FRAME_TYPE_MASK   0x0F
+#define FRAME_PIPE_SHIFT  4
+#define FRAME_TYPE_PIPE(type, pipe) ((uint8_t)((type) | ((pipe) << FRAME_PIPE_SHIFT)))
+
+// 事件碼（取代 #[OK] / #[ERROR] 等文字行）
+#define FRAME_EVENT_BOOT      0x01  // 開機，arg = PROTOCOL_VERSION
+#define FRAME_EVENT_RF_OK     0x02  // RF 接收器就緒
+#define FRAME_EVENT_RF_ERROR  0x03  // RF 初始化失敗
+#define FRAME_EVENT_TX_SKIP   0x04  // Serial 壅塞期間略過的樣本數，arg = min(略過數, 255)
+#define FRAME_EVENT_BAUD      0x05  // 即將切換 / 已退回鮑率，arg = BAUD_RATES 索引
+#define FRAME_EVENT_BAUD_OK   0x06  // 鮑率協商完成，arg = BAUD_RATES 索引
+#define FRAME_EVENT_CMD_OK    0x07  // 主機指令已執行，arg = 指令碼
+#define FRAME_EVENT_CMD_ERR   0x08  // 主機指令參數錯誤或無法執行，arg = 指令碼
+
+#define FRAME_HEADER_LEN   5
+#define FRAME_CRC_LEN      2
+#define FRAME_MAX_PAYLOAD  32
+
+// 送出一個框架（一筆 uart 記錄；緩衝區不足時整個框架丟棄）
+// t_us: 封包到達時間（micros()）或事件發生時間
+// 回傳: true=已放入傳送緩衝, false=框架被丟棄
+bool frame_send(uint8_t type, uint32_t t_us, const void* payload, uint8_t len);
+
+// 送出事件框架
+void frame_send_event(uint8_t code, uint8_t arg);
+
+// 文字模式（CSV / 十六進位）下以一行送出框架內容：#f,<hex>\r\n
+// <hex> = [type][t_base_us][payload] 逐位元組小寫十六進位（與框架編碼前內容相同，不含 CRC），
+// 主機端以同一套框架解析；統計等定期輸出用這個格式取代 key=value 文字行（不需十進位轉換）
+void frame_print(uint8_t type, uint32_t t_us, const void* payload, uint8_t len);
+
+#endif
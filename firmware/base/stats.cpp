@@ -1,42 +1,170 @@
 #include "stats.h"
+#include "csv_format.h"
+#include "uart.h"
+#include "rf_receiver.h"
 #include <Arduino.h>
+#include <string.h>
+
+// 健康狀態槽位（依收到順序分配，見 stats.h）
+static RemoteHealth health_slots[STATS_HEALTH_SLOTS];
+
+// 記錄一段連續掉包
+static void link_record_burst(LinkStats* link, uint16_t length) {
+    uint8_t bucket = 0;
+    for (uint16_t n = length - 1; n != 0 && bucket < LINK_BURST_BUCKETS - 1; n >>= 1) {
+        bucket++;
+    }
+    // 飽和時全部減半，分布比例不變
+    if (link->burst_hist[bucket] == 0xFF) {
+        for (uint8_t i = 0; i < LINK_BURST_BUCKETS; i++) link->burst_hist[i] >>= 1;
+    }
+    link->burst_hist[bucket]++;
+    link->burst_count++;
+    if (length > link->gap_max) link->gap_max = length;
+}
+
+// 連續序號的到達間隔：最小 / 最大值與相鄰間隔差的 EWMA
+static void link_record_arrival(LinkStats* link, uint32_t t_us) {
+    uint32_t elapsed = t_us - link->last_arrival_us;
+    uint16_t iat = (elapsed > 0xFFFF) ? 0xFFFF : (uint16_t)elapsed;
+    if (iat < link->iat_min_us) link->iat_min_us = iat;
+    if (iat > link->iat_max_us) link->iat_max_us = iat;
+
+    if (link->last_iat_us != 0) {
+        uint16_t diff = (iat > link->last_iat_us) ? iat - link->last_iat_us : link->last_iat_us - iat;
+        if (diff > 0x0FFF) diff = 0x0FFF;  // × 16 後仍在 uint16 內
+        // J += (|D| - J) / 16，以 ×16 定點保存
+        link->jitter_x16 = (uint16_t)(link->jitter_x16 + diff - (link->jitter_x16 >> 4));
+    }
+    link->last_iat_us = iat;
+}
+
+// Gilbert-Elliott 轉移機率（千分比）
+static uint16_t link_ratio_permille(uint32_t bursts, uint32_t total) {
+    if (total == 0) return 0;
+    return (uint16_t)((bursts * 1000ULL + total / 2) / total);
+}
 
 void stats_init(Stats* stats) {
     stats->packets_received = 0;
     stats->packets_lost = 0;
-    stats->last_seq = 0;
+    stats->packets_duplicate = 0;
+    stats->packets_late = 0;
+    stats->seq_highest = 0;
+    stats->seq_window = 0;
+    stats->remote_ms_highest = 0;
     stats->seq_initialized = false;
     stats->rate_start_time = millis();
     stats->rate_packet_count = 0;
-    stats->packets_per_sec = 0.0f;
+    stats->pps_x10 = 0;
+    memset(&stats->link, 0, sizeof(LinkStats));
+    stats->link.iat_min_us = 0xFFFF;
+    if (stats->health_slot != 0) health_slots[stats->health_slot - 1].valid = false;
+    stats->health_slot = 0;
 }
 
-void stats_update(Stats* stats, uint16_t current_seq) {
-    stats->packets_received++;
-    stats->rate_packet_count++;
+// 序號倒退（或相同）的封包是否為同一次開機較早的樣本：
+// 比最大序號封包晚到的時間 = 到達時間差 + 遠距端採樣時間差，重複 / 晚到封包只差硬體重傳的時間；
+// 遠距端重啟後時間戳從 0 開始，算出的差至少是重啟前的運行時間
+static bool seq_same_boot(const Stats* stats, uint32_t remote_ms, uint32_t t_us) {
+    int32_t sample_gap_ms = (int32_t)(stats->remote_ms_highest - remote_ms);
+    if (sample_gap_ms < 0 || sample_gap_ms > (int32_t)(SEQ_LATE_MAX_US / 1000)) return false;
+    uint32_t lag_us = (t_us - stats->link.last_arrival_us) + (uint32_t)sample_gap_ms * 1000UL;
+    return lag_us <= SEQ_LATE_MAX_US;
+}
+
+// 重新同步到 current_seq（第一筆或遠距端重啟）
+static void seq_resync(Stats* stats, uint16_t current_seq, uint32_t remote_ms, uint32_t t_us) {
+    stats->seq_highest = current_seq;
+    stats->seq_window = 1;
+    stats->remote_ms_highest = remote_ms;
+    stats->link.last_arrival_us = t_us;
+    stats->link.last_iat_us = 0;
+}
+
+SeqClass stats_update(Stats* stats, uint16_t current_seq, uint32_t remote_ms, uint32_t t_us) {
+    LinkStats* link = &stats->link;
 
     if (!stats->seq_initialized) {
         // 第一個封包，初始化序號
         stats->seq_initialized = true;
-    } else {
-        // 檢查掉包
-        uint16_t expected = stats->last_seq + 1;
-        if (current_seq != expected) {
-            // 計算掉失數量（處理 uint16 溢位）
-            uint16_t lost;
-            if (current_seq > expected) {
-                // 正常情況：current > expected
-                lost = current_seq - expected;
+        seq_resync(stats, current_seq, remote_ms, t_us);
+        stats->packets_received++;
+        stats->rate_packet_count++;
+        return SEQ_NEW;
+    }
+
+    // 與最大序號的距離（uint16 溢位後仍正確）
+    int16_t delta = (int16_t)(current_seq - stats->seq_highest);
+    SeqClass cls;
+
+    if (delta > 0) {
+        // 前進：遠距端時間戳倒退，或跳號多於經過時間內可能送出的數量，即為重啟
+        uint32_t elapsed_us = t_us - link->last_arrival_us;
+        uint32_t advance_max = (elapsed_us >> SEQ_ADVANCE_SHIFT) + SEQ_WINDOW;
+        if ((int32_t)(remote_ms - stats->remote_ms_highest) < 0 || (uint16_t)delta > advance_max) {
+            seq_resync(stats, current_seq, remote_ms, t_us);
+            cls = SEQ_RESET;
+        } else {
+            // 中間跳過的序號先記為掉包，晚到時再扣回
+            stats->packets_lost += (uint16_t)(delta - 1);
+            stats->seq_window = (delta < SEQ_WINDOW) ? (stats->seq_window << delta) | 1 : 1;
+            stats->seq_highest = current_seq;
+            stats->remote_ms_highest = remote_ms;
+            if (delta == 1) {
+                link_record_arrival(link, t_us);
+                cls = SEQ_NEW;
             } else {
-                // 溢位情況：expected 溢位或 current 較小
-                // 使用模運算處理：(current - expected) mod 65536
-                lost = (uint16_t)(current_seq - expected);
+                link_record_burst(link, (uint16_t)(delta - 1));
+                link->last_iat_us = 0;
+                cls = SEQ_GAP;
             }
-            stats->packets_lost += lost;
+            link->last_arrival_us = t_us;
+        }
+    } else if (!seq_same_boot(stats, remote_ms, t_us)) {
+        // 倒退但不是重傳能解釋的延遲：遠距端重啟（序號從頭開始，可能仍落在視窗內）
+        seq_resync(stats, current_seq, remote_ms, t_us);
+        cls = SEQ_RESET;
+    } else if (delta > -SEQ_WINDOW) {
+        uint32_t bit = 1UL << (uint8_t)(-delta);
+        if (stats->seq_window & bit) {
+            stats->packets_duplicate++;
+            return SEQ_DUPLICATE;
         }
+        stats->seq_window |= bit;
+        if (stats->packets_lost > 0) stats->packets_lost--;
+        stats->packets_late++;
+        cls = SEQ_LATE;
+    } else {
+        // 視窗外的舊封包：無法判斷是否重複，照樣輸出；最大序號不倒退，掉包不扣回
+        stats->packets_late++;
+        cls = SEQ_LATE;
     }
 
-    stats->last_seq = current_seq;
+    stats->packets_received++;
+    stats->rate_packet_count++;
+    return cls;
+}
+
+void stats_update_health(Stats* stats, const HealthPacket* health) {
+    if (stats->health_slot == 0) {
+        for (uint8_t i = 0; i < STATS_HEALTH_SLOTS && stats->health_slot == 0; i++) {
+            if (!health_slots[i].valid) stats->health_slot = (uint8_t)(i + 1);
+        }
+        if (stats->health_slot == 0) return;   // 槽位用完
+    }
+    RemoteHealth* r = &health_slots[stats->health_slot - 1];
+    r->valid = true;
+    r->status = health->status;
+    r->seq_epoch = health->seq_epoch;
+    r->uptime_ms = health->uptime_ms;
+    r->retransmits = health->retransmits;
+    r->tx_fail = health->tx_fail;
+    r->rf_reinit = health->rf_reinit;
+    r->i2c_err[0] = health->i2c_err1;
+    r->i2c_err[1] = health->i2c_err2;
+    r->overruns = health->overruns;
+    r->bus_recoveries = health->bus_recoveries;
 }
 
 void stats_update_rate(Stats* stats) {
@@ -44,27 +172,153 @@ void stats_update_rate(Stats* stats) {
     unsigned long elapsed = now - stats->rate_start_time;
 
     if (elapsed >= 1000) {  // 至少 1 秒
-        stats->packets_per_sec = (float)stats->rate_packet_count * 1000.0f / elapsed;
+        stats->pps_x10 = (uint16_t)((stats->rate_packet_count * 10000UL + elapsed / 2) / elapsed);
         stats->rate_packet_count = 0;
         stats->rate_start_time = now;
     }
 }
 
-float stats_get_loss_rate(const Stats* stats) {
+const RemoteHealth* stats_health(const Stats* stats) {
+    return stats->health_slot != 0 ? &health_slots[stats->health_slot - 1] : 0;
+}
+
+bool stats_active(const Stats* stats) {
+    return stats->seq_initialized || stats->health_slot != 0;
+}
+
+void stats_update_base(BaseStats* base) {
+    UartStats tx;
+    uart_get_stats(&tx);
+    base->tx_records_dropped = tx.records_dropped;
+    base->tx_bytes_dropped = tx.bytes_dropped;
+    base->tx_high_water = tx.high_water;
+    base->rx_overflow = rf_get_rx_overflow();
+}
+
+uint16_t stats_get_loss_permille(const Stats* stats) {
     uint32_t total = stats->packets_received + stats->packets_lost;
-    if (total == 0) return 0.0f;
-    return (float)stats->packets_lost / total;
+    if (total == 0) return 0;
+    return (uint16_t)((stats->packets_lost * 1000ULL + total / 2) / total);
 }
 
-void stats_print(const Stats* stats) {
+void stats_print_pps(const Stats* stats, uint8_t pipe) {
+    TextLine line;
+
     // 統計行以 # 開頭，讓解析器忽略
-    Serial.print(F("#pps="));
-    Serial.print(stats->packets_per_sec, 1);
-    Serial.print(F(",dropped="));
-    Serial.print(stats->packets_lost);
-    Serial.print(F(",rx="));
-    Serial.print(stats->packets_received);
-    Serial.print(F(",loss="));
-    Serial.print(stats_get_loss_rate(stats) * 100.0f, 1);
-    Serial.println(F("%"));
+    line_init(&line);
+    line_put_str(&line, "#pps=");
+    line_put_x10(&line, stats->pps_x10);
+    line_put_str(&line, ",dropped=");
+    line_put_u32(&line, stats->packets_lost);
+    line_put_str(&line, ",rx=");
+    line_put_u32(&line, stats->packets_received);
+    line_put_str(&line, ",loss=");
+    line_put_x10(&line, stats_get_loss_permille(stats));
+    line_put_str(&line, "%,pipe=");
+    line_put_u32(&line, pipe);
+    line_put_str(&line, ",dup=");
+    line_put_u32(&line, stats->packets_duplicate);
+    line_put_str(&line, ",late=");
+    line_put_u32(&line, stats->packets_late);
+    line_send(&line);
+}
+
+void stats_print_link(const Stats* stats, uint8_t pipe) {
+    // 鏈路品質（收到第二筆連續封包之後才有間隔）
+    const LinkStats* link = &stats->link;
+    if (link->iat_max_us != 0 || link->burst_count != 0) {
+        TextLine line;
+        line_init(&line);
+        line_put_str(&line, "#link,pipe=");
+        line_put_u32(&line, pipe);
+        line_put_str(&line, ",iat=");
+        line_put_u32(&line, link->iat_max_us ? link->iat_min_us : 0);
+        line_put_char(&line, '/');
+        line_put_u32(&line, link->iat_max_us);
+        line_put_str(&line, ",jit=");
+        line_put_u32(&line, link->jitter_x16 >> 4);
+        line_put_str(&line, ",gap=");
+        line_put_u32(&line, link->gap_max);
+        line_put_str(&line, ",h=");
+        for (uint8_t i = 0; i < LINK_BURST_BUCKETS; i++) {
+            if (i) line_put_char(&line, '/');
+            line_put_u32(&line, link->burst_hist[i]);
+        }
+        line_put_str(&line, ",ge=");
+        line_put_x10(&line, link_ratio_permille(link->burst_count, stats->packets_received));
+        line_put_char(&line, '/');
+        line_put_x10(&line, link_ratio_permille(link->burst_count, stats->packets_lost));
+        line_send(&line);
+    }
+}
+
+void stats_print_health(const Stats* stats, uint8_t pipe) {
+    const RemoteHealth* r = stats_health(stats);
+    if (!r) return;
+    TextLine line;
+    line_init(&line);
+    line_put_str(&line, "#health,pipe=");
+    line_put_u32(&line, pipe);
+    line_put_str(&line, ",status=");
+    line_put_u32(&line, r->status);
+    line_put_str(&line, ",epoch=");
+    line_put_u32(&line, r->seq_epoch);
+    line_put_str(&line, ",up=");
+    line_put_u32(&line, r->uptime_ms);
+    line_put_str(&line, ",retx=");
+    line_put_u32(&line, r->retransmits);
+    line_put_str(&line, ",txfail=");
+    line_put_u32(&line, r->tx_fail);
+    line_put_str(&line, ",reinit=");
+    line_put_u32(&line, r->rf_reinit);
+    line_put_str(&line, ",i2c1=");
+    line_put_u32(&line, r->i2c_err[0]);
+    line_put_str(&line, ",i2c2=");
+    line_put_u32(&line, r->i2c_err[1]);
+    line_put_str(&line, ",overrun=");
+    line_put_u32(&line, r->overruns);
+    line_put_str(&line, ",busrec=");
+    line_put_u32(&line, r->bus_recoveries);
+    line_send(&line);
+}
+
+void stats_print_base(const BaseStats* base) {
+    TextLine line;
+    line_init(&line);
+    line_put_str(&line, "#base,txdrop=");
+    line_put_u32(&line, base->tx_records_dropped);
+    line_put_str(&line, ",txbytes=");
+    line_put_u32(&line, base->tx_bytes_dropped);
+    line_put_str(&line, ",txhw=");
+    line_put_u32(&line, base->tx_high_water);
+    line_put_str(&line, ",rxovf=");
+    line_put_u32(&line, base->rx_overflow);
+    line_send(&line);
+}
+
+void stats_fill_frame(const Stats* stats, StatsFrame* frame) {
+    frame->packets_received = stats->packets_received;
+    frame->packets_lost = stats->packets_lost;
+    frame->pps_x10 = stats->pps_x10;
+    frame->packets_duplicate = (uint16_t)stats->packets_duplicate;
+    frame->packets_late = (uint16_t)stats->packets_late;
+}
+
+void stats_fill_link_frame(const Stats* stats, LinkFrame* frame) {
+    const LinkStats* link = &stats->link;
+    frame->iat_min_us = link->iat_max_us ? link->iat_min_us : 0;
+    frame->iat_max_us = link->iat_max_us;
+    frame->jitter_us = link->jitter_x16 >> 4;
+    frame->gap_max = link->gap_max;
+    frame->burst_count = link->burst_count;
+    for (uint8_t i = 0; i < LINK_BURST_BUCKETS; i++) frame->burst_hist[i] = link->burst_hist[i];
+    frame->ge_p_permille = link_ratio_permille(link->burst_count, stats->packets_received);
+    frame->ge_r_permille = link_ratio_permille(link->burst_count, stats->packets_lost);
+}
+
+void stats_fill_base_frame(const BaseStats* base, BaseStatsFrame* frame) {
+    frame->tx_records_dropped = base->tx_records_dropped;
+    frame->tx_bytes_dropped = base->tx_bytes_dropped;
+    frame->tx_high_water = base->tx_high_water;
+    frame->rx_overflow = base->rx_overflow;
 }
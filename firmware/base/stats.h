@@ -3,34 +3,172 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "../common/packet.h"
+
+// 遠距端健康狀態（最新一筆 HealthPacket）
+// 不放在每個管道的 Stats 內：只配置 STATS_HEALTH_SLOTS 份，依收到健康封包的順序分給遠距端，
+// 超過的遠距端不保存（文字模式不輸出 #health 行；二進位模式健康封包照常原樣轉送）
+#define STATS_HEALTH_SLOTS 2    // 28 bytes / 份（250kbps TDMA 同時約 2 個遠距端）
 
-// 統計數據結構
 typedef struct {
-    uint32_t packets_received;  // 收到封包總數
-    uint32_t packets_lost;      // 掉包總數
-    uint16_t last_seq;          // 上一個序號
+    bool     valid;             // 使用中（已收過健康封包）
+    uint8_t  status;            // HEALTH_STATUS_*
+    uint32_t seq_epoch;         // 序號溢位次數
+    uint32_t uptime_ms;         // 遠距端開機時間
+    uint32_t retransmits;       // 自動重傳總數
+    uint32_t tx_fail;           // 發送失敗總數
+    uint16_t rf_reinit;         // rf_reinit 次數
+    uint16_t i2c_err[2];        // MPU1 / MPU2 I2C 錯誤
+    uint16_t overruns;          // 採樣錯過期限次數
+    uint16_t bus_recoveries;    // I2C 匯流排恢復次數
+} RemoteHealth;
+
+// 序號追蹤視窗（最近 32 個序號各 1 bit）
+#define SEQ_WINDOW 32
+
+// 遠距端不在應用層重送，重複 / 晚到封包只來自硬體自動重傳，比最大序號封包晚到的時間
+// （到達時間差 + 遠距端採樣時間差）不超過此值；超過即為遠距端重啟（時間戳歸零）
+#define SEQ_LATE_MAX_US 100000UL
+
+// 序號前進的合理上限：每 2^SEQ_ADVANCE_SHIFT us 最多 1 個序號（採樣間隔最短 1 ms），另加視窗長度的餘裕
+#define SEQ_ADVANCE_SHIFT 9
+
+// 封包序號分類（stats_update 回傳）
+typedef enum {
+    SEQ_NEW = 0,     // 下一個序號（或第一筆）
+    SEQ_GAP,         // 前進但跳號：中間的序號暫記為掉包
+    SEQ_LATE,        // 先前跳過的序號晚到：視窗內從掉包扣回，視窗外只計數
+    SEQ_DUPLICATE,   // 視窗內已收過（ACK 遺失後的重送），不計入、不輸出
+    SEQ_RESET        // 遠距端重啟（時間戳倒退或序號跳動不合理）：重新同步，不計掉包
+} SeqClass;
+
+// 掉包叢集長度分桶：1, 2, 3-4, 5-8, 9-16, 17+
+#define LINK_BURST_BUCKETS 6
+
+// 鏈路品質（到達間隔抖動、連續掉包分布）
+// 兩狀態 (Gilbert-Elliott) 掉包模型由計數估計：
+//   p = 好→壞 轉移機率 ≈ 叢集數 / 收到封包數
+//   r = 壞→好 轉移機率 ≈ 叢集數 / 掉包數（1/r = 平均叢集長度）
+// 隨機掉包時 r 接近 1；r 遠小於 1 表示掉包成串（FEC 效果有限，應考慮重傳）
+// 叢集在跳號當下記錄，之後晚到補上的封包不回頭修正分布
+// 分布以 uint8 計數，任一桶飽和時全部減半（保留比例；絕對數量看 burst_count）
+// RAM：24 bytes / 管道
+typedef struct {
+    uint32_t last_arrival_us;   // 上一筆感測封包到達時間
+    uint16_t last_iat_us;       // 上一個到達間隔（0 = 無效，跳號後重新開始）
+    uint16_t iat_min_us;        // 到達間隔最小值（只計連續序號）
+    uint16_t iat_max_us;        // 到達間隔最大值
+    uint16_t jitter_x16;        // 相鄰間隔差的 EWMA (us × 16，權重 1/16)
+    uint16_t gap_max;           // 最長連續掉包
+    uint32_t burst_count;       // 掉包叢集數
+    uint8_t  burst_hist[LINK_BURST_BUCKETS];  // 叢集長度分布（相對比例）
+} LinkStats;
+
+// 單一遠距端統計（每個接收管道一份）
+// RAM（AVR）：60 bytes / 管道（序號與計數 36 + LinkStats 24），RF_PIPE_COUNT 份共 360 bytes
+typedef struct {
+    uint32_t packets_received;  // 收到封包總數（不含重複）
+    uint32_t packets_lost;      // 掉包總數（晚到的封包會扣回）
+    uint32_t packets_duplicate; // 重複封包數
+    uint32_t packets_late;      // 晚到 / 亂序封包數
+    uint32_t seq_window;        // bit n = 序號 seq_highest - n 已收到
+    uint32_t remote_ms_highest; // 最大序號封包的遠距端時間戳（判斷遠距端重啟）
+    uint16_t seq_highest;       // 收過的最大序號
     bool     seq_initialized;   // 序號是否已初始化
+    uint8_t  health_slot;       // 健康狀態槽位 + 1（0 = 未配置）
 
     // 速率計算用
     uint32_t rate_start_time;   // 速率計算起始時間
-    uint32_t rate_packet_count; // 該時段封包數
-    float    packets_per_sec;   // 每秒封包數
+    uint16_t rate_packet_count; // 該時段封包數
+    uint16_t pps_x10;           // 每秒封包數 × 10（定點，避免浮點運算）
+
+    LinkStats link;             // 鏈路品質
 } Stats;
 
-// 初始化統計
+#if defined(__AVR__)
+static_assert(sizeof(Stats) == 60, "Stats per-pipe RAM cost changed, update RAM budget (main_base.ino)");
+#endif
+
+// Base 端統計（與遠距端無關）
+typedef struct {
+    // Serial 傳送緩衝丟棄統計（uart.h）
+    uint32_t tx_records_dropped;
+    uint32_t tx_bytes_dropped;
+    uint16_t tx_high_water;
+
+    uint16_t rx_overflow;       // 無線接收緩衝滿而丟棄的封包（rf_receiver.h）
+} BaseStats;
+
+// 二進位統計框架內容 (FRAME_TYPE_STATS，每個遠距端一個，管道號碼在框架類型高 4 位元)
+typedef struct __attribute__((packed)) {
+    uint32_t packets_received;  // 收到封包總數
+    uint32_t packets_lost;      // 掉包總數
+    uint16_t pps_x10;           // 每秒封包數 × 10
+    uint16_t packets_duplicate; // 重複封包數（低 16 位元）
+    uint16_t packets_late;      // 晚到封包數（低 16 位元）
+} StatsFrame;
+
+// 二進位鏈路品質框架內容 (FRAME_TYPE_LINK，管道號碼在框架類型高 4 位元)
+typedef struct __attribute__((packed)) {
+    uint16_t iat_min_us;        // 到達間隔最小值
+    uint16_t iat_max_us;        // 到達間隔最大值
+    uint16_t jitter_us;         // 到達間隔抖動 (EWMA)
+    uint16_t gap_max;           // 最長連續掉包
+    uint32_t burst_count;       // 掉包叢集數
+    uint16_t burst_hist[LINK_BURST_BUCKETS];  // 叢集長度分布
+    uint16_t ge_p_permille;     // Gilbert-Elliott p（千分比）
+    uint16_t ge_r_permille;     // Gilbert-Elliott r（千分比）
+} LinkFrame;
+
+// 二進位 Base 端統計框架內容 (FRAME_TYPE_BASE_STATS)
+typedef struct __attribute__((packed)) {
+    uint32_t tx_records_dropped;// Serial 丟棄記錄數
+    uint32_t tx_bytes_dropped;  // Serial 丟棄位元組數
+    uint16_t tx_high_water;     // 傳送緩衝最高使用量
+    uint16_t rx_overflow;       // 無線接收緩衝丟棄數
+} BaseStatsFrame;
+
+// 初始化統計（釋放該管道的健康狀態槽位）
 void stats_init(Stats* stats);
 
-// 更新統計（每收到一個封包呼叫）
+// 更新統計（每收到一個感測封包呼叫）
 // current_seq: 當前封包的序號
-void stats_update(Stats* stats, uint16_t current_seq);
+// remote_ms: 封包的遠距端時間戳（SensorPacket.timestamp，用於判斷重啟）
+// t_us: 封包到達時間（micros()，用於到達間隔抖動與判斷重啟）
+// 回傳: 序號分類；SEQ_DUPLICATE 的封包呼叫端應丟棄，不輸出
+SeqClass stats_update(Stats* stats, uint16_t current_seq, uint32_t remote_ms, uint32_t t_us);
+
+// 更新遠距端健康狀態（每收到一個健康封包呼叫；第一次呼叫時配置槽位，槽位用完則不保存）
+void stats_update_health(Stats* stats, const HealthPacket* health);
 
-// 更新速率統計（每秒呼叫一次）
+// 遠距端健康狀態
+// 回傳: NULL = 未收過健康封包或沒有槽位
+const RemoteHealth* stats_health(const Stats* stats);
+
+// 更新速率統計（每次 loop 呼叫，速率每秒計算一次）
 void stats_update_rate(Stats* stats);
 
-// 取得掉包率 (0.0 ~ 1.0)
-float stats_get_loss_rate(const Stats* stats);
+// 是否收過此遠距端的任何封包
+bool stats_active(const Stats* stats);
+
+// 讀取 Serial 丟棄與無線接收緩衝統計（輸出前呼叫）
+void stats_update_base(BaseStats* base);
+
+// 取得掉包率（千分比，0 ~ 1000）
+uint16_t stats_get_loss_permille(const Stats* stats);
+
+// 輸出單一遠距端統計到 Serial，每個函式一行（一筆記錄）
+// pipe: 接收管道（遠距端編號）
+void stats_print_pps(const Stats* stats, uint8_t pipe);      // #pps 行
+void stats_print_link(const Stats* stats, uint8_t pipe);     // #link 行（尚無到達間隔或掉包時不輸出）
+void stats_print_health(const Stats* stats, uint8_t pipe);   // #health 行（未收過健康封包時不輸出）
+
+// 輸出 Base 端統計到 Serial（#base 行）
+void stats_print_base(const BaseStats* base);
 
-// 輸出統計到 Serial
-void stats_print(const Stats* stats);
+// 填入二進位統計框架
+void stats_fill_frame(const Stats* stats, StatsFrame* frame);
+void stats_fill_link_frame(const Stats* stats, LinkFrame* frame);
+void stats_fill_base_frame(const BaseStats* base, BaseStatsFrame* frame);
 
 #endif
@@ -0,0 +1,169 @@
+#include "tdma_base.h"
+#include "rf_receiver.h"
+#include <Arduino.h>
+
+// 管道狀態
+typedef struct {
+    uint32_t last_seen_ms;  // 最近一次收到封包
+    int16_t  offset_us;     // 最近一次量測的相位修正
+    uint8_t  tag;           // 被量測封包的序號低位元組
+    uint8_t  slot;          // 指派時槽（0xFF = 未使用）
+} PipeSlot;
+
+static PipeSlot pipes[RF_PIPE_COUNT];
+static uint8_t active_mask = 0;    // 使用中的管道
+static uint8_t pending_mask = 0;   // 已預載 ACK payload 的管道
+static uint8_t pending_count = 0;
+static uint8_t slot_count = 0;
+
+// 遠距端指令
+static RemoteCommand commands[RF_PIPE_COUNT];
+static uint8_t command_mask = 0;   // 有待送指令的管道
+static uint8_t command_sent = 0;   // 指令已預載（下一個封包到達即送達）
+static uint32_t frame_start_us;    // 目前時框起點
+
+// 依管道號碼重新分配時槽
+static void assign_slots(void) {
+    slot_count = 0;
+    for (uint8_t pipe = 0; pipe < RF_PIPE_COUNT; pipe++) {
+        pipes[pipe].slot = (active_mask & (1 << pipe)) ? slot_count++ : 0xFF;
+    }
+}
+
+// 到達時間在時框內的相位 → 與時槽中央的差
+static int16_t measure_offset(uint8_t slot, uint32_t t_us) {
+    int32_t phase = (int32_t)(t_us - frame_start_us);
+    while (phase >= (int32_t)TDMA_FRAME_US) phase -= TDMA_FRAME_US;
+    while (phase < 0) phase += TDMA_FRAME_US;
+
+    uint32_t slot_us = TDMA_FRAME_US / slot_count;
+    int32_t offset = (int32_t)(slot * slot_us + slot_us / 2) - phase;
+    if (offset >= (int32_t)(TDMA_FRAME_US / 2)) offset -= TDMA_FRAME_US;
+    if (offset < -(int32_t)(TDMA_FRAME_US / 2)) offset += TDMA_FRAME_US;
+    return (int16_t)offset;
+}
+
+// 預載 ACK payload：從 after 的下一個時槽開始，補到 TX FIFO 滿為止
+static void fill_ack(uint8_t after) {
+    for (uint8_t i = 1; i <= slot_count && pending_count < TDMA_ACK_DEPTH; i++) {
+        uint8_t slot = (uint8_t)((after + i) % slot_count);
+        for (uint8_t pipe = 0; pipe < RF_PIPE_COUNT; pipe++) {
+            if (pipes[pipe].slot != slot) continue;
+            if (pending_mask & (1 << pipe)) break;
+
+            bool ok;
+            if (command_mask & (1 << pipe)) {
+                ok = rf_write_ack(pipe, &commands[pipe], sizeof(RemoteCommand));
+                if (ok) command_sent |= (1 << pipe);
+            } else {
+                TdmaSync sync;
+                sync.type = TDMA_ACK_SYNC;
+                sync.slot = slot;
+                sync.slot_count = slot_count;
+                sync.tag = pipes[pipe].tag;
+                sync.offset_us = pipes[pipe].offset_us;
+                ok = rf_write_ack(pipe, &sync, sizeof(sync));
+            }
+            if (ok) {
+                pending_mask |= (1 << pipe);
+                pending_count++;
+            }
+            break;
+        }
+    }
+}
+
+void tdma_init(uint32_t now_us) {
+    active_mask = 0;
+    pending_mask = 0;
+    pending_count = 0;
+    command_mask = 0;
+    command_sent = 0;
+    frame_start_us = now_us;
+    assign_slots();
+}
+
+void tdma_on_packet(uint8_t pipe, const RadioPayload* p, uint32_t t_us, uint32_t now_ms) {
+    if (pipe >= RF_PIPE_COUNT) return;
+    PipeSlot* s = &pipes[pipe];
+    s->last_seen_ms = now_ms;
+
+    // 收到封包 = 預載的 ACK payload 已隨 ACK 送出
+    if (pending_mask & (1 << pipe)) {
+        pending_mask &= ~(1 << pipe);
+        pending_count--;
+        if (command_sent & (1 << pipe)) {
+            command_sent &= ~(1 << pipe);
+            command_mask &= ~(1 << pipe);
+        }
+    }
+
+    if (!(active_mask & (1 << pipe))) {
+        active_mask |= (1 << pipe);
+        assign_slots();
+    }
+
+    // 只量測感測封包（每個時框的第一筆），遙測封包的 ACK 沿用同一筆量測
+    if (p->sensor.version == PROTOCOL_VERSION) {
+        s->tag = (uint8_t)p->sensor.seq;
+        s->offset_us = measure_offset(s->slot, t_us);
+    }
+    fill_ack(s->slot);
+}
+
+void tdma_service(uint32_t now_us, uint32_t now_ms) {
+    while (now_us - frame_start_us >= TDMA_FRAME_US) {
+        frame_start_us += TDMA_FRAME_US;
+    }
+
+    uint8_t expired = 0;
+    for (uint8_t pipe = 0; pipe < RF_PIPE_COUNT; pipe++) {
+        if ((active_mask & (1 << pipe)) && now_ms - pipes[pipe].last_seen_ms > TDMA_TIMEOUT_MS) {
+            expired |= (1 << pipe);
+        }
+    }
+    if (expired == 0) return;
+
+    active_mask &= ~expired;
+    command_mask &= ~expired;
+    assign_slots();
+
+    // 離線遠距端的 ACK payload 會一直佔住 TX FIFO：整個清空，由之後的封包重新預載
+    if (pending_mask & expired) {
+        rf_flush_ack();
+        tdma_ack_flushed();
+    }
+}
+
+void tdma_ack_flushed(void) {
+    pending_mask = 0;
+    pending_count = 0;
+    command_sent = 0;   // 未送達的指令重新預載
+}
+
+bool tdma_send_command(uint8_t pipe, uint8_t op, uint16_t arg) {
+    if (pipe >= RF_PIPE_COUNT) return false;
+    // 已預載的舊指令仍會送出；新指令在其後預載
+    commands[pipe].type = REMOTE_CMD_TYPE;
+    commands[pipe].op = op;
+    commands[pipe].arg = arg;
+    command_mask |= (1 << pipe);
+    command_sent &= ~(1 << pipe);
+    return true;
+}
+
+bool tdma_command_pending(void) {
+    return command_mask != 0;
+}
+
+uint8_t tdma_slot_count(void) {
+    return slot_count;
+}
+
+uint8_t tdma_slot_of(uint8_t pipe) {
+    return (pipe < RF_PIPE_COUNT) ? pipes[pipe].slot : 0xFF;
+}
+
+int16_t tdma_offset_of(uint8_t pipe) {
+    return (pipe < RF_PIPE_COUNT) ? pipes[pipe].offset_us : 0;
+}
@@ -0,0 +1,49 @@
+#ifndef TDMA_BASE_H
+#define TDMA_BASE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../common/packet.h"
+#include "../common/tdma.h"
+#include "../common/remote_command.h"
+
+// Base 端 TDMA 時槽分配（協議見 common/tdma.h）
+//
+// - 收過封包的管道依管道號碼由小到大分配時槽，時槽數 = 使用中的遠距端數
+// - 遠距端超過 TDMA_TIMEOUT_MS 未出現即釋放時槽，其餘遠距端重新排列
+// - ACK payload 預載於 nRF24 TX FIFO（最多 3 筆），依下一個將發送的時槽順序補充
+// - ACK payload 統一由本模組管理：待送的遠距端指令優先於時槽同步
+
+#define TDMA_TIMEOUT_MS   500   // 遠距端無封包超過此時間即釋放時槽
+#define TDMA_ACK_DEPTH    3     // nRF24 TX FIFO 深度
+
+// 初始化（時框起點 = now_us）
+void tdma_init(uint32_t now_us);
+
+// 每收到一個封包呼叫（主迴圈）
+// 感測封包量測到達相位；任何封包都表示該管道預載的 ACK payload 已送出
+void tdma_on_packet(uint8_t pipe, const RadioPayload* p, uint32_t t_us, uint32_t now_ms);
+
+// 推進時框、釋放逾時的時槽（每次 loop 呼叫）
+void tdma_service(uint32_t now_us, uint32_t now_ms);
+
+// 排入遠距端指令（每個管道一筆，新指令覆蓋尚未送出的舊指令）
+// 回傳: false = 管道不存在
+bool tdma_send_command(uint8_t pipe, uint8_t op, uint16_t arg);
+
+// 是否還有指令尚未送達
+bool tdma_command_pending(void);
+
+// nRF24 TX FIFO 已被清空（頻道探測等）：之後的封包重新預載 ACK payload
+void tdma_ack_flushed(void);
+
+// 使用中的時槽數
+uint8_t tdma_slot_count(void);
+
+// 管道的時槽（未使用時回傳 0xFF）
+uint8_t tdma_slot_of(uint8_t pipe);
+
+// 管道最近一次量測的到達相位誤差 (us)
+int16_t tdma_offset_of(uint8_t pipe);
+
+#endif
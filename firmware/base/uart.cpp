@@ -0,0 +1,239 @@
+#include "uart.h"
+#include <Arduino.h>
+
+#if (UART_TX_RING_SIZE & (UART_TX_RING_SIZE - 1)) != 0
+#error "UART_TX_RING_SIZE must be a power of two"
+#endif
+
+#if (UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1)) != 0 || UART_RX_RING_SIZE > 256
+#error "UART_RX_RING_SIZE must be a power of two <= 256"
+#endif
+
+#define RING_MASK (UART_TX_RING_SIZE - 1)
+
+// 環形緩衝內容: [len][data...][len][data...]...
+// tail 指向下一個要送出的位元組；傳送中的記錄已取出 len，剩餘 tx_remaining bytes
+static uint8_t ring[UART_TX_RING_SIZE];
+static uint16_t head = 0;
+static volatile uint16_t tail = 0;
+static volatile uint16_t tx_count = 0;      // 已使用位元組（含 len）
+static volatile uint8_t tx_remaining = 0;   // 傳送中記錄的剩餘位元組
+
+static UartStats stats;
+static bool congested = false;
+
+// 接收環形緩衝（中斷寫入 rx_head，主迴圈讀取 rx_tail；其他平台由 Serial 緩衝）
+#if defined(__AVR_ATmega328P__)
+#define RX_MASK (UART_RX_RING_SIZE - 1)
+static uint8_t rx_ring[UART_RX_RING_SIZE];
+static volatile uint8_t rx_head = 0;
+static volatile uint8_t rx_tail = 0;
+#endif
+static volatile uint16_t rx_frame_errors = 0;
+static volatile uint16_t rx_overruns = 0;
+
+#if defined(__AVR_ATmega328P__)
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define uart_lock()    uint8_t sreg_save = SREG; cli()
+#define uart_unlock()  SREG = sreg_save
+#define tx_kick()      (UCSR0B |= _BV(UDRIE0))
+#else
+#define uart_lock()    noInterrupts()
+#define uart_unlock()  interrupts()
+#define tx_kick()
+#endif
+
+// 取出下一個要送出的位元組（中斷內或鎖定狀態下呼叫）
+// 回傳: -1 = 緩衝區已空
+static inline int16_t tx_next_byte(void) {
+    if (tx_remaining == 0) {
+        if (tx_count == 0) return -1;
+        tx_remaining = ring[tail];
+        tail = (tail + 1) & RING_MASK;
+        tx_count--;
+    }
+    uint8_t b = ring[tail];
+    tail = (tail + 1) & RING_MASK;
+    tx_count--;
+    tx_remaining--;
+    return b;
+}
+
+#if defined(__AVR_ATmega328P__)
+ISR(USART_UDRE_vect) {
+    int16_t b = tx_next_byte();
+    if (b < 0) {
+        UCSR0B &= ~_BV(UDRIE0);  // 緩衝區已空，停止中斷
+        return;
+    }
+    UDR0 = (uint8_t)b;
+    UCSR0A = _BV(U2X0) | _BV(TXC0);  // 清除 TXC，uart_tx_idle() 以此判斷最後一個位元組已送出
+}
+
+ISR(USART_RX_vect) {
+    uint8_t status = UCSR0A;  // 必須在讀 UDR0 之前讀取錯誤旗標
+    uint8_t b = UDR0;
+
+    if (status & _BV(FE0)) {
+        rx_frame_errors++;
+        return;
+    }
+    if (status & _BV(DOR0)) rx_overruns++;
+
+    uint8_t next = (rx_head + 1) & RX_MASK;
+    if (next == rx_tail) {
+        rx_overruns++;
+        return;
+    }
+    rx_ring[rx_head] = b;
+    rx_head = next;
+}
+#endif
+
+void uart_init(uint32_t baud) {
+#if defined(__AVR_ATmega328P__)
+    uart_set_baud(baud);
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);  // 8N1
+    UCSR0B = _BV(TXEN0) | _BV(RXEN0) | _BV(RXCIE0);
+#else
+    Serial.begin(baud);
+#endif
+}
+
+void uart_set_baud(uint32_t baud) {
+#if defined(__AVR_ATmega328P__)
+    // 倍速模式，誤差較小（115200 @ 16MHz: -3.5% → 2.1%；500k / 1M / 2M 無誤差）
+    uint16_t ubrr = (uint16_t)((F_CPU / 4 / baud - 1) / 2);
+    UCSR0A = _BV(U2X0) | _BV(TXC0);
+    UBRR0H = (uint8_t)(ubrr >> 8);
+    UBRR0L = (uint8_t)ubrr;
+#else
+    Serial.begin(baud);
+#endif
+}
+
+bool uart_tx_idle(void) {
+    uart_lock();
+    bool empty = (tx_count == 0 && tx_remaining == 0);
+    uart_unlock();
+#if defined(__AVR_ATmega328P__)
+    // UDRIE 關閉 = 中斷已無資料可送；TXC = 移位暫存器最後一個位元組已送出
+    return empty && !(UCSR0B & _BV(UDRIE0)) && (UCSR0A & _BV(TXC0));
+#else
+    return empty;
+#endif
+}
+
+int16_t uart_read(void) {
+#if defined(__AVR_ATmega328P__)
+    if (rx_tail == rx_head) return -1;
+    uint8_t b = rx_ring[rx_tail];
+    rx_tail = (rx_tail + 1) & RX_MASK;
+    return b;
+#else
+    return Serial.available() > 0 ? (int16_t)Serial.read() : -1;
+#endif
+}
+
+uint16_t uart_rx_frame_errors(void) {
+    uart_lock();
+    uint16_t n = rx_frame_errors;
+    uart_unlock();
+    return n;
+}
+
+// 丟棄最舊的未送出記錄（鎖定狀態下呼叫）
+// 傳送中記錄的剩餘部分往後搬移，覆蓋被丟棄的記錄
+static bool drop_oldest_record(void) {
+    uint8_t rem = tx_remaining;
+    if (tx_count <= rem) return false;
+
+    uint16_t first = (tail + rem) & RING_MASK;
+    uint16_t drop = (uint16_t)ring[first] + 1;
+    for (uint8_t i = rem; i-- > 0;) {
+        ring[(tail + drop + i) & RING_MASK] = ring[(tail + i) & RING_MASK];
+    }
+    tail = (tail + drop) & RING_MASK;
+    tx_count -= drop;
+
+    stats.records_dropped++;
+    stats.bytes_dropped += drop - 1;
+    return true;
+}
+
+bool uart_write_record(const uint8_t* data, uint8_t len) {
+    if (len == 0) return true;
+
+    uint16_t need = (uint16_t)len + 1;
+    uint16_t used;
+    {
+        uart_lock();
+#if UART_OVERFLOW_POLICY == UART_OVERFLOW_DROP_OLDEST
+        if (len <= UART_RECORD_MAX) {
+            while (UART_TX_RING_SIZE - tx_count < need && drop_oldest_record()) {}
+        }
+#endif
+        used = tx_count;
+        uart_unlock();
+    }
+
+    if (len > UART_RECORD_MAX || UART_TX_RING_SIZE - used < need) {
+        stats.records_dropped++;
+        stats.bytes_dropped += len;
+        congested = true;
+        return false;
+    }
+
+    // head 之後的空間只有這裡會寫入，中斷只讀取已發布的部分，可在開中斷下複製
+    uint16_t pos = head;
+    ring[pos] = len;
+    for (uint8_t i = 0; i < len; i++) {
+        pos = (pos + 1) & RING_MASK;
+        ring[pos] = data[i];
+    }
+
+    {
+        uart_lock();
+        head = (pos + 1) & RING_MASK;
+        tx_count += need;
+        if (tx_count > stats.high_water) stats.high_water = tx_count;
+        tx_kick();
+        uart_unlock();
+    }
+    return true;
+}
+
+uint16_t uart_tx_free(void) {
+    uart_lock();
+    uint16_t used = tx_count;
+    uart_unlock();
+    return UART_TX_RING_SIZE - used;
+}
+
+bool uart_congested(void) {
+    return congested;
+}
+
+void uart_clear_congestion(void) {
+    congested = false;
+}
+
+void uart_get_stats(UartStats* out) {
+    uart_lock();
+    *out = stats;
+    out->rx_frame_errors = rx_frame_errors;
+    out->rx_overruns = rx_overruns;
+    uart_unlock();
+}
+
+void uart_poll(void) {
+#if !defined(__AVR_ATmega328P__)
+    while (Serial.availableForWrite() > 0) {
+        int16_t b = tx_next_byte();
+        if (b < 0) break;
+        Serial.write((uint8_t)b);
+    }
+#endif
+}
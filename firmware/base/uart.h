@@ -0,0 +1,67 @@
+#ifndef UART_H
+#define UART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 中斷驅動 Serial 收發（取代 HardwareSerial）
+//
+// 輸出以「記錄」為單位（一行 CSV / 一個框架）整筆放入傳送環形緩衝區，由 UDRE 中斷送出；
+// 緩衝區不足時依 UART_OVERFLOW_POLICY 丟棄整筆記錄，不阻塞 loop()，
+// 主機端不會收到半行或半個框架。
+//
+// ATmega328P 直接操作 USART0 暫存器（不連結 HardwareSerial，省下其 128 bytes 緩衝）；
+// 其他平台退回 Serial.write，由 uart_poll() 搬移資料。
+
+#define UART_TX_RING_SIZE   256   // 傳送緩衝 (bytes)，須為 2 的冪次（115200 baud 約 22 ms）
+#define UART_RECORD_MAX     120   // 單筆記錄上限
+#define UART_RX_RING_SIZE   32    // 接收緩衝 (bytes)，須為 2 的冪次（主機指令用，每次 loop() 取出）
+
+// 緩衝區滿時的處理方式
+#define UART_OVERFLOW_DROP_NEWEST  0  // 丟棄新記錄
+#define UART_OVERFLOW_DROP_OLDEST  1  // 丟棄最舊的未送出記錄，保留最新資料
+#define UART_OVERFLOW_SUMMARY      2  // 丟棄新記錄並標示壅塞，由呼叫端改送摘要行
+#define UART_OVERFLOW_POLICY       UART_OVERFLOW_DROP_OLDEST
+
+typedef struct {
+    uint32_t records_dropped;   // 丟棄記錄數
+    uint32_t bytes_dropped;     // 丟棄位元組數
+    uint16_t high_water;        // 緩衝區最高使用量
+    uint16_t rx_frame_errors;   // 接收 framing error（鮑率不符）
+    uint16_t rx_overruns;       // 接收緩衝溢位
+} UartStats;
+
+// 初始化 (8N1)
+void uart_init(uint32_t baud);
+
+// 變更鮑率（呼叫前以 uart_tx_idle() 確認已送完，否則傳送中的位元組會亂碼）
+void uart_set_baud(uint32_t baud);
+
+// 傳送緩衝已空且最後一個位元組已移出
+bool uart_tx_idle(void);
+
+// 讀取一個接收位元組
+// 回傳: -1 = 無資料
+int16_t uart_read(void);
+
+// 累計接收 framing error 次數
+uint16_t uart_rx_frame_errors(void);
+
+// 寫入一筆記錄（整筆放入或整筆丟棄）
+// 回傳: true=已放入, false=記錄被丟棄
+bool uart_write_record(const uint8_t* data, uint8_t len);
+
+// 傳送緩衝剩餘空間 (bytes)
+uint16_t uart_tx_free(void);
+
+// 是否發生過丟棄（UART_OVERFLOW_SUMMARY 用，由 uart_clear_congestion() 清除）
+bool uart_congested(void);
+void uart_clear_congestion(void);
+
+// 取得丟棄統計
+void uart_get_stats(UartStats* stats);
+
+// 非 AVR 平台：將緩衝內容搬到 Serial（每次 loop() 呼叫；AVR 上為空函式）
+void uart_poll(void);
+
+#endif
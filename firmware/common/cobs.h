@@ -0,0 +1,59 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <stdint.h>
+
+// COBS (Consistent Overhead Byte Stuffing)
+//
+// 編碼後資料不含 0x00，以 0x00 作為框架分隔符；接收端遇到 0x00 即可重新同步。
+// 長度 ≤ 254 的資料只多 1 byte。
+
+// 編碼所需的最大輸出長度（不含分隔符）
+#define COBS_MAX_ENCODED(len) ((len) + (len) / 254 + 1)
+
+// 編碼
+// dst 長度至少 COBS_MAX_ENCODED(len)
+// 回傳: 編碼長度（不含 0x00 分隔符）
+static inline uint16_t cobs_encode(const uint8_t* src, uint16_t len, uint8_t* dst) {
+    uint16_t code_pos = 0;
+    uint16_t out = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            dst[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        } else {
+            dst[out++] = src[i];
+            if (++code == 0xFF) {
+                dst[code_pos] = code;
+                code_pos = out++;
+                code = 1;
+            }
+        }
+    }
+    dst[code_pos] = code;
+    return out;
+}
+
+// 解碼（輸入不含 0x00 分隔符）
+// dst 長度至少 len
+// 回傳: 解碼長度，格式錯誤時回傳 0
+static inline uint16_t cobs_decode(const uint8_t* src, uint16_t len, uint8_t* dst) {
+    uint16_t in = 0;
+    uint16_t out = 0;
+
+    while (in < len) {
+        uint8_t code = src[in++];
+        if (code == 0 || in + code - 1 > len) return 0;
+        for (uint8_t i = 1; i < code; i++) {
+            if (src[in] == 0) return 0;
+            dst[out++] = src[in++];
+        }
+        if (code != 0xFF && in < len) dst[out++] = 0;
+    }
+    return out;
+}
+
+#endif // COBS_H
@@ -0,0 +1,30 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+
+// CRC-16/CCITT-FALSE（多項式 0x1021，初值 0xFFFF）
+//
+// 用於 EEPROM 組態與序列框架校驗，逐位元計算不需查表（省 512 bytes flash）。
+// 檢查值：crc16("123456789", 9) == 0x29B1
+
+#define CRC16_INIT 0xFFFF
+
+static inline uint16_t crc16_update(uint16_t crc, uint8_t data) {
+    crc ^= (uint16_t)data << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static inline uint16_t crc16(const void* data, uint16_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint16_t crc = CRC16_INIT;
+    while (len--) {
+        crc = crc16_update(crc, *p++);
+    }
+    return crc;
+}
+
+#endif // CRC_H
@@ -0,0 +1,112 @@
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <stdint.h>
+
+// 編譯期 GPIO 存取層（取代熱路徑上的 digitalRead/digitalWrite）
+//
+// 腳位以模板參數指定，埠暫存器與位元遮罩在編譯期決定：
+//   ATmega328P (Uno / Nano):
+//     D0-D7   → PORTD bit 0-7
+//     D8-D13  → PORTB bit 0-5
+//     D14-D19 → PORTC bit 0-5 (A0-A5)
+//   讀/寫/切換皆可編譯為單一 sbic / sbi / cbi / out 指令
+//
+// 後端選擇：
+//   __AVR_ATmega328P__ → 直接操作埠暫存器
+//   其他 Arduino 板    → 退回 digitalRead/digitalWrite（行為相同，僅較慢）
+//   主機端（非 ARDUINO）→ 以 fast_gpio_host_pins() 陣列模擬腳位電位，供測試使用
+//
+// 用法:
+//   typedef FastGpio<LED_PIN> LedGpio;
+//   LedGpio::set_output();
+//   LedGpio::high();
+
+#define FAST_GPIO_PIN_COUNT 20
+
+// 腳位 → 埠內位元編號
+constexpr uint8_t fast_gpio_bit(uint8_t pin) {
+    return pin < 8 ? pin : (pin < 14 ? (uint8_t)(pin - 8) : (uint8_t)(pin - 14));
+}
+
+// 腳位 → 埠內位元遮罩
+constexpr uint8_t fast_gpio_mask(uint8_t pin) {
+    return (uint8_t)(1u << fast_gpio_bit(pin));
+}
+
+#if defined(__AVR_ATmega328P__)
+
+#include <avr/io.h>
+
+template <uint8_t PIN>
+struct FastGpio {
+    static_assert(PIN < FAST_GPIO_PIN_COUNT, "ATmega328P only has D0-D19");
+
+    static inline volatile uint8_t& ddr()  { return PIN < 8 ? DDRD  : (PIN < 14 ? DDRB  : DDRC);  }
+    static inline volatile uint8_t& port() { return PIN < 8 ? PORTD : (PIN < 14 ? PORTB : PORTC); }
+    static inline volatile uint8_t& pin()  { return PIN < 8 ? PIND  : (PIN < 14 ? PINB  : PINC);  }
+
+    static inline void set_output(void)       { ddr() |= fast_gpio_mask(PIN); }
+    static inline void set_input(void)        { ddr() &= (uint8_t)~fast_gpio_mask(PIN); port() &= (uint8_t)~fast_gpio_mask(PIN); }
+    static inline void set_input_pullup(void) { ddr() &= (uint8_t)~fast_gpio_mask(PIN); port() |= fast_gpio_mask(PIN); }
+
+    static inline void high(void)   { port() |= fast_gpio_mask(PIN); }
+    static inline void low(void)    { port() &= (uint8_t)~fast_gpio_mask(PIN); }
+    // 寫 1 到 PINx 會切換輸出（ATmega328P 特性）
+    static inline void toggle(void) { pin() = fast_gpio_mask(PIN); }
+    static inline void write(bool level) { if (level) high(); else low(); }
+
+    static inline bool read(void) { return (pin() & fast_gpio_mask(PIN)) != 0; }
+};
+
+#elif defined(ARDUINO)
+
+#include <Arduino.h>
+
+template <uint8_t PIN>
+struct FastGpio {
+    static inline void set_output(void)       { pinMode(PIN, OUTPUT); }
+    static inline void set_input(void)        { pinMode(PIN, INPUT); }
+    static inline void set_input_pullup(void) { pinMode(PIN, INPUT_PULLUP); }
+
+    static inline void high(void)   { digitalWrite(PIN, HIGH); }
+    static inline void low(void)    { digitalWrite(PIN, LOW); }
+    static inline void toggle(void) { digitalWrite(PIN, !digitalRead(PIN)); }
+    static inline void write(bool level) { digitalWrite(PIN, level ? HIGH : LOW); }
+
+    static inline bool read(void) { return digitalRead(PIN) == HIGH; }
+};
+
+#else
+
+// 主機端模擬：每個腳位一個電位 (0/1) 與方向 (0=輸入, 1=輸出)
+inline uint8_t* fast_gpio_host_pins(void) {
+    static uint8_t pins[FAST_GPIO_PIN_COUNT];
+    return pins;
+}
+
+inline uint8_t* fast_gpio_host_modes(void) {
+    static uint8_t modes[FAST_GPIO_PIN_COUNT];
+    return modes;
+}
+
+template <uint8_t PIN>
+struct FastGpio {
+    static_assert(PIN < FAST_GPIO_PIN_COUNT, "host backend only models D0-D19");
+
+    static inline void set_output(void)       { fast_gpio_host_modes()[PIN] = 1; }
+    static inline void set_input(void)        { fast_gpio_host_modes()[PIN] = 0; }
+    // 上拉：未被外部拉低時讀值為 HIGH
+    static inline void set_input_pullup(void) { fast_gpio_host_modes()[PIN] = 0; fast_gpio_host_pins()[PIN] = 1; }
+
+    static inline void high(void)   { fast_gpio_host_pins()[PIN] = 1; }
+    static inline void low(void)    { fast_gpio_host_pins()[PIN] = 0; }
+    static inline void toggle(void) { fast_gpio_host_pins()[PIN] ^= 1; }
+    static inline void write(bool level) { fast_gpio_host_pins()[PIN] = level ? 1 : 0; }
+
+    static inline bool read(void) { return fast_gpio_host_pins()[PIN] != 0; }
+};
+
+#endif
+
+#endif // FAST_GPIO_H
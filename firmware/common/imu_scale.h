@@ -0,0 +1,49 @@
+#ifndef IMU_SCALE_H
+#define IMU_SCALE_H
+
+#include <stdint.h>
+
+// MPU6050 量程與比例尺（韌體與主機端共用的唯一來源）
+//
+// 本檔不依賴 Arduino，主機端 C++ 可直接 include。
+// Python 端對應表在 backend/config.py，由 backend/tests/test_imu_scale.py 檢查一致。
+
+// 陀螺儀量程代碼（GYRO_CONFIG 暫存器 FS_SEL 欄位）
+#define IMU_GYRO_250DPS   0
+#define IMU_GYRO_500DPS   1
+#define IMU_GYRO_1000DPS  2
+#define IMU_GYRO_2000DPS  3
+
+// 加速度量程代碼（ACCEL_CONFIG 暫存器 AFS_SEL 欄位）
+#define IMU_ACCEL_2G   0
+#define IMU_ACCEL_4G   1
+#define IMU_ACCEL_8G   2
+#define IMU_ACCEL_16G  3
+
+// 數位低通濾波頻寬（CONFIG 暫存器 DLPF_CFG 欄位，加速度計頻寬）
+#define IMU_DLPF_260HZ  0
+#define IMU_DLPF_184HZ  1
+#define IMU_DLPF_94HZ   2
+#define IMU_DLPF_44HZ   3
+#define IMU_DLPF_21HZ   4
+#define IMU_DLPF_10HZ   5
+#define IMU_DLPF_5HZ    6
+
+// 量程代碼 → LSB 靈敏度
+static constexpr float IMU_ACCEL_LSB_PER_G[4]   = { 16384.0f, 8192.0f, 4096.0f, 2048.0f };
+static constexpr float IMU_GYRO_LSB_PER_DPS[4]  = { 131.0f, 65.5f, 32.8f, 16.4f };
+
+constexpr float imu_accel_lsb_per_g(uint8_t range) {
+    return IMU_ACCEL_LSB_PER_G[range];
+}
+
+constexpr float imu_gyro_lsb_per_dps(uint8_t range) {
+    return IMU_GYRO_LSB_PER_DPS[range];
+}
+
+// 量程代碼 → 暫存器值（FS_SEL / AFS_SEL 位於 bit 4:3）
+constexpr uint8_t imu_range_reg(uint8_t range) {
+    return (uint8_t)(range << 3);
+}
+
+#endif // IMU_SCALE_H
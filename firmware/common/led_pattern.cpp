@@ -0,0 +1,22 @@
+#include "led_pattern.h"
+
+// 樣式表只在這裡定義一份（放在 flash，不佔 SRAM）
+// 各韌體草稿碼目錄以 led_pattern.cpp 引入本檔（Arduino IDE 只編譯草稿碼目錄內的 .cpp）
+
+// 閃爍碼時序與舊 error_blink() 相同：亮 200 / 滅 200，最後停頓 1000
+static const uint16_t LED_STEPS_ON[]        PROGMEM = { 1000 };
+static const uint16_t LED_STEPS_BLINK_1[]   PROGMEM = { 200, 1200 };
+static const uint16_t LED_STEPS_BLINK_2[]   PROGMEM = { 200, 200, 200, 1200 };
+static const uint16_t LED_STEPS_BLINK_3[]   PROGMEM = { 200, 200, 200, 200, 200, 1200 };
+static const uint16_t LED_STEPS_FAST[]      PROGMEM = { 100, 100 };
+static const uint16_t LED_STEPS_HEARTBEAT[] PROGMEM = { 50, 1950 };
+
+const LedPatternDef LED_PATTERNS[LED_PATTERN_COUNT] PROGMEM = {
+    { 0, 0 },
+    { LED_STEPS_ON,        1 },
+    { LED_STEPS_BLINK_1,   2 },
+    { LED_STEPS_BLINK_2,   4 },
+    { LED_STEPS_BLINK_3,   6 },
+    { LED_STEPS_FAST,      2 },
+    { LED_STEPS_HEARTBEAT, 2 },
+};
@@ -0,0 +1,95 @@
+#ifndef LED_PATTERN_H
+#define LED_PATTERN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 非阻塞 LED 閃爍樣式引擎（遠距端與桌面端共用）
+//
+// 樣式為「亮/滅」時段表（ms），第一段為亮，播完循環。
+// 由主迴圈或計時任務呼叫 led_pattern_update() 推進，不使用 delay()，
+// 顯示錯誤碼期間採樣與無線工作照常進行。
+//
+// 用法:
+//   static LedPattern led;
+//   led_pattern_init(&led, LED_PATTERN_OFF, millis());
+//   led_pattern_set(&led, LED_PATTERN_BLINK_2, millis());   // 樣式改變時才重新開始
+//   LedGpio::write(led_pattern_update(&led, millis()));
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define led_pattern_read(p)      pgm_read_word(p)
+#define led_pattern_read_byte(p) pgm_read_byte(p)
+#define led_pattern_read_ptr(p)  ((const uint16_t*)pgm_read_ptr(p))
+#else
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define led_pattern_read(p)      (*(p))
+#define led_pattern_read_byte(p) (*(p))
+#define led_pattern_read_ptr(p)  (*(p))
+#endif
+
+// 樣式 ID
+#define LED_PATTERN_OFF        0   // 常滅
+#define LED_PATTERN_ON         1   // 常亮
+#define LED_PATTERN_BLINK_1    2   // 1 閃 + 停頓
+#define LED_PATTERN_BLINK_2    3   // 2 閃 + 停頓
+#define LED_PATTERN_BLINK_3    4   // 3 閃 + 停頓
+#define LED_PATTERN_FAST       5   // 快閃 (5 Hz)
+#define LED_PATTERN_HEARTBEAT  6   // 短亮長滅
+#define LED_PATTERN_COUNT      7
+
+typedef struct {
+    const uint16_t* steps;  // 時段表 (PROGMEM)，時段不可為 0
+    uint8_t count;          // 時段數 (0 = 常滅)
+} LedPatternDef;
+
+// 樣式表 (PROGMEM，定義於 led_pattern.cpp)
+extern const LedPatternDef LED_PATTERNS[LED_PATTERN_COUNT] PROGMEM;
+
+// 播放狀態
+typedef struct {
+    uint8_t  pattern;        // 目前樣式
+    uint8_t  step;           // 目前時段
+    uint32_t step_start_ms;  // 目前時段開始時間
+} LedPattern;
+
+static inline void led_pattern_init(LedPattern* led, uint8_t pattern, uint32_t now_ms) {
+    led->pattern = (pattern < LED_PATTERN_COUNT) ? pattern : LED_PATTERN_OFF;
+    led->step = 0;
+    led->step_start_ms = now_ms;
+}
+
+// 切換樣式（與目前相同時不打斷播放）
+static inline void led_pattern_set(LedPattern* led, uint8_t pattern, uint32_t now_ms) {
+    if (pattern != led->pattern) {
+        led_pattern_init(led, pattern, now_ms);
+    }
+}
+
+// 推進播放並回傳 LED 電位（true = 亮）
+static inline bool led_pattern_update(LedPattern* led, uint32_t now_ms) {
+    const LedPatternDef* def = &LED_PATTERNS[led->pattern];
+    uint8_t count = led_pattern_read_byte(&def->count);
+    if (count == 0) return false;
+    const uint16_t* steps = led_pattern_read_ptr(&def->steps);
+
+    // 長時間未更新時直接重新開始，避免逐段追趕
+    if (now_ms - led->step_start_ms > 0xFFFFUL) {
+        led->step = 0;
+        led->step_start_ms = now_ms;
+    }
+
+    uint16_t duration = led_pattern_read(&steps[led->step]);
+    while (now_ms - led->step_start_ms >= duration) {
+        led->step_start_ms += duration;
+        led->step = (uint8_t)(led->step + 1);
+        if (led->step >= count) led->step = 0;
+        duration = led_pattern_read(&steps[led->step]);
+    }
+
+    return (led->step & 1) == 0;
+}
+
+#endif // LED_PATTERN_H
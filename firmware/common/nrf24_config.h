@@ -0,0 +1,17 @@
+#ifndef NRF24_CONFIG_H
+#define NRF24_CONFIG_H
+
+// nRF24L01+ 空中參數（遠距端與桌面端共用）
+//
+// 兩端的頻道、速率、CRC 長度、payload 長度與 ACK payload (TDMA) 設定不一致時，
+// 封包完全收不到，也沒有任何錯誤回報；所以只在這裡定義一次，兩端都由此取用。
+// 巨集展開為 RF24 列舉值，使用端須自行 #include <RF24.h>。
+
+#define RF_CHANNEL      76              // 預設頻道 0-125（執行期可由 !C 切換）
+#define RF_DATARATE     RF24_250KBPS    // 資料速率
+#define RF_PA_LEVEL     RF24_PA_LOW     // 發射功率（兩端各自的發射功率，不影響相容性）
+#define RF_CRC_LENGTH   RF24_CRC_16     // 空中封包 CRC
+#define RF_PAYLOAD_SIZE 32              // 固定 payload 長度（= PACKET_SIZE）
+#define RF_TDMA         1               // 1 = 以 ACK payload 分配 TDMA 時槽（協議見 common/tdma.h）
+
+#endif // NRF24_CONFIG_H
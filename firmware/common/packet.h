@@ -3,15 +3,20 @@
 
 #include <stdint.h>
 
-#define PROTOCOL_VERSION 0x01
+#define PROTOCOL_VERSION 0x02
 #define PACKET_SIZE 32
 
+// flags 位元定義
+#define PACKET_FLAG_BUTTON      0x01  // 按鈕按下
+#define PACKET_FLAG_MPU1_VALID  0x40  // mpu1_* 欄位有效（無效時填 0）
+#define PACKET_FLAG_MPU2_VALID  0x80  // mpu2_* 欄位有效（無效時填 0）
+
 // 封包結構 (32 bytes，無填充)
 typedef struct __attribute__((packed)) {
     uint8_t  version;        // Byte 0: 協議版本
     uint16_t seq;            // Bytes 1-2: 序號
     uint32_t timestamp;      // Bytes 3-6: millis()
-    uint8_t  button;         // Byte 7: 按鈕狀態
+    uint8_t  flags;          // Byte 7: 按鈕狀態 + IMU 有效位元 (PACKET_FLAG_*)
     int16_t  mpu1_ax;        // Bytes 8-9
     int16_t  mpu1_ay;        // Bytes 10-11
     int16_t  mpu1_az;        // Bytes 12-13
@@ -33,4 +38,71 @@ static_assert(sizeof(SensorPacket) == PACKET_SIZE, "Packet size must be 32 bytes
 _Static_assert(sizeof(SensorPacket) == PACKET_SIZE, "Packet size must be 32 bytes");
 #endif
 
+// ========== 遙測封包 ==========
+// Byte 0 最高位元為 1 表示遙測封包（感測封包的 version 最高位元為 0）
+#define PACKET_TYPE_TELEMETRY  0x80
+#define PACKET_TYPE_PROFILE    0x81  // 迴圈階段耗時統計
+#define PACKET_TYPE_HEALTH     0x82  // 健康狀態計數
+
+// 迴圈階段
+#define PROFILE_PHASE_IMU    0  // imu_read_both()
+#define PROFILE_PHASE_FILL   1  // 封包填充
+#define PROFILE_PHASE_RF     2  // rf_send()
+#define PROFILE_PHASE_COUNT  3
+
+// 對數分桶：bucket 0 = 0-63us，bucket k = 2^(k+5)..2^(k+6)-1 us，bucket 7 = ≥ 4096us
+#define PROFILE_BUCKETS      8
+#define PROFILE_BUCKET_SHIFT 6
+
+// 階段耗時統計封包 (32 bytes)
+typedef struct __attribute__((packed)) {
+    uint8_t  type;                       // Byte 0: PACKET_TYPE_PROFILE
+    uint8_t  phase;                      // Byte 1: PROFILE_PHASE_*
+    uint16_t count;                      // Bytes 2-3: 樣本數
+    uint16_t min_us;                     // Bytes 4-5
+    uint16_t max_us;                     // Bytes 6-7
+    uint16_t buckets[PROFILE_BUCKETS];   // Bytes 8-23: 對數分桶計數
+    uint32_t window_ms;                  // Bytes 24-27: 統計區間長度
+    uint32_t timestamp;                  // Bytes 28-31: millis()
+} ProfilePacket;
+
+// HealthPacket.status 位元
+#define HEALTH_STATUS_MPU1_FAULT  0x01
+#define HEALTH_STATUS_MPU2_FAULT  0x02
+#define HEALTH_STATUS_RF_FAULT    0x04
+#define HEALTH_STATUS_BUS_RECOVER 0x08
+
+// 健康狀態封包 (32 bytes)，計數皆為開機後累計
+typedef struct __attribute__((packed)) {
+    uint8_t  type;             // Byte 0: PACKET_TYPE_HEALTH
+    uint8_t  status;           // Byte 1: HEALTH_STATUS_*
+    uint16_t seq;              // Bytes 2-3: 目前序號
+    uint32_t seq_epoch;        // Bytes 4-7: 序號溢位次數（完整序號 = seq_epoch × 65536 + seq）
+    uint32_t uptime_ms;        // Bytes 8-11: millis()
+    uint32_t retransmits;      // Bytes 12-15: 自動重傳次數總和 (ARC)
+    uint32_t tx_fail;          // Bytes 16-19: 發送失敗（未收到 ACK）次數
+    uint16_t rf_reinit;        // Bytes 20-21: rf_reinit() 次數
+    uint16_t i2c_err1;         // Bytes 22-23: MPU1 I2C 錯誤
+    uint16_t i2c_err2;         // Bytes 24-25: MPU2 I2C 錯誤
+    uint16_t overruns;         // Bytes 26-27: 採樣任務錯過期限次數
+    uint16_t bus_recoveries;   // Bytes 28-29: I2C 匯流排恢復次數
+    uint16_t reserved;         // Bytes 30-31
+} HealthPacket;
+
+// 接收端緩衝：依 Byte 0 判斷內容
+typedef union {
+    uint8_t       raw[PACKET_SIZE];
+    SensorPacket  sensor;
+    ProfilePacket profile;
+    HealthPacket  health;
+} RadioPayload;
+
+#ifdef __cplusplus
+static_assert(sizeof(ProfilePacket) == PACKET_SIZE, "Profile packet size must be 32 bytes");
+static_assert(sizeof(HealthPacket) == PACKET_SIZE, "Health packet size must be 32 bytes");
+#else
+_Static_assert(sizeof(ProfilePacket) == PACKET_SIZE, "Profile packet size must be 32 bytes");
+_Static_assert(sizeof(HealthPacket) == PACKET_SIZE, "Health packet size must be 32 bytes");
+#endif
+
 #endif // PACKET_H
@@ -0,0 +1,24 @@
+#ifndef REMOTE_COMMAND_H
+#define REMOTE_COMMAND_H
+
+#include <stdint.h>
+
+// Base → 遠距端指令（遠距端與桌面端共用）
+//
+// 遠距端只發送不接收，指令由 Base 預載在該管道的 ACK payload，
+// 隨遠距端下一個封包的 ACK 帶回（需 RF_TDMA 開啟的 ACK payload）。
+// Base 收到該遠距端的下一個新封包即表示 ACK（含指令）已送達。
+
+#define REMOTE_CMD_TYPE     0xA2   // ACK payload 類型：遠距端指令（TdmaSync 為 0xA1）
+
+// 指令碼
+#define REMOTE_CMD_CHANNEL  'C'    // 切換頻道，arg = 0-125（立即重新初始化 nRF24）
+#define REMOTE_CMD_SAVE     'W'    // 將目前組態寫入 EEPROM
+
+typedef struct __attribute__((packed)) {
+    uint8_t  type;   // REMOTE_CMD_TYPE
+    uint8_t  op;     // REMOTE_CMD_*
+    uint16_t arg;
+} RemoteCommand;
+
+#endif // REMOTE_COMMAND_H
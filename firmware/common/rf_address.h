@@ -0,0 +1,29 @@
+#ifndef RF_ADDRESS_H
+#define RF_ADDRESS_H
+
+#include <stdint.h>
+
+// nRF24 接收管道位址（遠距端與桌面端共用）
+//
+// Base 同時開啟 6 個接收管道，每個遠距端對應一個管道（REMOTE_PIPE）。
+// nRF24 硬體限制：pipe 1-5 共用高 4 bytes，只有最低位元組 (addr[0]) 不同；
+// pipe 0 為完整 5-byte 位址，這裡沿用同一組高 4 bytes 方便辨識。
+// pipe 1 = "MECH1"，與單一遠距端時的位址相同。
+
+#define RF_PIPE_COUNT 6
+
+// 各管道位址最低位元組（RF24 位址陣列以 LSB 在前）
+static const uint8_t RF_PIPE_LSB[RF_PIPE_COUNT] = { 'L', 'M', 'N', 'O', 'P', 'Q' };
+
+// 取得管道位址
+// pipe: 0 ~ RF_PIPE_COUNT-1
+// addr: 5-byte 輸出
+static inline void rf_pipe_address(uint8_t pipe, uint8_t addr[5]) {
+    addr[0] = RF_PIPE_LSB[pipe < RF_PIPE_COUNT ? pipe : 1];
+    addr[1] = 'E';
+    addr[2] = 'C';
+    addr[3] = 'H';
+    addr[4] = '1';
+}
+
+#endif // RF_ADDRESS_H
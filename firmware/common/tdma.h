@@ -0,0 +1,31 @@
+#ifndef TDMA_H
+#define TDMA_H
+
+#include <stdint.h>
+
+// 多遠距端 TDMA 時槽同步（遠距端與桌面端共用）
+//
+// 時框 (frame) = 遠距端採樣間隔，平均切成 slot_count 個時槽，每個遠距端一個。
+// Base 以 ACK payload 回傳時槽指派與相位修正：
+//   - Base 量測感測封包到達時間在時框內的相位，目標為所屬時槽中央
+//   - offset_us = 目標 - 實際（正 = 遠距端應延後發送）
+//   - tag = 被量測封包序號的低位元組；遠距端據此找回該封包的實際發送時間，
+//     直接算出下一個時槽（不受 ACK payload 預載造成的一個時框延遲影響）
+//
+// 時間基準在 Base，遠距端不需要絕對時間；晶振誤差由每個時框的修正吸收。
+// 時槽需容納一筆感測封包（有遙測時兩筆）加 ACK：
+// 250kbps 約 2.1 ms / 筆，1Mbps 約 0.6 ms / 筆。
+
+#define TDMA_FRAME_US     10000UL  // 時框長度 (us)，須等於遠距端採樣間隔
+#define TDMA_ACK_SYNC     0xA1     // ACK payload 類型：時槽同步
+
+// ACK payload：時槽同步
+typedef struct __attribute__((packed)) {
+    uint8_t type;        // TDMA_ACK_SYNC
+    uint8_t slot;        // 指派時槽 0 ~ slot_count-1
+    uint8_t slot_count;  // 時槽數（= 使用中的遠距端數）
+    uint8_t tag;         // 被量測感測封包的序號低位元組
+    int16_t offset_us;   // 到達時間修正（目標 - 實際）
+} TdmaSync;
+
+#endif // TDMA_H
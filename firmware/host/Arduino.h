@@ -0,0 +1,85 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// 主機端 Arduino API（只實作韌體用到的部分，見 hal.h）
+//
+// 不定義 ARDUINO / __AVR__：韌體走各模組既有的非 AVR 路徑
+// （FastGpio 主機端陣列、uart.cpp 經 Serial、rf_receiver.cpp 以 attach/detachInterrupt 遮蔽 IRQ）。
+// millis() / micros() 讀虛擬時鐘，只有 delay()、模擬的匯流排 / 無線傳輸與測試程式會推進。
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+// PROGMEM：主機端與 RAM 同一位址空間
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+typedef const char* PGM_P;
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#define HIGH 1
+#define LOW  0
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define LED_BUILTIN 13
+#define A4 18
+#define A5 19
+
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : 0xFF))
+
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+
+void attachInterrupt(uint8_t num, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t num);
+void noInterrupts(void);
+void interrupts(void);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+// Serial：輸出依鮑率在虛擬時間內送出（64 bytes 硬體緩衝，與 Arduino core 相同）
+class HardwareSerial {
+public:
+    void begin(unsigned long baud);
+    int available(void);
+    int read(void);
+    int availableForWrite(void);
+    size_t write(uint8_t b);
+    size_t write(const uint8_t* data, size_t len);
+
+    size_t print(const char* s);
+    size_t print(const __FlashStringHelper* s);
+    size_t print(char c);
+    size_t print(long value);
+    size_t print(unsigned long value);
+    size_t print(int value) { return print((long)value); }
+    size_t print(unsigned int value) { return print((unsigned long)value); }
+    size_t println(void);
+    template <typename T>
+    size_t println(T value) { size_t n = print(value); return n + println(); }
+};
+
+extern HardwareSerial Serial;
+
+#endif
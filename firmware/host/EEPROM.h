@@ -0,0 +1,20 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+// 主機端 EEPROM：1 KB（ATmega328P），hal_reset() 時清為 0xFF（出廠狀態）
+
+#include <stdint.h>
+
+#define HAL_EEPROM_SIZE 1024
+
+class EEPROMClass {
+public:
+    uint8_t read(int addr);
+    void write(int addr, uint8_t value);
+    void update(int addr, uint8_t value);
+    uint16_t length(void) { return HAL_EEPROM_SIZE; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef HOST_RF24_H
+#define HOST_RF24_H
+
+// 主機端 nRF24L01+ 模型（見 hal.h 的 hal_radio_*）
+//
+// - 接收：測試程式以 hal_radio_deliver() 放入 RX FIFO（3 筆，滿時丟棄），
+//   設定 RX_DR 並拉低 IRQ 腳；whatHappened() 清除 RX_DR 後 IRQ 腳回到高電位
+// - 發送：write() 依資料速率與重傳設定推進虛擬時鐘（收發切換 + 資料 + ACK / 重傳等待），
+//   對方收到時呼叫測試程式的回應函式，回傳的 ACK payload 放入 RX FIFO
+// - writeAckPayload()：TX FIFO 共 3 筆，封包送達該管道時隨 ACK 帶走（hal_radio_deliver()）；
+//   啟用 ACK payload 時 stopListening() 會清空 TX FIFO（與 RF24 函式庫相同）
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Arduino.h>   // 與原函式庫相同，引用端可直接使用 delay() 等
+
+typedef enum { RF24_PA_MIN = 0, RF24_PA_LOW, RF24_PA_HIGH, RF24_PA_MAX } rf24_pa_dbm_e;
+typedef enum { RF24_1MBPS = 0, RF24_2MBPS, RF24_250KBPS } rf24_datarate_e;
+typedef enum { RF24_CRC_DISABLED = 0, RF24_CRC_8, RF24_CRC_16 } rf24_crclength_e;
+
+class RF24 {
+public:
+    RF24(uint16_t ce_pin, uint16_t csn_pin) { (void)ce_pin; (void)csn_pin; }
+
+    bool begin(void);
+    void setChannel(uint8_t channel);
+    uint8_t getChannel(void);
+    bool setDataRate(rf24_datarate_e rate);
+    void setPALevel(uint8_t level, bool lna = true) { (void)level; (void)lna; }
+    void setRetries(uint8_t delay, uint8_t count);
+    void setPayloadSize(uint8_t size) { (void)size; }
+    void setAutoAck(bool enable) { (void)enable; }
+    void setCRCLength(rf24_crclength_e length) { (void)length; }
+    void enableDynamicPayloads(void) {}
+    void enableAckPayload(void);
+    void maskIRQ(bool tx_ok, bool tx_fail, bool rx_ready) { (void)tx_ok; (void)tx_fail; (void)rx_ready; }
+
+    void openWritingPipe(const uint8_t* address) { (void)address; }
+    void openReadingPipe(uint8_t pipe, const uint8_t* address) { (void)pipe; (void)address; }
+    void startListening(void);
+    void stopListening(void);
+    void powerDown(void) {}
+    void powerUp(void) {}
+
+    bool write(const void* data, uint8_t len);
+    uint8_t getARC(void);
+    bool available(void);
+    bool available(uint8_t* pipe);
+    void read(void* data, uint8_t len);
+    uint8_t getDynamicPayloadSize(void);
+    void whatHappened(bool& tx_ok, bool& tx_fail, bool& rx_ready);
+    bool writeAckPayload(uint8_t pipe, const void* data, uint8_t len);
+    bool testRPD(void);
+    void flush_tx(void);
+    void flush_rx(void);
+};
+
+#endif
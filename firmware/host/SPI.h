@@ -0,0 +1,6 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+// 主機端 SPI：nRF24 直接由 RF24.h 模型處理，這裡不需要任何內容
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+// 主機端 I2C：匯流排上掛兩顆 MPU6050 模型（0x68 / 0x69，見 hal.h）
+// 每個位元組 9 個 SCL 週期，依 setClock() 的時脈推進虛擬時鐘
+
+#include <stdint.h>
+#include <stddef.h>
+#include <Arduino.h>   // 與原函式庫相同，引用端可直接使用 delay() 等
+
+class TwoWire {
+public:
+    void begin(void);
+    void end(void);
+    void setClock(uint32_t hz);
+
+    void beginTransmission(uint8_t addr);
+    size_t write(uint8_t b);
+    size_t write(const uint8_t* data, size_t len);
+    // 回傳: 0 = 成功，2 = 位址 NACK（裝置不在線）
+    uint8_t endTransmission(bool stop = true);
+
+    uint8_t requestFrom(uint8_t addr, uint8_t len);
+    int available(void);
+    int read(void);
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,713 @@
+#include "hal.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <RF24.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include <vector>
+#include "../common/fast_gpio.h"
+
+// ========== 時鐘 ==========
+
+static uint64_t now_us = 0;
+
+static void serial_drain(uint32_t us);
+
+void hal_advance_us(uint32_t us) {
+    now_us += us;
+    serial_drain(us);
+}
+
+uint64_t hal_now_us(void) {
+    return now_us;
+}
+
+unsigned long millis(void) {
+    return (uint32_t)(now_us / 1000);
+}
+
+unsigned long micros(void) {
+    return (uint32_t)now_us;
+}
+
+void delay(unsigned long ms) {
+    hal_advance_us((uint32_t)(ms * 1000));
+}
+
+void delayMicroseconds(unsigned int us) {
+    hal_advance_us(us);
+}
+
+// ========== 中斷 ==========
+
+#define HAL_INT_COUNT 2   // INT0 (D2) / INT1 (D3)
+
+static void (*int_handler[HAL_INT_COUNT])(void);
+static bool int_attached[HAL_INT_COUNT];
+static bool int_flag[HAL_INT_COUNT];    // 下降邊緣旗標（與 INTFx 相同，遮蔽期間也會設定）
+static bool int_enabled = true;
+static bool in_isr = false;
+
+// 執行已觸發且已開啟的中斷（中斷內不巢狀）
+static void int_dispatch(void) {
+    if (!int_enabled || in_isr) return;
+    for (uint8_t i = 0; i < HAL_INT_COUNT; i++) {
+        if (!int_attached[i] || !int_flag[i]) continue;
+        int_flag[i] = false;
+        in_isr = true;
+        int_handler[i]();
+        in_isr = false;
+    }
+}
+
+void attachInterrupt(uint8_t num, void (*handler)(void), int mode) {
+    (void)mode;   // 韌體只用 FALLING
+    if (num >= HAL_INT_COUNT) return;
+    int_handler[num] = handler;
+    int_attached[num] = true;
+    int_dispatch();
+}
+
+void detachInterrupt(uint8_t num) {
+    if (num < HAL_INT_COUNT) int_attached[num] = false;
+}
+
+void noInterrupts(void) {
+    int_enabled = false;
+}
+
+void interrupts(void) {
+    int_enabled = true;
+    int_dispatch();
+}
+
+// ========== GPIO ==========
+
+static void pin_set(uint8_t pin, uint8_t level) {
+    if (pin >= FAST_GPIO_PIN_COUNT) return;
+    uint8_t old = fast_gpio_host_pins()[pin];
+    fast_gpio_host_pins()[pin] = level ? 1 : 0;
+    uint8_t num = digitalPinToInterrupt(pin);
+    if (num < HAL_INT_COUNT && old && !level) {
+        int_flag[num] = true;
+        int_dispatch();
+    }
+}
+
+void hal_pin_write(uint8_t pin, uint8_t level) {
+    pin_set(pin, level);
+}
+
+uint8_t hal_pin_read(uint8_t pin) {
+    return pin < FAST_GPIO_PIN_COUNT ? fast_gpio_host_pins()[pin] : 0;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= FAST_GPIO_PIN_COUNT) return;
+    fast_gpio_host_modes()[pin] = (mode == OUTPUT) ? 1 : 0;
+    if (mode == INPUT_PULLUP) fast_gpio_host_pins()[pin] = 1;
+}
+
+int digitalRead(uint8_t pin) {
+    return hal_pin_read(pin) ? HIGH : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin < FAST_GPIO_PIN_COUNT) fast_gpio_host_pins()[pin] = level ? 1 : 0;
+}
+
+// ========== 亂數 ==========
+
+// 與 avr-libc 同一組線性同餘參數；只求可重現，不求與 AVR 相同的序列
+static uint32_t lcg_next(uint32_t* state) {
+    *state = *state * 1103515245UL + 12345UL;
+    return *state >> 1;
+}
+
+static uint32_t random_state = 1;
+
+long random(long max) {
+    if (max <= 0) return 0;
+    return (long)(lcg_next(&random_state) % (uint32_t)max);
+}
+
+long random(long min, long max) {
+    if (min >= max) return min;
+    return min + random(max - min);
+}
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) random_state = (uint32_t)seed;
+}
+
+// ========== Serial ==========
+
+HardwareSerial Serial;
+
+#define SERIAL_RX_BUFFER 64
+
+static uint32_t serial_baud = 0;
+static uint8_t tx_buf[HAL_SERIAL_TX_BUFFER];
+static uint8_t tx_head = 0;
+static uint8_t tx_count = 0;
+static uint64_t tx_credit = 0;          // 累積可送出的位元數 × 1e6
+static std::vector<uint8_t> wire_out;   // 已送上線路的位元組
+static uint8_t rx_buf[SERIAL_RX_BUFFER];
+static uint8_t rx_head = 0;
+static uint8_t rx_count = 0;
+
+#define SERIAL_BYTE_BITS 10   // 8N1
+
+static void serial_drain(uint32_t us) {
+    if (tx_count == 0 || serial_baud == 0) {
+        tx_credit = 0;    // 線路閒置不累積
+        return;
+    }
+    tx_credit += (uint64_t)us * serial_baud;
+    while (tx_count > 0 && tx_credit >= (uint64_t)SERIAL_BYTE_BITS * 1000000) {
+        tx_credit -= (uint64_t)SERIAL_BYTE_BITS * 1000000;
+        uint8_t tail = (uint8_t)((tx_head + HAL_SERIAL_TX_BUFFER - tx_count) % HAL_SERIAL_TX_BUFFER);
+        wire_out.push_back(tx_buf[tail]);
+        tx_count--;
+    }
+    if (tx_count == 0) tx_credit = 0;
+}
+
+void hal_serial_inject(const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len && rx_count < SERIAL_RX_BUFFER; i++) {
+        rx_buf[(rx_head + rx_count) % SERIAL_RX_BUFFER] = p[i];
+        rx_count++;
+    }
+}
+
+const uint8_t* hal_serial_output(size_t* len) {
+    *len = wire_out.size();
+    return wire_out.empty() ? (const uint8_t*)"" : &wire_out[0];
+}
+
+void hal_serial_clear(void) {
+    wire_out.clear();
+}
+
+uint32_t hal_serial_baud(void) {
+    return serial_baud;
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+    serial_baud = (uint32_t)baud;
+}
+
+int HardwareSerial::available(void) {
+    return rx_count;
+}
+
+int HardwareSerial::read(void) {
+    if (rx_count == 0) return -1;
+    uint8_t b = rx_buf[rx_head];
+    rx_head = (uint8_t)((rx_head + 1) % SERIAL_RX_BUFFER);
+    rx_count--;
+    return b;
+}
+
+int HardwareSerial::availableForWrite(void) {
+    return HAL_SERIAL_TX_BUFFER - tx_count;
+}
+
+size_t HardwareSerial::write(uint8_t b) {
+    if (serial_baud == 0) return 0;
+    // 緩衝滿時等待（與 Arduino core 相同會阻塞）
+    while (tx_count >= HAL_SERIAL_TX_BUFFER) {
+        hal_advance_us((uint32_t)(SERIAL_BYTE_BITS * 1000000UL / serial_baud + 1));
+    }
+    tx_buf[tx_head] = b;
+    tx_head = (uint8_t)((tx_head + 1) % HAL_SERIAL_TX_BUFFER);
+    tx_count++;
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) n += write(data[i]);
+    return n;
+}
+
+size_t HardwareSerial::print(const char* s) {
+    return write((const uint8_t*)s, strlen(s));
+}
+
+size_t HardwareSerial::print(const __FlashStringHelper* s) {
+    return print(reinterpret_cast<const char*>(s));
+}
+
+size_t HardwareSerial::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t HardwareSerial::print(long value) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%ld", value);
+    return print(buf);
+}
+
+size_t HardwareSerial::print(unsigned long value) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%lu", value);
+    return print(buf);
+}
+
+size_t HardwareSerial::println(void) {
+    return print("\r\n");
+}
+
+// ========== nRF24L01+ ==========
+
+#define RADIO_PAYLOAD_MAX 32
+#define RADIO_SETTLE_US   130   // TX/RX 切換 PLL 穩定時間
+#define RADIO_CHANNELS    126
+
+typedef struct {
+    uint8_t pipe;
+    uint8_t len;
+    uint8_t data[RADIO_PAYLOAD_MAX];
+} RadioEntry;
+
+static bool radio_present = true;
+static uint8_t radio_channel = 2;
+static uint8_t radio_rate = RF24_1MBPS;
+static uint8_t retry_delay = 5;
+static uint8_t retry_count = 15;
+static bool ack_payloads = false;
+static bool listening = false;
+static uint8_t last_arc = 0;
+
+static RadioEntry rx_fifo[HAL_RADIO_FIFO_DEPTH];
+static uint8_t rx_fifo_count = 0;
+static RadioEntry tx_fifo[HAL_RADIO_FIFO_DEPTH];
+static uint8_t tx_fifo_count = 0;
+static bool rx_dr = false;
+static uint32_t rx_dropped = 0;
+
+static uint16_t loss_permille = 0;
+static uint32_t loss_state = 1;
+static HalRadioResponder responder = 0;
+static bool rpd[RADIO_CHANNELS];
+
+// IRQ 腳（低電位有效）只反應 RX_DR，且只在接收模式接線（遠距端 D2 是按鈕）
+static void radio_update_irq(void) {
+    if (!listening) return;
+    pin_set(2, rx_dr ? 0 : 1);
+}
+
+// 空中傳輸時間：前導 + 位址 5 + payload + CRC 2 bytes + 9-bit 封包控制欄
+static uint32_t radio_airtime_us(uint8_t payload) {
+    uint8_t preamble = (radio_rate == RF24_2MBPS) ? 2 : 1;
+    uint32_t bits = 8UL * (preamble + 5 + payload + 2) + 9;
+    switch (radio_rate) {
+    case RF24_250KBPS: return bits * 4;
+    case RF24_2MBPS:   return (bits + 1) / 2;
+    default:           return bits;
+    }
+}
+
+static void fifo_push(RadioEntry* fifo, uint8_t* count, uint8_t pipe, const void* data, uint8_t len) {
+    RadioEntry* e = &fifo[*count];
+    e->pipe = pipe;
+    e->len = len > RADIO_PAYLOAD_MAX ? RADIO_PAYLOAD_MAX : len;
+    memcpy(e->data, data, e->len);
+    (*count)++;
+}
+
+static void fifo_pop(RadioEntry* fifo, uint8_t* count, uint8_t index) {
+    for (uint8_t i = index; i + 1 < *count; i++) fifo[i] = fifo[i + 1];
+    (*count)--;
+}
+
+void hal_radio_set_present(bool present) {
+    radio_present = present;
+}
+
+int8_t hal_radio_deliver(uint8_t air_channel, uint8_t pipe, const void* data, uint8_t len, uint8_t* ack) {
+    if (!radio_present || !listening || air_channel != radio_channel) return -1;
+    if (rx_fifo_count >= HAL_RADIO_FIFO_DEPTH) {
+        rx_dropped++;
+        return -1;
+    }
+    fifo_push(rx_fifo, &rx_fifo_count, pipe, data, len);
+
+    // 該管道第一筆預載的 ACK payload 隨 ACK 送出
+    int8_t ack_len = 0;
+    for (uint8_t i = 0; i < tx_fifo_count; i++) {
+        if (tx_fifo[i].pipe != pipe) continue;
+        ack_len = (int8_t)tx_fifo[i].len;
+        if (ack) memcpy(ack, tx_fifo[i].data, tx_fifo[i].len);
+        fifo_pop(tx_fifo, &tx_fifo_count, i);
+        break;
+    }
+
+    rx_dr = true;
+    radio_update_irq();
+    return ack_len;
+}
+
+void hal_radio_set_loss(uint16_t permille) {
+    loss_permille = permille;
+}
+
+void hal_radio_set_responder(HalRadioResponder fn) {
+    responder = fn;
+}
+
+void hal_radio_set_rpd(uint8_t channel, bool value) {
+    if (channel < RADIO_CHANNELS) rpd[channel] = value;
+}
+
+uint8_t hal_radio_channel(void) {
+    return radio_channel;
+}
+
+bool hal_radio_listening(void) {
+    return listening;
+}
+
+uint32_t hal_radio_rx_dropped(void) {
+    return rx_dropped;
+}
+
+bool RF24::begin(void) {
+    if (!radio_present) return false;
+    listening = false;
+    ack_payloads = false;
+    rx_fifo_count = 0;
+    tx_fifo_count = 0;
+    rx_dr = false;
+    return true;
+}
+
+void RF24::setChannel(uint8_t channel) {
+    radio_channel = channel < RADIO_CHANNELS ? channel : RADIO_CHANNELS - 1;
+}
+
+uint8_t RF24::getChannel(void) {
+    return radio_channel;
+}
+
+bool RF24::setDataRate(rf24_datarate_e rate) {
+    radio_rate = (uint8_t)rate;
+    return true;
+}
+
+void RF24::setRetries(uint8_t delay, uint8_t count) {
+    retry_delay = delay & 0x0F;
+    retry_count = count & 0x0F;
+}
+
+void RF24::enableAckPayload(void) {
+    ack_payloads = true;
+}
+
+void RF24::startListening(void) {
+    listening = true;
+    hal_advance_us(RADIO_SETTLE_US);
+    radio_update_irq();
+}
+
+void RF24::stopListening(void) {
+    if (listening) pin_set(2, 1);   // 離開接收模式時放開 IRQ（遠距端從未進入接收模式，D2 是按鈕）
+    listening = false;
+    if (ack_payloads) tx_fifo_count = 0;
+}
+
+bool RF24::write(const void* data, uint8_t len) {
+    if (!radio_present) return false;
+    uint32_t ard_us = 250UL * (retry_delay + 1);
+    for (uint8_t attempt = 0; attempt <= retry_count; attempt++) {
+        hal_advance_us(RADIO_SETTLE_US + radio_airtime_us(len));
+        bool lost = loss_permille > 0 && lcg_next(&loss_state) % 1000 < loss_permille;
+        if (!lost) {
+            last_arc = attempt;
+            uint8_t ack[RADIO_PAYLOAD_MAX];
+            uint8_t ack_len = responder ? responder((const uint8_t*)data, len, ack) : 0;
+            hal_advance_us(RADIO_SETTLE_US + radio_airtime_us(ack_len));
+            if (ack_len > 0 && ack_payloads && rx_fifo_count < HAL_RADIO_FIFO_DEPTH) {
+                fifo_push(rx_fifo, &rx_fifo_count, 0, ack, ack_len);
+            }
+            return true;
+        }
+        hal_advance_us(ard_us);   // 等待 ACK 逾時後重傳
+    }
+    last_arc = retry_count;
+    return false;
+}
+
+uint8_t RF24::getARC(void) {
+    return last_arc;
+}
+
+bool RF24::available(void) {
+    return rx_fifo_count > 0;
+}
+
+bool RF24::available(uint8_t* pipe) {
+    if (rx_fifo_count == 0) return false;
+    if (pipe) *pipe = rx_fifo[0].pipe;
+    return true;
+}
+
+void RF24::read(void* data, uint8_t len) {
+    memset(data, 0, len);
+    if (rx_fifo_count == 0) return;
+    memcpy(data, rx_fifo[0].data, len < rx_fifo[0].len ? len : rx_fifo[0].len);
+    fifo_pop(rx_fifo, &rx_fifo_count, 0);
+}
+
+uint8_t RF24::getDynamicPayloadSize(void) {
+    return rx_fifo_count > 0 ? rx_fifo[0].len : 0;
+}
+
+void RF24::whatHappened(bool& tx_ok, bool& tx_fail, bool& rx_ready) {
+    tx_ok = false;
+    tx_fail = false;
+    rx_ready = rx_dr;
+    rx_dr = false;
+    radio_update_irq();
+}
+
+bool RF24::writeAckPayload(uint8_t pipe, const void* data, uint8_t len) {
+    if (tx_fifo_count >= HAL_RADIO_FIFO_DEPTH) return false;
+    fifo_push(tx_fifo, &tx_fifo_count, pipe, data, len);
+    return true;
+}
+
+bool RF24::testRPD(void) {
+    return rpd[radio_channel];
+}
+
+void RF24::flush_tx(void) {
+    tx_fifo_count = 0;
+}
+
+void RF24::flush_rx(void) {
+    rx_fifo_count = 0;
+}
+
+// ========== I2C (MPU6050) ==========
+
+TwoWire Wire;
+
+#define I2C_ADDR_BASE   0x68
+#define I2C_DEVICES     2
+#define I2C_BUFFER      32    // 與 Arduino Wire 緩衝相同
+#define IMU_REG_COUNT   128
+
+typedef struct {
+    bool    present;
+    uint8_t ptr;              // 暫存器指標（寫入第一個位元組設定，讀寫後遞增）
+    uint8_t regs[IMU_REG_COUNT];
+} ImuModel;
+
+static ImuModel imus[I2C_DEVICES];
+static uint32_t i2c_clock = 100000;
+static bool i2c_hold = false;
+static uint8_t i2c_addr = 0;
+static uint8_t i2c_tx[I2C_BUFFER];
+static uint8_t i2c_tx_len = 0;
+static uint8_t i2c_rx[I2C_BUFFER];
+static uint8_t i2c_rx_len = 0;
+static uint8_t i2c_rx_pos = 0;
+
+static void imu_model_reset(ImuModel* m) {
+    memset(m->regs, 0, sizeof(m->regs));
+    m->regs[0x75] = 0x68;   // WHO_AM_I
+    m->regs[0x6B] = 0x40;   // PWR_MGMT_1：開機為睡眠
+    m->ptr = 0;
+}
+
+static ImuModel* imu_at(uint8_t addr) {
+    if (addr < I2C_ADDR_BASE || addr >= I2C_ADDR_BASE + I2C_DEVICES) return 0;
+    ImuModel* m = &imus[addr - I2C_ADDR_BASE];
+    return m->present ? m : 0;
+}
+
+// 匯流排時間：每個位元組 8 bit + ACK，加 START / STOP
+static void i2c_bus_time(uint8_t bytes) {
+    uint32_t bits = (uint32_t)bytes * 9 + 2;
+    hal_advance_us((bits * 1000000UL + i2c_clock / 2) / i2c_clock);
+}
+
+void TwoWire::begin(void) {
+    i2c_tx_len = 0;
+    i2c_rx_len = 0;
+    i2c_rx_pos = 0;
+}
+
+void TwoWire::end(void) {
+    // 交出腳位後韌體以 GPIO 送時脈，從端收完殘留的位元組後放開 SDA
+    i2c_hold = false;
+}
+
+void TwoWire::setClock(uint32_t hz) {
+    if (hz > 0) i2c_clock = hz;
+}
+
+void TwoWire::beginTransmission(uint8_t addr) {
+    i2c_addr = addr;
+    i2c_tx_len = 0;
+}
+
+size_t TwoWire::write(uint8_t b) {
+    if (i2c_tx_len >= I2C_BUFFER) return 0;
+    i2c_tx[i2c_tx_len++] = b;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) n += write(data[i]);
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(bool stop) {
+    (void)stop;
+    i2c_bus_time((uint8_t)(1 + i2c_tx_len));
+    if (i2c_hold) return 4;     // 無法產生 START
+    ImuModel* m = imu_at(i2c_addr);
+    if (!m) return 2;           // 位址 NACK
+    for (uint8_t i = 0; i < i2c_tx_len; i++) {
+        if (i == 0) {
+            m->ptr = i2c_tx[0] & (IMU_REG_COUNT - 1);
+        } else {
+            m->regs[m->ptr] = i2c_tx[i];
+            m->ptr = (m->ptr + 1) & (IMU_REG_COUNT - 1);
+        }
+    }
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t len) {
+    if (len > I2C_BUFFER) len = I2C_BUFFER;
+    i2c_bus_time((uint8_t)(1 + len));
+    i2c_rx_len = 0;
+    i2c_rx_pos = 0;
+    ImuModel* m = imu_at(addr);
+    if (i2c_hold || !m) return 0;
+    for (uint8_t i = 0; i < len; i++) {
+        i2c_rx[i] = m->regs[m->ptr];
+        m->ptr = (m->ptr + 1) & (IMU_REG_COUNT - 1);
+    }
+    i2c_rx_len = len;
+    return len;
+}
+
+int TwoWire::available(void) {
+    return i2c_rx_len - i2c_rx_pos;
+}
+
+int TwoWire::read(void) {
+    if (i2c_rx_pos >= i2c_rx_len) return -1;
+    return i2c_rx[i2c_rx_pos++];
+}
+
+void hal_imu_set_present(uint8_t index, bool present) {
+    if (index < I2C_DEVICES) imus[index].present = present;
+}
+
+void hal_imu_set_sample(uint8_t index, const int16_t raw[7]) {
+    if (index >= I2C_DEVICES) return;
+    for (uint8_t i = 0; i < 7; i++) {
+        imus[index].regs[0x3B + 2 * i]     = (uint8_t)((uint16_t)raw[i] >> 8);
+        imus[index].regs[0x3B + 2 * i + 1] = (uint8_t)raw[i];
+    }
+}
+
+uint8_t hal_imu_reg(uint8_t index, uint8_t reg) {
+    return index < I2C_DEVICES ? imus[index].regs[reg & (IMU_REG_COUNT - 1)] : 0;
+}
+
+void hal_i2c_hold_sda(bool hold) {
+    i2c_hold = hold;
+    fast_gpio_host_pins()[A4] = hold ? 0 : 1;
+}
+
+uint32_t hal_i2c_clock(void) {
+    return i2c_clock;
+}
+
+// ========== EEPROM ==========
+
+EEPROMClass EEPROM;
+
+static uint8_t eeprom[HAL_EEPROM_SIZE];
+
+uint8_t EEPROMClass::read(int addr) {
+    return (addr >= 0 && addr < HAL_EEPROM_SIZE) ? eeprom[addr] : 0xFF;
+}
+
+void EEPROMClass::write(int addr, uint8_t value) {
+    if (addr >= 0 && addr < HAL_EEPROM_SIZE) eeprom[addr] = value;
+}
+
+void EEPROMClass::update(int addr, uint8_t value) {
+    if (read(addr) != value) write(addr, value);
+}
+
+uint8_t* hal_eeprom(void) {
+    return eeprom;
+}
+
+// ========== 重設 ==========
+
+void hal_reset(uint64_t start_us) {
+    now_us = start_us;
+
+    memset(fast_gpio_host_pins(), 0, FAST_GPIO_PIN_COUNT);
+    memset(fast_gpio_host_modes(), 0, FAST_GPIO_PIN_COUNT);
+    fast_gpio_host_pins()[2] = 1;     // nRF24 IRQ / 按鈕：外部上拉
+    fast_gpio_host_pins()[A4] = 1;    // I2C 匯流排上拉
+    fast_gpio_host_pins()[A5] = 1;
+    for (uint8_t i = 0; i < HAL_INT_COUNT; i++) {
+        int_handler[i] = 0;
+        int_attached[i] = false;
+        int_flag[i] = false;
+    }
+    int_enabled = true;
+    in_isr = false;
+    random_state = 1;
+
+    serial_baud = 0;
+    tx_head = 0;
+    tx_count = 0;
+    tx_credit = 0;
+    wire_out.clear();
+    rx_head = 0;
+    rx_count = 0;
+
+    radio_present = true;
+    radio_channel = 2;
+    radio_rate = RF24_1MBPS;
+    retry_delay = 5;
+    retry_count = 15;
+    ack_payloads = false;
+    listening = false;
+    last_arc = 0;
+    rx_fifo_count = 0;
+    tx_fifo_count = 0;
+    rx_dr = false;
+    rx_dropped = 0;
+    loss_permille = 0;
+    loss_state = 1;
+    responder = 0;
+    memset(rpd, 0, sizeof(rpd));
+
+    for (uint8_t i = 0; i < I2C_DEVICES; i++) {
+        imus[i].present = true;
+        imu_model_reset(&imus[i]);
+    }
+    i2c_clock = 100000;
+    i2c_hold = false;
+    i2c_tx_len = 0;
+    i2c_rx_len = 0;
+    i2c_rx_pos = 0;
+
+    memset(eeprom, 0xFF, sizeof(eeprom));
+}
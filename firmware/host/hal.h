@@ -0,0 +1,100 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// 主機端硬體模擬（測試與效能量測用，見 firmware/CMakeLists.txt）
+//
+// 韌體原始碼不修改，直接在 Linux 上編譯：Arduino.h / Wire.h / RF24.h / EEPROM.h
+// 由本目錄提供，這裡是測試程式控制模擬的介面。
+//
+// 虛擬時鐘：
+//   - 64-bit 微秒計數，micros() / millis() 取低 32 位元（與 AVR 相同的溢位行為）
+//   - 只有 delay()、I2C / 無線 / Serial 的傳輸時間與測試程式 hal_advance_us() 會推進，
+//     同樣的輸入每次得到逐位元組相同的輸出
+//   - loop() 本身的執行時間不計（由測試程式決定每圈推進多少，見 tests/sim.h）
+//
+// 每個行程只模擬一塊板子（一顆 nRF24、一個 Serial、一條 I2C 匯流排）。
+
+// ========== 時鐘 ==========
+
+// 重設全部模擬狀態（時鐘、腳位、Serial、無線、I2C、EEPROM 清為 0xFF）
+// start_us: 起始時間，例如 0xFFF00000 用來測試 micros() 溢位
+void hal_reset(uint64_t start_us);
+
+// 目前虛擬時間 (us)
+uint64_t hal_now_us(void);
+
+// 推進虛擬時鐘（Serial 依鮑率送出這段時間內可送完的位元組）
+void hal_advance_us(uint32_t us);
+
+// ========== GPIO ==========
+
+// 外部驅動腳位電位；D2 / D3 的下降邊緣觸發已掛上的中斷（關中斷期間延後到 interrupts()）
+void hal_pin_write(uint8_t pin, uint8_t level);
+uint8_t hal_pin_read(uint8_t pin);
+
+// ========== Serial ==========
+
+#define HAL_SERIAL_TX_BUFFER 64     // 硬體傳送緩衝 (bytes)，與 Arduino core 相同
+
+// 主機送到板子的位元組（立即可讀）
+void hal_serial_inject(const void* data, size_t len);
+
+// 已經送上線路的輸出（hal_serial_clear() 後重新累積）
+const uint8_t* hal_serial_output(size_t* len);
+void hal_serial_clear(void);
+
+// 目前鮑率（0 = 尚未 begin）
+uint32_t hal_serial_baud(void);
+
+// ========== nRF24L01+ ==========
+
+#define HAL_RADIO_FIFO_DEPTH 3      // 硬體 RX / TX FIFO 筆數
+
+// 遠距端發送成功（對方收到）時呼叫：data = 發送內容，ack = 填入要回傳的 ACK payload
+// 回傳: ACK payload 長度（0 = 空 ACK）；呼叫時虛擬時鐘位於封包收完的時間點
+typedef uint8_t (*HalRadioResponder)(const uint8_t* data, uint8_t len, uint8_t* ack);
+
+// begin() 是否成功（模組是否在線）
+void hal_radio_set_present(bool present);
+
+// 空中封包送達 Base：需在接收模式且頻道相符，放入 RX FIFO 並拉低 IRQ (D2)
+// air_channel: 發送端頻道
+// ack: 收到時填入該管道預載的 ACK payload（最多 32 bytes，可為 NULL）
+// 回傳: -1 = 未收到（不在接收模式 / 頻道不符 / RX FIFO 滿，發送端會重傳），否則 = ACK payload 長度
+int8_t hal_radio_deliver(uint8_t air_channel, uint8_t pipe, const void* data, uint8_t len, uint8_t* ack);
+
+// 遠距端發送：每次嘗試的遺失機率（千分比，1000 = 斷線），以及收到時的回應
+void hal_radio_set_loss(uint16_t permille);
+void hal_radio_set_responder(HalRadioResponder responder);
+
+// testRPD() 的結果（依頻道）
+void hal_radio_set_rpd(uint8_t channel, bool rpd);
+
+uint8_t hal_radio_channel(void);
+bool hal_radio_listening(void);
+uint32_t hal_radio_rx_dropped(void);    // RX FIFO 滿而未收到的封包數
+
+// ========== I2C (MPU6050 ×2) ==========
+
+// index: 0 = 0x68 (MPU1), 1 = 0x69 (MPU2)
+void hal_imu_set_present(uint8_t index, bool present);
+
+// 設定量測值：ax ay az temp gx gy gz（寫入 0x3B 起的暫存器，Big-Endian）
+void hal_imu_set_sample(uint8_t index, const int16_t raw[7]);
+
+uint8_t hal_imu_reg(uint8_t index, uint8_t reg);
+
+// 從端拉住 SDA：所有交易失敗且 SDA (A4) 讀為低，Wire.end() 後（改以 GPIO 送時脈）釋放
+void hal_i2c_hold_sda(bool hold);
+
+uint32_t hal_i2c_clock(void);
+
+// ========== EEPROM ==========
+
+uint8_t* hal_eeprom(void);
+
+#endif
@@ -0,0 +1,4 @@
+// 遠距端韌體主程式（主機端編譯單元）
+// Arduino IDE 編譯 .ino 時自動加入 #include <Arduino.h>，這裡照做
+#include <Arduino.h>
+#include "../remote/main_remote.ino"
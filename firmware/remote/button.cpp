@@ -1,5 +1,9 @@
 #include "button.h"
 #include <Arduino.h>
+#include "../common/fast_gpio.h"
+
+// 按鈕腳位（編譯期埠存取）
+typedef FastGpio<BUTTON_PIN> ButtonGpio;
 
 // 去抖狀態
 static bool current_state = false;      // 當前穩定狀態
@@ -7,14 +11,14 @@ static bool last_reading = false;       // 上次讀取值
 static unsigned long last_change = 0;   // 上次變化時間
 
 void button_init(void) {
-    pinMode(BUTTON_PIN, INPUT_PULLUP);
+    ButtonGpio::set_input_pullup();
     current_state = false;
-    last_reading = digitalRead(BUTTON_PIN) == LOW;
+    last_reading = !ButtonGpio::read();
     last_change = millis();
 }
 
 void button_update(void) {
-    bool reading = (digitalRead(BUTTON_PIN) == LOW);  // LOW = 按下
+    bool reading = !ButtonGpio::read();  // LOW = 按下
     unsigned long now = millis();
 
     if (reading != last_reading) {
@@ -0,0 +1,60 @@
+#include "config_store.h"
+#include "imu_driver.h"
+#include "rf_link.h"
+#include "../common/crc.h"
+#include <EEPROM.h>
+#include <RF24.h>
+
+#define CONFIG_CRC_LEN (sizeof(RemoteConfig) - sizeof(uint16_t))
+
+void config_defaults(RemoteConfig* cfg, uint8_t sample_interval_ms) {
+    cfg->magic = CONFIG_MAGIC;
+    cfg->version = CONFIG_VERSION;
+    cfg->gyro_range = IMU_GYRO_RANGE;
+    cfg->accel_range = IMU_ACCEL_RANGE;
+    cfg->dlpf = IMU_DLPF;
+    cfg->rf_channel = RF_CHANNEL;
+    cfg->rf_datarate = RF_DATARATE;
+    cfg->sample_interval_ms = sample_interval_ms;
+    cfg->build_id = config_build_id(sample_interval_ms);
+    cfg->crc = 0;
+}
+
+uint16_t config_build_id(uint8_t sample_interval_ms) {
+    const uint8_t defaults[] = {
+        IMU_GYRO_RANGE, IMU_ACCEL_RANGE, IMU_DLPF,
+        RF_CHANNEL, (uint8_t)RF_DATARATE, sample_interval_ms
+    };
+    return crc16(defaults, sizeof(defaults));
+}
+
+bool config_load(RemoteConfig* cfg, uint8_t sample_interval_ms) {
+    uint8_t* p = (uint8_t*)cfg;
+    for (uint8_t i = 0; i < sizeof(RemoteConfig); i++) {
+        p[i] = EEPROM.read(CONFIG_EEPROM_ADDR + i);
+    }
+
+    if (cfg->magic != CONFIG_MAGIC || cfg->version != CONFIG_VERSION) return false;
+    if (crc16(cfg, CONFIG_CRC_LEN) != cfg->crc) return false;
+
+    // 感測器驅動依編譯期量程特化，組態必須一致
+    if (cfg->gyro_range != IMU_GYRO_RANGE ||
+        cfg->accel_range != IMU_ACCEL_RANGE ||
+        cfg->dlpf != IMU_DLPF) {
+        return false;
+    }
+
+    // 預設值不同的韌體寫入的組態（重新燒錄）
+    if (cfg->build_id != config_build_id(sample_interval_ms)) return false;
+
+    return cfg->rf_channel <= 125 && cfg->sample_interval_ms > 0;
+}
+
+void config_save(RemoteConfig* cfg) {
+    cfg->crc = crc16(cfg, CONFIG_CRC_LEN);
+
+    const uint8_t* p = (const uint8_t*)cfg;
+    for (uint8_t i = 0; i < sizeof(RemoteConfig); i++) {
+        EEPROM.update(CONFIG_EEPROM_ADDR + i, p[i]);
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// EEPROM 開機組態
+//
+// 完整探測開機成功後寫入一份組態；之後開機讀回並通過 CRC 檢查時走快速路徑
+// （不讀 WHO_AM_I，直接寫入感測器組態並開始採樣）。
+// 量程欄位與編譯期設定不符（韌體更新）時視同無效，改走完整探測並重寫。
+// 頻道、速率與採樣間隔可在執行期改寫（Base 指令），不能直接與編譯期設定比較；
+// 另存寫入時的編譯期預設值指紋 (build_id)，重新燒錄的預設值不同時同樣走完整探測，
+// 不會沿用舊韌體的頻道而與 Base 對不上。
+
+#define CONFIG_EEPROM_ADDR  0
+#define CONFIG_MAGIC        0x4D43  // "MC"
+#define CONFIG_VERSION      2
+
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t  version;
+    uint8_t  gyro_range;          // IMU_GYRO_*
+    uint8_t  accel_range;         // IMU_ACCEL_*
+    uint8_t  dlpf;                // IMU_DLPF_*
+    uint8_t  rf_channel;          // 0-125
+    uint8_t  rf_datarate;         // rf24_datarate_e
+    uint8_t  sample_interval_ms;  // 採樣間隔
+    uint16_t build_id;            // 編譯期預設值指紋（config_build_id）
+    uint16_t crc;                 // 前面所有欄位的 CRC-16
+} RemoteConfig;
+
+// 填入編譯期預設值
+void config_defaults(RemoteConfig* cfg, uint8_t sample_interval_ms);
+
+// 編譯期預設值指紋：量程、RF_CHANNEL、RF_DATARATE 與預設採樣間隔的 CRC-16
+uint16_t config_build_id(uint8_t sample_interval_ms);
+
+// 從 EEPROM 讀取
+// sample_interval_ms: 本韌體的預設採樣間隔（與 config_defaults 相同，用於比對指紋）
+// 回傳: true=有效（可走快速開機），false=無效（cfg 內容未定義）
+bool config_load(RemoteConfig* cfg, uint8_t sample_interval_ms);
+
+// 寫入 EEPROM（只寫入有變動的位元組，減少磨耗）
+void config_save(RemoteConfig* cfg);
+
+#endif
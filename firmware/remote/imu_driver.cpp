@@ -1,79 +1,164 @@
 #include "imu_driver.h"
+#include "mpu6050.h"
+#include "../common/fast_gpio.h"
 #include <Wire.h>
 
-// 內部函數：寫入暫存器
-static bool write_reg(uint8_t addr, uint8_t reg, uint8_t value) {
-    Wire.beginTransmission(addr);
-    Wire.write(reg);
-    Wire.write(value);
-    return (Wire.endTransmission() == 0);
-}
-
-// 內部函數：檢查 MPU6050 存在
-static bool check_device(uint8_t addr) {
-    Wire.beginTransmission(addr);
-    Wire.write(MPU6050_REG_WHO_AM_I);
-    if (Wire.endTransmission(false) != 0) return false;
+// 兩顆感測器的編譯期特化驅動
+typedef Mpu6050<MPU6050_ADDR_1, IMU_GYRO_RANGE, IMU_ACCEL_RANGE, IMU_DLPF> Imu1;
+typedef Mpu6050<MPU6050_ADDR_2, IMU_GYRO_RANGE, IMU_ACCEL_RANGE, IMU_DLPF> Imu2;
 
-    Wire.requestFrom(addr, (uint8_t)1);
-    if (Wire.available() < 1) return false;
-
-    uint8_t who = Wire.read();
-    return (who == 0x68);  // MPU6050 WHO_AM_I 回傳 0x68
-}
+typedef FastGpio<IMU_SDA_PIN> SdaGpio;
+typedef FastGpio<IMU_SCL_PIN> SclGpio;
 
-// 初始化單顆 MPU6050
-static bool init_single(uint8_t addr) {
-    if (!check_device(addr)) return false;
+// 匯流排恢復狀態
+#define BUS_IDLE      0  // 正常
+#define BUS_CLOCKING  1  // 送出 SCL 脈衝
+#define BUS_STOP      2  // 產生 STOP 條件
+#define BUS_RESTART   3  // 重新啟動 Wire 並初始化感測器
 
-    // 喚醒 MPU6050 (清除 sleep bit)
-    if (!write_reg(addr, MPU6050_REG_PWR_MGMT_1, 0x00)) return false;
+#define BUS_MAX_PULSES 9
 
-    // P1 修正：明確設定量程（不依賴預設值）
-    // 設定陀螺儀量程 ±250°/s (GYRO_CONFIG = 0x00)
-    if (!write_reg(addr, 0x1B, 0x00)) return false;
+static uint16_t error_count[2] = {0, 0};    // 累計錯誤
+static uint8_t consecutive[2] = {0, 0};     // 連續錯誤
+static uint8_t bus_state = BUS_IDLE;
+static uint8_t bus_step = 0;
+static uint16_t recovery_count = 0;
+static uint32_t last_reinit_ms = 0;
 
-    // 設定加速度量程 ±2g (ACCEL_CONFIG = 0x00)
-    if (!write_reg(addr, 0x1C, 0x00)) return false;
+static void wire_start(void) {
+    Wire.begin();
+    Wire.setClock(400000);  // 400kHz I2C
+#if defined(WIRE_HAS_TIMEOUT)
+    Wire.setWireTimeout(IMU_WIRE_TIMEOUT_US, true);
+#endif
+}
 
-    return true;
+// 記錄單顆感測器的讀取結果
+static inline void record_result(uint8_t index, bool ok) {
+    if (ok) {
+        consecutive[index] = 0;
+        return;
+    }
+    if (error_count[index] < 0xFFFF) error_count[index]++;
+    if (consecutive[index] < 0xFF) consecutive[index]++;
 }
 
 uint8_t imu_init(void) {
-    Wire.begin();
-    Wire.setClock(400000);  // 400kHz I2C
+    wire_start();
 
     uint8_t result = 0;
-    if (!init_single(MPU6050_ADDR_1)) result |= 1;
-    if (!init_single(MPU6050_ADDR_2)) result |= 2;
+    if (!Imu1::init()) result |= 1;
+    if (!Imu2::init()) result |= 2;
 
     return result;
 }
 
-bool imu_read(uint8_t addr, IMU_RawData* data) {
-    Wire.beginTransmission(addr);
-    Wire.write(MPU6050_REG_ACCEL_XOUT_H);
-    if (Wire.endTransmission(false) != 0) return false;
-
-    // 讀取 14 bytes: AX(2) + AY(2) + AZ(2) + TEMP(2) + GX(2) + GY(2) + GZ(2)
-    Wire.requestFrom(addr, (uint8_t)14);
-    if (Wire.available() < 14) return false;
-
-    // 注意：MPU6050 是 Big-Endian
-    data->ax = (Wire.read() << 8) | Wire.read();
-    data->ay = (Wire.read() << 8) | Wire.read();
-    data->az = (Wire.read() << 8) | Wire.read();
-    Wire.read(); Wire.read();  // 跳過溫度
-    data->gx = (Wire.read() << 8) | Wire.read();
-    data->gy = (Wire.read() << 8) | Wire.read();
-    data->gz = (Wire.read() << 8) | Wire.read();
-
-    return true;
+uint8_t imu_init_fast(void) {
+    wire_start();
+
+    uint8_t result = 0;
+    if (!Imu1::configure()) result |= 1;
+    if (!Imu2::configure()) result |= 2;
+
+    return result;
 }
 
 uint8_t imu_read_both(IMU_RawData* data1, IMU_RawData* data2) {
+    if (bus_state != BUS_IDLE) return 3;
+
+    bool ok1 = Imu1::read(data1);
+    bool ok2 = Imu2::read(data2);
+    record_result(0, ok1);
+    record_result(1, ok2);
+
     uint8_t result = 0;
-    if (!imu_read(MPU6050_ADDR_1, data1)) result |= 1;
-    if (!imu_read(MPU6050_ADDR_2, data2)) result |= 2;
+    if (!ok1) result |= 1;
+    if (!ok2) result |= 2;
     return result;
 }
+
+// 匯流排恢復：每次呼叫推進半個 SCL 週期
+static void bus_recover_step(void) {
+    switch (bus_state) {
+    case BUS_CLOCKING:
+        if ((bus_step & 1) == 0) {
+            // 從端釋放 SDA 後即可停止送脈衝
+            if (SdaGpio::read() || bus_step >= BUS_MAX_PULSES * 2) {
+                bus_state = BUS_STOP;
+                bus_step = 0;
+                return;
+            }
+            SclGpio::low();
+            SclGpio::set_output();
+        } else {
+            SclGpio::set_input_pullup();
+        }
+        bus_step++;
+        break;
+
+    case BUS_STOP:
+        // SCL 高電位時 SDA 由低轉高 = STOP
+        if (bus_step == 0) {
+            SdaGpio::low();
+            SdaGpio::set_output();
+            bus_step = 1;
+        } else {
+            SdaGpio::set_input_pullup();
+            bus_state = BUS_RESTART;
+        }
+        break;
+
+    case BUS_RESTART:
+        wire_start();
+        Imu1::configure();
+        Imu2::configure();
+        consecutive[0] = 0;
+        consecutive[1] = 0;
+        bus_state = BUS_IDLE;
+        break;
+
+    default:
+        bus_state = BUS_IDLE;
+        break;
+    }
+}
+
+void imu_service(uint32_t now_ms) {
+    if (bus_state != BUS_IDLE) {
+        bus_recover_step();
+        return;
+    }
+
+    bool fail1 = consecutive[0] >= IMU_FAIL_THRESHOLD;
+    bool fail2 = consecutive[1] >= IMU_FAIL_THRESHOLD;
+    if (!fail1 && !fail2) return;
+    if (now_ms - last_reinit_ms < IMU_REINIT_INTERVAL_MS) return;
+    last_reinit_ms = now_ms;
+
+    // SDA 被從端拉住：交出 TWI 腳位，改以 GPIO 送時脈
+    if (!SdaGpio::read()) {
+        Wire.end();
+        SdaGpio::set_input_pullup();
+        SclGpio::set_input_pullup();
+        bus_state = BUS_CLOCKING;
+        bus_step = 0;
+        if (recovery_count < 0xFFFF) recovery_count++;
+        return;
+    }
+
+    // 匯流排正常：只重新初始化失敗的感測器（斷線後重新接上時喚醒）
+    if (fail1 && Imu1::init()) consecutive[0] = 0;
+    if (fail2 && Imu2::init()) consecutive[1] = 0;
+}
+
+bool imu_bus_recovering(void) {
+    return bus_state != BUS_IDLE;
+}
+
+uint16_t imu_get_error_count(uint8_t index) {
+    return (index < 2) ? error_count[index] : 0;
+}
+
+uint16_t imu_get_recovery_count(void) {
+    return recovery_count;
+}
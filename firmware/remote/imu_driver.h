@@ -3,15 +3,25 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "../common/imu_scale.h"
 
 // I2C 位址
 #define MPU6050_ADDR_1 0x68  // AD0 = GND
 #define MPU6050_ADDR_2 0x69  // AD0 = VCC
 
-// MPU6050 暫存器
-#define MPU6050_REG_PWR_MGMT_1   0x6B
-#define MPU6050_REG_ACCEL_XOUT_H 0x3B
-#define MPU6050_REG_WHO_AM_I     0x75
+// I2C 腳位（ATmega328P 硬體 TWI，匯流排恢復時改為 GPIO 操作）
+#define IMU_SDA_PIN 18  // A4
+#define IMU_SCL_PIN 19  // A5
+
+// 量程設定（編譯期固定，比例尺見 common/imu_scale.h）
+#define IMU_GYRO_RANGE   IMU_GYRO_250DPS
+#define IMU_ACCEL_RANGE  IMU_ACCEL_2G
+#define IMU_DLPF         IMU_DLPF_260HZ
+
+// 故障恢復參數
+#define IMU_FAIL_THRESHOLD      3     // 連續失敗次數門檻，超過後開始恢復
+#define IMU_REINIT_INTERVAL_MS  500   // 重新初始化感測器的間隔
+#define IMU_WIRE_TIMEOUT_US     3000  // Wire 交易逾時（避免卡死在 I2C）
 
 // 6 軸原始資料結構
 typedef struct {
@@ -23,14 +33,29 @@ typedef struct {
 // 回傳: 0=成功, 1=MPU1失敗, 2=MPU2失敗, 3=兩個都失敗
 uint8_t imu_init(void);
 
-// 讀取單顆 MPU6050 原始資料
-// addr: MPU6050_ADDR_1 或 MPU6050_ADDR_2
-// data: 輸出資料指標
-// 回傳: true=成功, false=I2C錯誤
-bool imu_read(uint8_t addr, IMU_RawData* data);
+// 快速初始化（EEPROM 組態有效時使用）：不讀 WHO_AM_I，直接喚醒並寫入組態
+// 失敗的感測器由 imu_service() 在背景以完整探測重試
+// 回傳: 同 imu_init()
+uint8_t imu_init_fast(void);
 
-// 讀取兩顆 MPU6050（便利函數）
+// 讀取兩顆 MPU6050（各自獨立，一顆失敗不影響另一顆）
+// 匯流排恢復進行中時不存取匯流排，直接回傳 3
 // 回傳: 0=全成功, 1=MPU1失敗, 2=MPU2失敗, 3=兩個都失敗
 uint8_t imu_read_both(IMU_RawData* data1, IMU_RawData* data2);
 
+// 背景故障恢復（每 1ms 呼叫一次，每次只做一小步，不阻塞）
+// - SDA 被拉住：以 GPIO 送出最多 9 個 SCL 脈衝 + STOP，再重新啟動 Wire
+// - 匯流排正常：依 IMU_REINIT_INTERVAL_MS 重新初始化連續失敗的感測器
+void imu_service(uint32_t now_ms);
+
+// 是否正在進行匯流排恢復
+bool imu_bus_recovering(void);
+
+// 取得累計 I2C 錯誤次數
+// index: 0=MPU1, 1=MPU2
+uint16_t imu_get_error_count(uint8_t index);
+
+// 取得匯流排恢復次數
+uint16_t imu_get_recovery_count(void);
+
 #endif
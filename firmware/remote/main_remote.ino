@@ -9,129 +9,364 @@
 #include "imu_driver.h"
 #include "rf_link.h"
 #include "button.h"
+#include "scheduler.h"
+#include "profiler.h"
+#include "config_store.h"
+#include "../common/fast_gpio.h"
+#include "../common/led_pattern.h"
 
 // ========== 配置參數 ==========
-#define SAMPLE_INTERVAL_MS  10    // 採樣間隔 (100Hz)
+#define SAMPLE_INTERVAL_MS  10    // 採樣間隔預設值 (100Hz)，實際值取自 EEPROM 組態
 #define RF_FAIL_THRESHOLD   20    // RF 連續失敗門檻
+#define RF_RETRY_INTERVAL_MS 1000 // RF 故障時重新初始化間隔
+#define RF_CHANNEL_FALLBACK_MS 3000 // 組態頻道不是 RF_CHANNEL 時，連續這麼久未收到 ACK 就改試另一個頻道
 #define LED_PIN             LED_BUILTIN  // 狀態 LED (Nano D13)
+#define DEBUG_SERIAL        0     // 1 = 透過 Serial 輸出排程統計
+
+// 任務週期 (ms)
+#define BUTTON_PERIOD_MS     1
+#define IMU_SERVICE_PERIOD_MS 1
+#define LED_PERIOD_MS        10
+#define TELEMETRY_PERIOD_MS  1000  // 每週期送出一個遙測封包（階段統計 ×3 + 健康狀態，輪流）
+
+// TDMA 對齊（RF_TDMA）：採樣任務以整數 ms 移動相位，剩餘的等待在無線任務內忙等
+#define TDMA_SPIN_MAX_US     2500  // 最長忙等；超過則移動採樣任務相位，本時框不發送
+#define TDMA_LATE_US         300   // 晚於時槽開始超過此值時本時框不發送（會落在別人的時槽）
+#define TDMA_LATE_FRAMES     2     // 連續晚到幾個時框才提前採樣任務（避免單次抖動造成來回移動）
+
+typedef FastGpio<LED_PIN> LedGpio;
 
 // ========== 狀態變數 ==========
 static SensorPacket packet;
 static uint16_t seq_counter = 0;
-static unsigned long last_sample_time = 0;
+static uint32_t seq_epoch = 0;     // 序號溢位次數
 static bool system_ok = false;
+static bool tx_pending = false;   // 封包已填好，等待發送
+static RadioPayload telem_packet;
+static bool telem_pending = false; // 遙測封包等待發送（隨下一筆樣本送出）
+static uint8_t telem_slot = 0;     // 0..PROFILE_PHASE_COUNT-1 = 階段統計，PROFILE_PHASE_COUNT = 健康狀態
+#if RF_TDMA
+static uint8_t slot_late_count = 0;  // 連續晚到時槽的時框數
+#endif
+
+// 故障狀態（不中止運作，只改變 LED 樣式）
+static uint8_t imu_fault = 0;     // bit0=MPU1, bit1=MPU2
+static bool rf_ok = false;        // RF 是否可用
+static bool tx_failed = false;    // 上次發送未收到 ACK
+static uint32_t rf_retry_time = 0;
+static uint8_t rf_channel_now;    // 目前使用的頻道（組態頻道，或連線中斷後改試的 RF_CHANNEL）
+static uint32_t rf_link_time = 0; // 上次收到 ACK 的時間
+static LedPattern led;
+static RemoteConfig config;
+
+// 任務 ID
+static uint8_t task_sample_id;
+static uint8_t task_radio_id;
+static uint8_t task_button_id;
+static uint8_t task_imu_service_id;
+static uint8_t task_led_id;
+static uint8_t task_telemetry_id;
+
+// ========== 任務 ==========
+
+// 無效 IMU 的填充值
+static const IMU_RawData IMU_ZERO = {0, 0, 0, 0, 0, 0};
+
+// 採樣：讀取雙 IMU 並填充封包，完成後觸發無線任務
+// 單顆 IMU 讀取失敗時仍發送，由 flags 的有效位元標示哪顆資料可用
+void task_sample(void) {
+    IMU_RawData imu1, imu2;
+    uint32_t t_start = micros();
+    uint8_t imu_status = imu_read_both(&imu1, &imu2);
+    profiler_record(PROFILE_PHASE_IMU, t_start);
+    imu_fault = imu_status;
+
+    t_start = micros();
+
+    const IMU_RawData* m1 = (imu_status & 1) ? &IMU_ZERO : &imu1;
+    const IMU_RawData* m2 = (imu_status & 2) ? &IMU_ZERO : &imu2;
+
+    uint8_t flags = button_get_state() ? PACKET_FLAG_BUTTON : 0;
+    if (!(imu_status & 1)) flags |= PACKET_FLAG_MPU1_VALID;
+    if (!(imu_status & 2)) flags |= PACKET_FLAG_MPU2_VALID;
+
+    // 填充封包
+    packet.seq = seq_counter++;
+    if (seq_counter == 0) seq_epoch++;
+    packet.timestamp = millis();
+    packet.flags = flags;
+
+    // MPU1 資料
+    packet.mpu1_ax = m1->ax;
+    packet.mpu1_ay = m1->ay;
+    packet.mpu1_az = m1->az;
+    packet.mpu1_gx = m1->gx;
+    packet.mpu1_gy = m1->gy;
+    packet.mpu1_gz = m1->gz;
+
+    // MPU2 資料
+    packet.mpu2_ax = m2->ax;
+    packet.mpu2_ay = m2->ay;
+    packet.mpu2_az = m2->az;
+    packet.mpu2_gx = m2->gx;
+    packet.mpu2_gy = m2->gy;
+    packet.mpu2_gz = m2->gz;
+    profiler_record(PROFILE_PHASE_FILL, t_start);
+
+    tx_pending = true;
+    sched_trigger(task_radio_id);
+}
+
+// 切換使用的頻道並重新初始化 RF
+void rf_switch_channel(uint8_t channel) {
+    rf_channel_now = channel;
+    rf_configure(channel, config.rf_datarate);
+    rf_ok = rf_reinit();
+    rf_retry_time = millis();
+    rf_link_time = rf_retry_time;
+}
 
-// ========== 錯誤 LED 閃爍碼 ==========
-// 1 閃 = MPU1 失敗
-// 2 閃 = MPU2 失敗
-// 3 閃 = RF 失敗
-void error_blink(uint8_t code) {
-    for (uint8_t i = 0; i < code; i++) {
-        digitalWrite(LED_PIN, HIGH);
-        delay(200);
-        digitalWrite(LED_PIN, LOW);
-        delay(200);
+// 頻道回退：Base 切換頻道只存在 RAM，遠距端卻可能已把新頻道寫入 EEPROM（!R<p>W），
+// Base 重新上電後回到 RF_CHANNEL。組態頻道不是 RF_CHANNEL 時，連續 RF_CHANNEL_FALLBACK_MS
+// 未收到 ACK 就在兩者之間輪流嘗試（Base 只是暫時離開範圍時也能換回組態頻道），EEPROM 不變
+void rf_channel_fallback(uint32_t now) {
+    if (config.rf_channel == RF_CHANNEL) return;
+    if (now - rf_link_time < RF_CHANNEL_FALLBACK_MS) return;
+    rf_switch_channel(rf_channel_now == RF_CHANNEL ? config.rf_channel : RF_CHANNEL);
+}
+
+// 執行 Base 轉送的指令（common/remote_command.h）
+void handle_remote_command(const RemoteCommand* cmd) {
+    switch (cmd->op) {
+    case REMOTE_CMD_CHANNEL:
+        if (cmd->arg > 125) break;
+        config.rf_channel = (uint8_t)cmd->arg;
+        rf_switch_channel(config.rf_channel);
+        break;
+    case REMOTE_CMD_SAVE:
+        // 寫入目前實際連線的頻道（頻道回退後 Base 已在 RF_CHANNEL）
+        config.rf_channel = rf_channel_now;
+        config_save(&config);
+        break;
+    default:
+        break;
     }
-    delay(1000);
 }
 
-// ========== Setup ==========
-void setup() {
-    // 初始化 LED
-    pinMode(LED_PIN, OUTPUT);
-    digitalWrite(LED_PIN, HIGH);  // 開機指示
-
-    // 可選：除錯 Serial
-    // Serial.begin(115200);
-    // Serial.println(F("Mechtronic Remote Starting..."));
-
-    // 初始化 IMU
-    uint8_t imu_status = imu_init();
-    if (imu_status != 0) {
-        // IMU 初始化失敗
-        while (1) {
-            error_blink(imu_status);  // 1=MPU1, 2=MPU2, 3=both
+// 無線：發送封包（及待送的遙測封包）並監控連續失敗
+void task_radio(void) {
+    if (!tx_pending) return;
+    tx_pending = false;
+
+    // RF 故障：定期重試初始化，期間採樣照常進行
+    if (!rf_ok) {
+        uint32_t now = millis();
+        if (now - rf_retry_time >= RF_RETRY_INTERVAL_MS) {
+            rf_retry_time = now;
+            rf_ok = rf_reinit();
         }
+        return;
     }
 
-    // 初始化 RF
-    if (!rf_init()) {
-        while (1) {
-            error_blink(3);  // RF 失敗
+#if RF_TDMA
+    // 等待本遠距端的時槽；相位差太大時移動採樣任務並跳過本時框（時槽外發送會撞上別人），
+    // 幾個時框後即落在忙等範圍內
+    int32_t wait_us = rf_slot_wait_us(micros());
+    if (wait_us > TDMA_SPIN_MAX_US || wait_us < -TDMA_LATE_US) {
+        if (wait_us > 0) {
+            slot_late_count = 0;
+            sched_shift(task_sample_id, (int16_t)(wait_us / 1000));
+        } else if (++slot_late_count >= TDMA_LATE_FRAMES) {
+            slot_late_count = 0;
+            sched_shift(task_sample_id, (int16_t)((wait_us - 999) / 1000));
         }
+        rf_slot_skip(micros());
+        return;
+    }
+    slot_late_count = 0;
+    if (wait_us > 0) {
+        delayMicroseconds((unsigned int)wait_us);
     }
+    rf_slot_begin((uint8_t)packet.seq, micros());
+#endif
 
-    // 初始化按鈕
-    button_init();
+    uint32_t t_start = micros();
+    bool sent = rf_send(&packet, sizeof(SensorPacket));
+    profiler_record(PROFILE_PHASE_RF, t_start);
+    tx_failed = !sent;
+    if (sent) {
+        rf_link_time = millis();
+    } else {
+        rf_channel_fallback(millis());
+    }
 
-    // 初始化封包固定欄位
-    packet.version = PROTOCOL_VERSION;
+#if RF_TDMA
+    // 尚未取得時槽時發送失敗：隨機移動採樣相位，
+    // 避免與其他遠距端以相同週期、相同重傳間隔一再碰撞
+    if (!sent && !rf_slot_synced()) {
+        sched_shift(task_sample_id, (int16_t)random(1, config.sample_interval_ms));
+    }
+#endif
 
-    // 初始化完成
-    digitalWrite(LED_PIN, LOW);
-    system_ok = true;
-    last_sample_time = millis();
-}
+    if (telem_pending) {
+        telem_pending = false;
+        rf_send(&telem_packet, PACKET_SIZE);
+    }
 
-// ========== Main Loop ==========
-void loop() {
-    unsigned long now = millis();
+    // Base 經 ACK payload 送來的指令
+    RemoteCommand cmd;
+    if (rf_take_command(&cmd)) {
+        handle_remote_command(&cmd);
+    }
 
-    // 更新按鈕狀態（每次迴圈都要呼叫）
+    // 檢查 RF 連續失敗
+    if (rf_get_fail_count() >= RF_FAIL_THRESHOLD) {
+        // P0 修正：檢查重新初始化回傳值
+        rf_ok = rf_reinit();
+        rf_retry_time = millis();
+    }
+}
+
+// 按鈕去抖
+void task_button(void) {
     button_update();
+}
+
+// IMU 背景故障恢復（匯流排時脈恢復、重新初始化失敗的感測器）
+void task_imu_service(void) {
+    imu_service(millis());
+}
 
-    // 檢查採樣時間
-    if (now - last_sample_time < SAMPLE_INTERVAL_MS) {
-        return;  // 尚未到採樣時間
+// LED 狀態輸出
+// 閃爍碼: 1 閃 = MPU1 失敗, 2 閃 = MPU2 失敗, 3 閃 = RF 失敗（或兩顆 IMU 都失敗）
+// 常亮 = 上次發送未收到 ACK
+void task_led(void) {
+    uint32_t now = millis();
+    uint8_t pattern;
+    if (!rf_ok || imu_fault == 3) {
+        pattern = LED_PATTERN_BLINK_3;
+    } else if (imu_fault == 1) {
+        pattern = LED_PATTERN_BLINK_1;
+    } else if (imu_fault == 2) {
+        pattern = LED_PATTERN_BLINK_2;
+    } else if (tx_failed) {
+        pattern = LED_PATTERN_ON;
+    } else {
+        pattern = LED_PATTERN_OFF;
     }
-    last_sample_time = now;
+    led_pattern_set(&led, pattern, now);
+    LedGpio::write(led_pattern_update(&led, now));
+}
 
-    // 讀取雙 IMU
-    IMU_RawData imu1, imu2;
-    uint8_t imu_status = imu_read_both(&imu1, &imu2);
+// 填入健康狀態封包
+void fill_health_packet(HealthPacket* h) {
+    uint8_t status = imu_fault & (HEALTH_STATUS_MPU1_FAULT | HEALTH_STATUS_MPU2_FAULT);
+    if (!rf_ok) status |= HEALTH_STATUS_RF_FAULT;
+    if (imu_bus_recovering()) status |= HEALTH_STATUS_BUS_RECOVER;
 
-    // P0 修正：IMU 讀取錯誤處理
-    if (imu_status != 0) {
-        // 跳過此次發送，避免傳輸無效資料
-        digitalWrite(LED_PIN, HIGH);  // LED 指示錯誤
-        return;
+    h->type = PACKET_TYPE_HEALTH;
+    h->status = status;
+    h->seq = seq_counter;
+    h->seq_epoch = seq_epoch;
+    h->uptime_ms = millis();
+    h->retransmits = rf_get_retransmit_count();
+    h->tx_fail = rf_get_tx_fail_total();
+    h->rf_reinit = rf_get_reinit_count();
+    h->i2c_err1 = imu_get_error_count(0);
+    h->i2c_err2 = imu_get_error_count(1);
+    h->overruns = sched_get_task(task_sample_id)->deadline_miss;
+    h->bus_recoveries = imu_get_recovery_count();
+    h->reserved = 0;
+}
+
+// 遙測：輪流送出各階段耗時統計與健康狀態，並可選擇輸出排程統計
+void task_telemetry(void) {
+    if (telem_slot < PROFILE_PHASE_COUNT) {
+        profiler_fill_packet(telem_slot, &telem_packet.profile, millis());
+    } else {
+        fill_health_packet(&telem_packet.health);
     }
+    telem_pending = true;
+    if (++telem_slot > PROFILE_PHASE_COUNT) telem_slot = 0;
 
-    // 填充封包
-    packet.seq = seq_counter++;
-    packet.timestamp = now;
-    packet.button = button_get_state();
+#if DEBUG_SERIAL
+    for (uint8_t i = 0; i < sched_task_count(); i++) {
+        const Task* t = sched_get_task(i);
+        Serial.print(F("#task="));
+        Serial.print(i);
+        Serial.print(F(",runs="));
+        Serial.print(t->run_count);
+        Serial.print(F(",wcet_us="));
+        Serial.print(t->wcet_us);
+        Serial.print(F(",miss="));
+        Serial.println(t->deadline_miss);
+    }
+#endif
+}
 
-    // MPU1 資料
-    packet.mpu1_ax = imu1.ax;
-    packet.mpu1_ay = imu1.ay;
-    packet.mpu1_az = imu1.az;
-    packet.mpu1_gx = imu1.gx;
-    packet.mpu1_gy = imu1.gy;
-    packet.mpu1_gz = imu1.gz;
+// ========== Setup ==========
+void setup() {
+    // 初始化 LED
+    LedGpio::set_output();
+    LedGpio::high();  // 開機指示
 
-    // MPU2 資料
-    packet.mpu2_ax = imu2.ax;
-    packet.mpu2_ay = imu2.ay;
-    packet.mpu2_az = imu2.az;
-    packet.mpu2_gx = imu2.gx;
-    packet.mpu2_gy = imu2.gy;
-    packet.mpu2_gz = imu2.gz;
-
-    // 發送封包
-    bool sent = rf_send(&packet, sizeof(SensorPacket));
+#if DEBUG_SERIAL
+    Serial.begin(115200);
+    Serial.println(F("Mechtronic Remote Starting..."));
+#endif
 
-    // LED 指示發送狀態
-    digitalWrite(LED_PIN, sent ? LOW : HIGH);
+    // 讀取 EEPROM 組態：有效時跳過 WHO_AM_I 探測，直接套用組態開始採樣
+    bool fast_boot = config_load(&config, SAMPLE_INTERVAL_MS);
+    if (!fast_boot) {
+        config_defaults(&config, SAMPLE_INTERVAL_MS);
+    }
+    rf_channel_now = config.rf_channel;
+    rf_configure(config.rf_channel, config.rf_datarate);
 
-    // 檢查 RF 連續失敗
-    if (rf_get_fail_count() >= RF_FAIL_THRESHOLD) {
-        // P0 修正：檢查重新初始化回傳值
-        if (!rf_reinit()) {
-            // RF 無法恢復，進入錯誤狀態
-            while (1) {
-                error_blink(3);
-            }
-        }
+    // 初始化 IMU（失敗時繼續運作，由 LED 顯示故障碼）
+    if (fast_boot) {
+        imu_fault = imu_init_fast();
+    } else {
+        imu_fault = imu_init();  // 1=MPU1, 2=MPU2, 3=both
     }
+
+    // 初始化 RF（失敗時由無線任務定期重試）
+    rf_ok = rf_init();
+#if RF_TDMA
+    randomSeed(((uint32_t)REMOTE_PIPE << 16) ^ micros());  // 各遠距端的隨機相位須不同
+#endif
+    rf_retry_time = millis();
+    rf_link_time = rf_retry_time;
+
+    // 完整探測全部成功才寫入組態，下次開機走快速路徑
+    if (!fast_boot && imu_fault == 0 && rf_ok) {
+        config_save(&config);
+    }
+
+    // 初始化按鈕
+    button_init();
+
+    // 初始化封包固定欄位
+    packet.version = PROTOCOL_VERSION;
+
+    // 建立任務（優先權 0 最高；無線任務須在下一次採樣前完成）
+    sched_init();
+    task_sample_id      = sched_add(task_sample, config.sample_interval_ms, 0, 0);
+    task_radio_id       = sched_add(task_radio, 0, config.sample_interval_ms, 1);
+    task_button_id      = sched_add(task_button, BUTTON_PERIOD_MS, 0, 2);
+    task_imu_service_id = sched_add(task_imu_service, IMU_SERVICE_PERIOD_MS, 0, 3);
+    task_led_id         = sched_add(task_led, LED_PERIOD_MS, 0, 4);
+    task_telemetry_id   = sched_add(task_telemetry, TELEMETRY_PERIOD_MS, 0, 5);
+
+    // 初始化完成
+    LedGpio::low();
+    led_pattern_init(&led, LED_PATTERN_OFF, millis());
+    profiler_init(millis());
+    system_ok = true;
+    sched_start(millis());
+}
+
+// ========== Main Loop ==========
+void loop() {
+    sched_run();
 }
@@ -0,0 +1,103 @@
+#ifndef MPU6050_H
+#define MPU6050_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Wire.h>
+#include "imu_driver.h"
+#include "../common/imu_scale.h"
+
+// MPU6050 暫存器
+#define MPU6050_REG_CONFIG       0x1A  // DLPF_CFG；0x1B GYRO_CONFIG、0x1C ACCEL_CONFIG 緊接其後
+#define MPU6050_REG_ACCEL_XOUT_H 0x3B
+#define MPU6050_REG_PWR_MGMT_1   0x6B
+#define MPU6050_REG_WHO_AM_I     0x75
+
+#define MPU6050_WHO_AM_I_VALUE   0x68
+#define MPU6050_BURST_LEN        14    // AX AY AZ TEMP GX GY GZ，各 2 bytes
+
+// 編譯期特化的 MPU6050 驅動
+//
+// 位址、量程與 DLPF 皆為模板參數：
+//   - 組態暫存器值與比例尺在編譯期折疊為常數
+//   - 讀取路徑沒有依位址或量程的執行期分支
+//
+// 用法:
+//   typedef Mpu6050<0x68, IMU_GYRO_250DPS, IMU_ACCEL_2G, IMU_DLPF_260HZ> Imu1;
+//   Imu1::init();
+//   Imu1::read(&data);
+template <uint8_t ADDR, uint8_t GYRO_RANGE, uint8_t ACCEL_RANGE, uint8_t DLPF>
+struct Mpu6050 {
+    static_assert(ADDR == 0x68 || ADDR == 0x69, "MPU6050 address must be 0x68 or 0x69");
+    static_assert(GYRO_RANGE <= IMU_GYRO_2000DPS, "invalid gyro range");
+    static_assert(ACCEL_RANGE <= IMU_ACCEL_16G, "invalid accel range");
+    static_assert(DLPF <= IMU_DLPF_5HZ, "invalid DLPF setting");
+
+    static const uint8_t ADDRESS       = ADDR;
+    static const uint8_t REG_CONFIG    = DLPF;
+    static const uint8_t REG_GYRO_CFG  = imu_range_reg(GYRO_RANGE);
+    static const uint8_t REG_ACCEL_CFG = imu_range_reg(ACCEL_RANGE);
+
+    static constexpr float ACCEL_LSB_PER_G  = imu_accel_lsb_per_g(ACCEL_RANGE);
+    static constexpr float GYRO_LSB_PER_DPS = imu_gyro_lsb_per_dps(GYRO_RANGE);
+
+    // 檢查 WHO_AM_I
+    static bool probe(void) {
+        Wire.beginTransmission(ADDR);
+        Wire.write(MPU6050_REG_WHO_AM_I);
+        if (Wire.endTransmission(false) != 0) return false;
+
+        Wire.requestFrom(ADDR, (uint8_t)1);
+        if (Wire.available() < 1) return false;
+        return Wire.read() == MPU6050_WHO_AM_I_VALUE;
+    }
+
+    // 喚醒並寫入組態（CONFIG / GYRO_CONFIG / ACCEL_CONFIG 連續暫存器，一次 burst 寫入）
+    static bool configure(void) {
+        Wire.beginTransmission(ADDR);
+        Wire.write(MPU6050_REG_PWR_MGMT_1);
+        Wire.write((uint8_t)0x00);  // 清除 sleep bit
+        if (Wire.endTransmission() != 0) return false;
+
+        static const uint8_t cfg[4] = {
+            MPU6050_REG_CONFIG, REG_CONFIG, REG_GYRO_CFG, REG_ACCEL_CFG
+        };
+        Wire.beginTransmission(ADDR);
+        Wire.write(cfg, sizeof(cfg));
+        return Wire.endTransmission() == 0;
+    }
+
+    static bool init(void) {
+        return probe() && configure();
+    }
+
+    // 讀取 6 軸原始資料
+    static bool read(IMU_RawData* data) {
+        Wire.beginTransmission(ADDR);
+        Wire.write(MPU6050_REG_ACCEL_XOUT_H);
+        if (Wire.endTransmission(false) != 0) return false;
+
+        Wire.requestFrom(ADDR, (uint8_t)MPU6050_BURST_LEN);
+        if (Wire.available() < MPU6050_BURST_LEN) return false;
+
+        // 注意：MPU6050 是 Big-Endian
+        data->ax = read_be16();
+        data->ay = read_be16();
+        data->az = read_be16();
+        read_be16();  // 跳過溫度
+        data->gx = read_be16();
+        data->gy = read_be16();
+        data->gz = read_be16();
+        return true;
+    }
+
+private:
+    // 先讀高位元組再讀低位元組（避免 (read() << 8) | read() 的求值順序未定義）
+    static inline int16_t read_be16(void) {
+        uint8_t hi = (uint8_t)Wire.read();
+        uint8_t lo = (uint8_t)Wire.read();
+        return (int16_t)(((uint16_t)hi << 8) | lo);
+    }
+};
+
+#endif // MPU6050_H
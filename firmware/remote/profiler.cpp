@@ -0,0 +1,70 @@
+#include "profiler.h"
+#include <Arduino.h>
+
+static PhaseHistogram hist[PROFILE_PHASE_COUNT];
+static uint32_t window_start[PROFILE_PHASE_COUNT];
+
+static void clear_phase(uint8_t phase, uint32_t now_ms) {
+    PhaseHistogram* h = &hist[phase];
+    h->count = 0;
+    h->min_us = 0xFFFF;
+    h->max_us = 0;
+    for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) {
+        h->buckets[i] = 0;
+    }
+    window_start[phase] = now_ms;
+}
+
+// 耗時 → 分桶（右移計數，不用除法）
+static inline uint8_t bucket_of(uint16_t us) {
+    uint8_t b = 0;
+    uint16_t v = us >> PROFILE_BUCKET_SHIFT;
+    while (v != 0 && b < PROFILE_BUCKETS - 1) {
+        v >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void profiler_init(uint32_t now_ms) {
+    for (uint8_t i = 0; i < PROFILE_PHASE_COUNT; i++) {
+        clear_phase(i, now_ms);
+    }
+}
+
+void profiler_record(uint8_t phase, uint32_t start_us) {
+    if (phase >= PROFILE_PHASE_COUNT) return;
+
+    uint32_t elapsed = micros() - start_us;
+    uint16_t us = (elapsed > 0xFFFF) ? 0xFFFF : (uint16_t)elapsed;
+
+    PhaseHistogram* h = &hist[phase];
+    if (h->count < 0xFFFF) h->count++;
+    if (us < h->min_us) h->min_us = us;
+    if (us > h->max_us) h->max_us = us;
+
+    uint8_t b = bucket_of(us);
+    if (h->buckets[b] < 0xFFFF) h->buckets[b]++;
+}
+
+const PhaseHistogram* profiler_get(uint8_t phase) {
+    return (phase < PROFILE_PHASE_COUNT) ? &hist[phase] : 0;
+}
+
+void profiler_fill_packet(uint8_t phase, ProfilePacket* pkt, uint32_t now_ms) {
+    if (phase >= PROFILE_PHASE_COUNT) return;
+
+    const PhaseHistogram* h = &hist[phase];
+    pkt->type = PACKET_TYPE_PROFILE;
+    pkt->phase = phase;
+    pkt->count = h->count;
+    pkt->min_us = (h->count != 0) ? h->min_us : 0;
+    pkt->max_us = h->max_us;
+    for (uint8_t i = 0; i < PROFILE_BUCKETS; i++) {
+        pkt->buckets[i] = h->buckets[i];
+    }
+    pkt->window_ms = now_ms - window_start[phase];
+    pkt->timestamp = now_ms;
+
+    clear_phase(phase, now_ms);
+}
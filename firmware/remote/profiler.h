@@ -0,0 +1,33 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include "../common/packet.h"
+
+// 迴圈階段耗時統計（micros() 量測）
+//
+// 每個階段保留 min / max / 次數與對數分桶直方圖，
+// 以 ProfilePacket 遙測封包送出後清除，下個區間重新統計。
+
+typedef struct {
+    uint16_t count;
+    uint16_t min_us;
+    uint16_t max_us;
+    uint16_t buckets[PROFILE_BUCKETS];
+} PhaseHistogram;
+
+// 清除所有階段統計
+void profiler_init(uint32_t now_ms);
+
+// 記錄一次階段耗時
+// phase: PROFILE_PHASE_*
+// start_us: 該階段開始時的 micros()
+void profiler_record(uint8_t phase, uint32_t start_us);
+
+// 取得階段統計（唯讀）
+const PhaseHistogram* profiler_get(uint8_t phase);
+
+// 將階段統計填入遙測封包，並清除該階段
+void profiler_fill_packet(uint8_t phase, ProfilePacket* pkt, uint32_t now_ms);
+
+#endif
@@ -1,31 +1,69 @@
 #include "rf_link.h"
 #include <SPI.h>
 #include <RF24.h>
+#include <string.h>
+#include "../common/rf_address.h"
+#include "../common/tdma.h"
 
 // RF24 物件
 static RF24 radio(RF_CE_PIN, RF_CSN_PIN);
 
-// 發送管道位址 (5 bytes)
-static const uint8_t tx_addr[5] = {'M','E','C','H','1'};
+// 頻道與速率
+static uint8_t rf_channel = RF_CHANNEL;
+static uint8_t rf_datarate = RF_DATARATE;
 
 // 失敗計數
 static uint16_t fail_count = 0;
 
+// 累計計數
+static uint32_t retransmit_total = 0;
+static uint32_t tx_fail_total = 0;
+static uint16_t reinit_count = 0;
+
+// TDMA 時槽狀態
+static bool slot_synced = false;
+static uint32_t slot_next_us = 0;      // 下一個時槽開始（發送時間）
+
+// 最近的發送紀錄（tag → 發送時間）
+typedef struct {
+    uint8_t  tag;
+    bool     valid;
+    uint32_t t_us;
+} TxRecord;
+
+static TxRecord tx_history[RF_TDMA_HISTORY];
+static uint8_t tx_history_pos = 0;     // 最新一筆
+
+// Base 指令（ACK payload）
+static RemoteCommand command;
+static bool command_pending = false;
+
 bool rf_init(void) {
     if (!radio.begin()) {
         return false;
     }
 
     // 設定參數
-    radio.setChannel(RF_CHANNEL);
-    radio.setDataRate(RF24_250KBPS);
-    radio.setPALevel(RF24_PA_LOW);
-    radio.setRetries(RF_RETRY_DELAY, RF_RETRY_COUNT);
-    radio.setPayloadSize(32);
+    radio.setChannel(rf_channel);
+    radio.setDataRate((rf24_datarate_e)rf_datarate);
+    radio.setPALevel(RF_PA_LEVEL);
+    radio.setPayloadSize(RF_PAYLOAD_SIZE);
     radio.setAutoAck(true);
-    radio.setCRCLength(RF24_CRC_16);
+    radio.setCRCLength(RF_CRC_LENGTH);
+#if RF_TDMA
+    // 時槽同步由 Base 的 ACK payload 帶回（需動態長度）
+    radio.setRetries(RF_TDMA_RETRY_DELAY, RF_TDMA_RETRY_COUNT);
+    radio.enableDynamicPayloads();
+    radio.enableAckPayload();
+    slot_synced = false;
+    for (uint8_t i = 0; i < RF_TDMA_HISTORY; i++) tx_history[i].valid = false;
+#else
+    radio.setRetries(RF_RETRY_DELAY, RF_RETRY_COUNT);
+#endif
 
-    // 開啟發送管道
+    // 開啟發送管道（Base 依管道號碼區分遠距端）
+    uint8_t tx_addr[5];
+    rf_pipe_address(REMOTE_PIPE, tx_addr);
     radio.openWritingPipe(tx_addr);
     radio.stopListening();  // TX 模式
 
@@ -33,11 +71,99 @@ bool rf_init(void) {
     return true;
 }
 
+void rf_configure(uint8_t channel, uint8_t datarate) {
+    rf_channel = channel;
+    rf_datarate = datarate;
+}
+
+// 套用 Base 的時槽修正：找回被量測封包的發送時間，下一個時槽 = 該時間 + 修正 + n 個時框
+static void apply_sync(const TdmaSync* sync) {
+    for (uint8_t i = 0; i < RF_TDMA_HISTORY; i++) {
+        const TxRecord* r = &tx_history[i];
+        if (!r->valid || r->tag != sync->tag) continue;
+
+        uint32_t last_us = tx_history[tx_history_pos].t_us;
+        uint32_t next_us = r->t_us + (int32_t)sync->offset_us;
+        while ((int32_t)(next_us - last_us) < (int32_t)(TDMA_FRAME_US / 2)) {
+            next_us += TDMA_FRAME_US;
+        }
+        slot_next_us = next_us;
+        slot_synced = true;
+        return;
+    }
+}
+
+// 讀取 ACK payload
+static void read_ack_payload(void) {
+    while (radio.available()) {
+        uint8_t len = radio.getDynamicPayloadSize();
+        if (len == 0 || len > 32) {
+            radio.flush_rx();  // 長度錯誤的封包
+            return;
+        }
+        uint8_t buf[32];
+        radio.read(buf, len);
+        if (buf[0] == TDMA_ACK_SYNC && len >= sizeof(TdmaSync)) {
+            TdmaSync sync;
+            memcpy(&sync, buf, sizeof(sync));
+            apply_sync(&sync);
+        } else if (buf[0] == REMOTE_CMD_TYPE && len >= sizeof(RemoteCommand)) {
+            memcpy(&command, buf, sizeof(command));
+            command_pending = true;
+        }
+    }
+}
+
+bool rf_take_command(RemoteCommand* cmd) {
+    if (!command_pending) return false;
+    *cmd = command;
+    command_pending = false;
+    return true;
+}
+
+int32_t rf_slot_wait_us(uint32_t now_us) {
+    if (!slot_synced) return 0;
+    return (int32_t)(slot_next_us - now_us);
+}
+
+void rf_slot_begin(uint8_t tag, uint32_t now_us) {
+    tx_history_pos = (uint8_t)((tx_history_pos + 1) % RF_TDMA_HISTORY);
+    TxRecord* r = &tx_history[tx_history_pos];
+    r->tag = tag;
+    r->valid = true;
+    r->t_us = now_us;
+
+    // 推進到本次發送之後的時槽（未同步時以本次發送為基準）
+    if (!slot_synced) {
+        slot_next_us = now_us + TDMA_FRAME_US;
+        return;
+    }
+    rf_slot_skip(now_us);
+}
+
+void rf_slot_skip(uint32_t now_us) {
+    while ((int32_t)(slot_next_us - now_us) < (int32_t)(TDMA_FRAME_US / 2)) {
+        slot_next_us += TDMA_FRAME_US;
+    }
+}
+
+bool rf_slot_synced(void) {
+    return slot_synced;
+}
+
 bool rf_send(const void* data, uint8_t len) {
     bool ok = radio.write(data, len);
+    retransmit_total += radio.getARC();
+#if RF_TDMA
+    if (ok) read_ack_payload();
+#endif
 
     if (!ok) {
         fail_count++;
+        tx_fail_total++;
+#if RF_TDMA
+        if (fail_count >= RF_TDMA_UNSYNC_FAILS) slot_synced = false;
+#endif
     } else {
         fail_count = 0;  // 成功則重置
     }
@@ -49,11 +175,24 @@ uint16_t rf_get_fail_count(void) {
     return fail_count;
 }
 
+uint32_t rf_get_retransmit_count(void) {
+    return retransmit_total;
+}
+
+uint32_t rf_get_tx_fail_total(void) {
+    return tx_fail_total;
+}
+
+uint16_t rf_get_reinit_count(void) {
+    return reinit_count;
+}
+
 void rf_reset_fail_count(void) {
     fail_count = 0;
 }
 
 bool rf_reinit(void) {
+    if (reinit_count < 0xFFFF) reinit_count++;
     radio.powerDown();
     delay(10);
     return rf_init();
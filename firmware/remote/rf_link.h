@@ -3,18 +3,31 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "../common/remote_command.h"
+#include "../common/nrf24_config.h"
 
 // nRF24 腳位
 #define RF_CE_PIN   9
 #define RF_CSN_PIN  10
 
-// 無線參數
-#define RF_CHANNEL     76
-#define RF_DATARATE    RF24_250KBPS
-#define RF_PA_LEVEL    RF24_PA_LOW
+// 無線參數（頻道、速率、TDMA 開關等與 Base 共用，見 common/nrf24_config.h）
 #define RF_RETRY_DELAY 5
 #define RF_RETRY_COUNT 15
 
+// 發送管道（1-5 或 0），同一 Base 下每個遠距端須不同（位址見 common/rf_address.h）
+#ifndef REMOTE_PIPE
+#define REMOTE_PIPE    1
+#endif
+
+// TDMA 時槽（RF_TDMA 開啟時，協議見 common/tdma.h）
+#define RF_TDMA_RETRY_DELAY  2    // 750us：重傳留在自己的時槽內
+#define RF_TDMA_RETRY_COUNT  2
+#define RF_TDMA_HISTORY      4    // 保留最近幾次發送時間，用來對應 Base 的量測
+#define RF_TDMA_UNSYNC_FAILS 10   // 連續失敗幾次視為失去同步（時槽已被重新分配或 Base 重啟）
+
+// 設定頻道與速率（下次 rf_init / rf_reinit 生效，預設 RF_CHANNEL / RF_DATARATE）
+void rf_configure(uint8_t channel, uint8_t datarate);
+
 // 初始化 nRF24L01+ (TX 模式)
 // 回傳: true=成功, false=失敗
 bool rf_init(void);
@@ -28,10 +41,34 @@ bool rf_send(const void* data, uint8_t len);
 // 取得連續失敗次數
 uint16_t rf_get_fail_count(void);
 
+// 累計計數（開機後，不受 rf_reset_fail_count / rf_reinit 影響）
+uint32_t rf_get_retransmit_count(void);  // 自動重傳次數總和
+uint32_t rf_get_tx_fail_total(void);     // 發送失敗總數
+uint16_t rf_get_reinit_count(void);      // rf_reinit() 次數
+
 // 重置失敗計數
 void rf_reset_fail_count(void);
 
 // 重新初始化（故障復原用）
 bool rf_reinit(void);
 
+// 取出 Base 經 ACK payload 送來的指令（需 RF_TDMA）
+// 回傳: false = 沒有待處理的指令
+bool rf_take_command(RemoteCommand* cmd);
+
+// ========== TDMA 時槽 ==========
+
+// 距離下一個時槽開始的時間 (us，負 = 已過)；尚未收到 Base 同步時回傳 0（立即發送）
+int32_t rf_slot_wait_us(uint32_t now_us);
+
+// 每個時框送出感測封包前呼叫：記錄發送時間並推進到下一個時槽
+// tag: 感測封包序號低位元組（Base 量測後原樣回傳）
+void rf_slot_begin(uint8_t tag, uint32_t now_us);
+
+// 本時框不發送（錯過時槽）：推進到下一個時槽
+void rf_slot_skip(uint32_t now_us);
+
+// 是否已與 Base 同步
+bool rf_slot_synced(void);
+
 #endif
@@ -0,0 +1,120 @@
+#include "scheduler.h"
+#include <Arduino.h>
+
+static Task tasks[SCHED_MAX_TASKS];
+static uint8_t task_count = 0;
+
+// 時間比較（處理 millis() 溢位）
+static inline bool time_reached(uint32_t now, uint32_t t) {
+    return (int32_t)(now - t) >= 0;
+}
+
+void sched_init(void) {
+    task_count = 0;
+}
+
+uint8_t sched_add(TaskFn fn, uint16_t period_ms, uint16_t deadline_ms, uint8_t priority) {
+    if (task_count >= SCHED_MAX_TASKS || fn == 0) {
+        return SCHED_INVALID_ID;
+    }
+
+    Task* t = &tasks[task_count];
+    t->fn = fn;
+    t->period_ms = period_ms;
+    t->deadline_ms = (deadline_ms != 0) ? deadline_ms : period_ms;
+    t->priority = priority;
+    t->released = false;
+    t->release_ms = 0;
+    t->next_release_ms = 0;
+    t->run_count = 0;
+    t->deadline_miss = 0;
+    t->last_us = 0;
+    t->wcet_us = 0;
+
+    return task_count++;
+}
+
+void sched_start(uint32_t now_ms) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        tasks[i].released = false;
+        tasks[i].next_release_ms = now_ms;
+    }
+}
+
+void sched_trigger(uint8_t id) {
+    if (id >= task_count || tasks[id].released) return;
+    tasks[id].released = true;
+    tasks[id].release_ms = millis();
+}
+
+void sched_shift(uint8_t id, int16_t delta_ms) {
+    if (id >= task_count || tasks[id].period_ms == 0) return;
+    tasks[id].next_release_ms += (int32_t)delta_ms;
+}
+
+// 釋放到期的週期任務
+static void release_due(uint32_t now) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        Task* t = &tasks[i];
+        if (t->period_ms == 0 || t->released) continue;
+        if (!time_reached(now, t->next_release_ms)) continue;
+
+        t->released = true;
+        t->release_ms = t->next_release_ms;
+        t->next_release_ms += t->period_ms;
+
+        // 落後超過一個週期：跳過錯過的釋放，避免補跑造成連鎖延遲
+        while (time_reached(now, t->next_release_ms)) {
+            t->next_release_ms += t->period_ms;
+            if (t->deadline_miss < 0xFFFF) t->deadline_miss++;
+        }
+    }
+}
+
+uint8_t sched_run(void) {
+    release_due(millis());
+
+    // 選出優先權最高的已釋放任務（同優先權取先加入者）
+    uint8_t best = SCHED_INVALID_ID;
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (!tasks[i].released) continue;
+        if (best == SCHED_INVALID_ID || tasks[i].priority < tasks[best].priority) {
+            best = i;
+        }
+    }
+    if (best == SCHED_INVALID_ID) return SCHED_INVALID_ID;
+
+    Task* t = &tasks[best];
+    t->released = false;
+
+    uint32_t start_us = micros();
+    t->fn();
+    uint32_t elapsed_us = micros() - start_us;
+
+    t->last_us = (elapsed_us > 0xFFFF) ? 0xFFFF : (uint16_t)elapsed_us;
+    if (t->last_us > t->wcet_us) t->wcet_us = t->last_us;
+    t->run_count++;
+
+    if (!time_reached(t->release_ms + t->deadline_ms, millis())) {
+        if (t->deadline_miss < 0xFFFF) t->deadline_miss++;
+    }
+
+    return best;
+}
+
+const Task* sched_get_task(uint8_t id) {
+    return (id < task_count) ? &tasks[id] : 0;
+}
+
+uint8_t sched_task_count(void) {
+    return task_count;
+}
+
+void sched_reset_stats(void) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        tasks[i].run_count = 0;
+        tasks[i].deadline_miss = 0;
+        tasks[i].last_us = 0;
+        tasks[i].wcet_us = 0;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 合作式排程器（單執行緒，任務不可阻塞）
+//
+// - 週期任務：每 period_ms 釋放一次，釋放時間固定累加（不隨執行延遲漂移）
+// - 事件任務：period_ms = 0，只在 sched_trigger() 時釋放
+// - 每次 sched_run() 只執行「已釋放且優先權最高」的一個任務，結果可預期
+// - 完成時間超過 釋放時間 + deadline_ms 記為 deadline miss；
+//   落後超過一個週期時跳過錯過的釋放並一併計入
+
+#define SCHED_MAX_TASKS  8
+#define SCHED_INVALID_ID 0xFF
+
+typedef void (*TaskFn)(void);
+
+// 任務控制區塊
+typedef struct {
+    TaskFn   fn;              // 任務函數
+    uint16_t period_ms;       // 週期 (0 = 事件任務)
+    uint16_t deadline_ms;     // 相對期限 (ms)
+    uint8_t  priority;        // 優先權 (0 = 最高)
+    bool     released;        // 是否已釋放待執行
+    uint32_t release_ms;      // 本次釋放時間
+    uint32_t next_release_ms; // 下次釋放時間（週期任務）
+
+    // 統計
+    uint32_t run_count;       // 執行次數
+    uint16_t deadline_miss;   // 錯過期限次數
+    uint16_t last_us;         // 上次執行時間 (us)
+    uint16_t wcet_us;         // 最壞執行時間 (us，飽和於 65535)
+} Task;
+
+// 清空任務表
+void sched_init(void);
+
+// 新增任務
+// period_ms: 週期 (0 = 事件任務)
+// deadline_ms: 相對期限 (0 = 與週期相同)
+// priority: 0 = 最高
+// 回傳: 任務 ID，或 SCHED_INVALID_ID（任務表已滿）
+uint8_t sched_add(TaskFn fn, uint16_t period_ms, uint16_t deadline_ms, uint8_t priority);
+
+// 以 now_ms 為起點釋放所有週期任務
+void sched_start(uint32_t now_ms);
+
+// 立即釋放任務（事件任務或提前執行週期任務）
+void sched_trigger(uint8_t id);
+
+// 移動週期任務的相位（下次釋放時間加上 delta_ms，可為負）
+void sched_shift(uint8_t id, int16_t delta_ms);
+
+// 執行一個到期任務（每個主迴圈呼叫）
+// 回傳: 執行的任務 ID，無任務時回傳 SCHED_INVALID_ID
+uint8_t sched_run(void);
+
+// 取得任務資訊（統計用）
+const Task* sched_get_task(uint8_t id);
+uint8_t sched_task_count(void);
+
+// 清除所有任務的統計
+void sched_reset_stats(void);
+
+#endif
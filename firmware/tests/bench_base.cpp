@@ -0,0 +1,81 @@
+// Base 主迴圈效能量測
+//
+//   bench_base [秒數]      預設 10 秒虛擬時間
+//
+// 6 個遠距端 × 100Hz 輸入，依序量測各輸出模式在 115200 與 1 Mbaud 下：
+//   host ns/loop   每圈 loop() 的主機耗時（比較改版前後的相對變化，不代表 AVR 上的絕對值）
+//   host ns/pkt    每筆封包的主機耗時（含格式化與輸出）
+//   wire%          Serial 線路使用率（虛擬時間）
+//   dropped        uart 丟棄的記錄數（整行 / 整個框架）
+//   rx_ovf         接收環形緩衝溢位 + nRF24 RX FIFO 滿而未收到的封包
+#include <Arduino.h>
+#include "sim.h"
+#include "feed.h"
+#include "../base/uart.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+static void run(const char* mode_name, uint32_t baud, uint32_t seconds) {
+    UartStats before;
+    uart_get_stats(&before);
+    uint16_t ovf_before = rf_get_rx_overflow();
+    uint32_t fifo_before = hal_radio_rx_dropped();
+    uint32_t packets = 0;
+    for (uint8_t p = 0; p < RF_PIPE_COUNT; p++) packets -= feed_seq[p];
+    hal_serial_clear();
+
+    feed_start(RF_PIPE_COUNT);
+    uint64_t t0 = hal_now_us();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint32_t loops = sim_run_for(seconds * 1000000UL, feed_tick);
+    double host_ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    double virt_s = (double)(hal_now_us() - t0) / 1e6;
+
+    for (uint8_t p = 0; p < RF_PIPE_COUNT; p++) packets += feed_seq[p];
+    size_t bytes;
+    hal_serial_output(&bytes);
+    UartStats after;
+    uart_get_stats(&after);
+
+    printf("%-6s %8lu %9u %13.1f %12.1f %9zu %6.1f%% %8lu %7lu\n",
+           mode_name, (unsigned long)baud, loops, host_ns / loops, host_ns / packets, bytes,
+           (double)bytes * 10 / baud / virt_s * 100,
+           (unsigned long)(after.records_dropped - before.records_dropped),
+           (unsigned long)(rf_get_rx_overflow() - ovf_before + hal_radio_rx_dropped() - fifo_before));
+}
+
+// 以新鮑率回覆並切換，再確認
+static void switch_baud(uint32_t baud) {
+    char cmd[16];
+    snprintf(cmd, sizeof(cmd), "!B%lu", (unsigned long)baud);
+    sim_command(cmd);
+    sim_run_for(50000, 0);
+    sim_command("!K");
+    sim_run_for(50000, 0);
+}
+
+int main(int argc, char** argv) {
+    uint32_t seconds = argc > 1 ? (uint32_t)atol(argv[1]) : 10;
+    if (seconds == 0) seconds = 1;
+
+    hal_reset(0);
+    setup();
+    sim_run_for(50000, 0);
+
+    static const char* const MODES[] = { "csv", "binary", "hex" };
+    static const uint32_t BAUDS[] = { 115200, 1000000 };
+    printf("%-6s %8s %9s %13s %12s %9s %7s %8s %7s\n",
+           "mode", "baud", "loops", "host ns/loop", "host ns/pkt", "bytes", "wire%", "dropped", "rx_ovf");
+    for (uint8_t b = 0; b < 2; b++) {
+        if (BAUDS[b] != hal_serial_baud()) switch_baud(BAUDS[b]);
+        for (uint8_t m = 0; m < 3; m++) {
+            char cmd[4] = { '!', 'M', (char)('0' + m), '\0' };
+            sim_command(cmd);
+            sim_run_for(50000, 0);
+            run(MODES[m], BAUDS[b], seconds);
+        }
+    }
+    return 0;
+}
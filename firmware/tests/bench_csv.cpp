@@ -0,0 +1,63 @@
+// CSV 行格式化微基準
+//
+//   bench_csv [筆數]       預設 200000 筆
+//
+// 同一組封包（邊界值 + 亂數）分別以改版前逐欄 print 路徑（Print::printNumber，每位數一次除法）
+// 與 csv_format_sensor 格式化，輸出每行主機耗時、print 路徑每行的 32-bit 除法次數與耗時比值。
+// 主機有硬體除法，耗時比值不代表 ATmega328P（沒有除法指令，每次除法為一次 __udivmodsi4 呼叫）；
+// 用於比較 csv_format 改版前後的相對變化，AVR 上的差距以 div/line 估計。
+#include "legacy_print.h"
+#include "../base/csv_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+
+typedef struct {
+    SensorPacket p;
+    uint8_t pipe;
+    uint32_t t_base_us;
+} Sample;
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    uint32_t count = argc > 1 ? (uint32_t)atol(argv[1]) : 200000;
+    if (count < LEGACY_EDGE_COUNT) count = LEGACY_EDGE_COUNT;
+
+    std::vector<Sample> samples(count);
+    uint32_t rng = 1;
+    for (uint32_t i = 0; i < count; i++) {
+        legacy_packet(i, &rng, &samples[i].p, &samples[i].pipe, &samples[i].t_base_us);
+    }
+
+    // 兩種路徑都累計輸出位元組，避免被最佳化掉
+    size_t legacy_bytes = 0;
+    LegacyPrint legacy;
+    legacy.out.reserve(CSV_LINE_MAX);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; i++) {
+        legacy.out.clear();
+        legacy_csv_line(&legacy, &samples[i].p, samples[i].pipe, samples[i].t_base_us);
+        legacy_bytes += legacy.out.size();
+    }
+    double legacy_ns = elapsed_ns(start);
+
+    size_t format_bytes = 0;
+    char line[CSV_LINE_MAX];
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; i++) {
+        format_bytes += csv_format_sensor(line, &samples[i].p, samples[i].pipe, samples[i].t_base_us);
+    }
+    double format_ns = elapsed_ns(start);
+
+    printf("%-8s %10s %12s %10s %9s\n", "path", "lines", "host ns/line", "bytes", "div/line");
+    printf("%-8s %10u %12.1f %10zu %9.1f\n", "print", count, legacy_ns / count, legacy_bytes,
+           (double)legacy.divisions / count);
+    printf("%-8s %10u %12.1f %10zu %9.1f\n", "format", count, format_ns / count, format_bytes, 0.0);
+    printf("host time print/format = %.2f\n", legacy_ns / format_ns);
+    return legacy_bytes == format_bytes ? 0 : 1;
+}
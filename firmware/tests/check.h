@@ -0,0 +1,52 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+// 最小測試框架：失敗時印出位置並計數，不中止（一次看到所有失敗）
+//
+// 韌體模組有靜態狀態，每個情境在獨立行程執行：
+//   test_base <情境>      執行單一情境（ctest 逐一註冊，見 CMakeLists.txt）
+//   test_base             列出所有情境
+
+static int check_failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        check_failures++; \
+    } \
+} while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long va_ = (long long)(a), vb_ = (long long)(b); \
+    if (va_ != vb_) { \
+        fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                __FILE__, __LINE__, #a, #b, va_, vb_); \
+        check_failures++; \
+    } \
+} while (0)
+
+typedef struct {
+    const char* name;
+    void (*fn)(void);
+} TestCase;
+
+static int check_main(int argc, char** argv, const TestCase* cases, size_t count) {
+    if (argc < 2) {
+        for (size_t i = 0; i < count; i++) printf("%s\n", cases[i].name);
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(cases[i].name, argv[1]) != 0) continue;
+        cases[i].fn();
+        if (check_failures) fprintf(stderr, "%s: %d check(s) failed\n", argv[1], check_failures);
+        return check_failures ? 1 : 0;
+    }
+    fprintf(stderr, "unknown case: %s\n", argv[1]);
+    return 2;
+}
+
+#endif
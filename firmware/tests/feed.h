@@ -0,0 +1,69 @@
+#ifndef FEED_H
+#define FEED_H
+
+#include <stdint.h>
+#include <string.h>
+#include "hal.h"
+#include "../common/packet.h"
+#include "../common/remote_command.h"
+#include "../base/rf_receiver.h"
+
+// Base 的無線輸入：模擬多個遠距端（測試與效能量測共用）
+
+static inline SensorPacket make_sensor(uint16_t seq, uint32_t timestamp, uint8_t flags, int16_t base) {
+    SensorPacket p;
+    memset(&p, 0, sizeof(p));
+    p.version = PROTOCOL_VERSION;
+    p.seq = seq;
+    p.timestamp = timestamp;
+    p.flags = flags;
+    for (uint8_t i = 0; i < 12; i++) {
+        int16_t v = (int16_t)(base + i);
+        memcpy((uint8_t*)&p + 8 + i * 2, &v, sizeof(v));
+    }
+    return p;
+}
+
+// 遠距端封包送達 Base（工作頻道）
+// 回傳: ACK payload 長度，-1 = 未收到
+static inline int8_t deliver(uint8_t pipe, const void* pkt, uint8_t* ack) {
+    return hal_radio_deliver(RF_CHANNEL, pipe, pkt, PACKET_SIZE, ack);
+}
+
+// 多個遠距端以 100Hz 發送（每個時框平均錯開），記錄各管道最後一筆 ACK payload
+#define FEED_FRAME_US 10000
+static uint8_t feed_pipes = 0;
+static uint16_t feed_seq[RF_PIPE_COUNT];
+static uint64_t feed_next_us[RF_PIPE_COUNT];
+static uint8_t feed_ack[RF_PIPE_COUNT][32];
+static int8_t feed_ack_len[RF_PIPE_COUNT];
+static uint8_t feed_commands[RF_PIPE_COUNT];   // 收到的遠距端指令 ACK payload 數
+static uint32_t feed_missed = 0;               // 未被 Base 收到的封包數
+
+// 開始發送（序號接續上一次，Base 不會當成重複封包）
+static inline void feed_start(uint8_t pipes) {
+    feed_pipes = pipes;
+    for (uint8_t p = 0; p < pipes; p++) {
+        feed_next_us[p] = hal_now_us() + 1000 + (uint64_t)p * FEED_FRAME_US / pipes;
+        feed_ack_len[p] = 0;
+        feed_commands[p] = 0;
+    }
+}
+
+static inline void feed_tick(uint64_t now_us) {
+    for (uint8_t p = 0; p < feed_pipes; p++) {
+        if (now_us < feed_next_us[p]) continue;
+        feed_next_us[p] += FEED_FRAME_US;
+        SensorPacket pkt = make_sensor(feed_seq[p], (uint32_t)(now_us / 1000), 0xC0, (int16_t)(p * 100));
+        int8_t n = deliver(p, &pkt, feed_ack[p]);
+        if (n < 0) {
+            feed_missed++;
+            continue;
+        }
+        feed_ack_len[p] = n;
+        if (n == sizeof(RemoteCommand) && feed_ack[p][0] == REMOTE_CMD_TYPE) feed_commands[p]++;
+        feed_seq[p]++;
+    }
+}
+
+#endif
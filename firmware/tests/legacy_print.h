@@ -0,0 +1,152 @@
+#ifndef LEGACY_PRINT_H
+#define LEGACY_PRINT_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include "../common/packet.h"
+#include "../common/rf_address.h"
+
+// 改版前的 CSV 輸出路徑（逐欄 Serial.print），作為 csv_format_sensor 的對照
+//
+// LegacyPrint 依 Arduino AVR core 的 Print::print / printNumber 實作（每位數一次除法），
+// 型別寬度依 AVR：int = int16_t 經 print(long) 輸出，unsigned int 經 print(unsigned long)。
+
+struct LegacyPrint {
+    std::string out;
+    uint32_t divisions;   // 32-bit 除法次數（AVR 上每次呼叫 __udivmodsi4）
+
+    LegacyPrint() : divisions(0) {}
+
+    size_t write(uint8_t c) {
+        out.push_back((char)c);
+        return 1;
+    }
+
+    size_t write(const char* s) {
+        size_t n = 0;
+        while (*s) n += write((uint8_t)*s++);
+        return n;
+    }
+
+    // Print::printNumber
+    size_t printNumber(uint32_t n, uint8_t base) {
+        char buf[8 * sizeof(int32_t) + 1];
+        char* str = &buf[sizeof(buf) - 1];
+        *str = '\0';
+        if (base < 2) base = 10;
+        do {
+            char c = (char)(n % base);
+            n /= base;
+            divisions++;
+            *--str = c < 10 ? c + '0' : c + 'A' - 10;
+        } while (n);
+        return write(str);
+    }
+
+    size_t print(char c) { return write((uint8_t)c); }
+
+    // Print::print(long, int)
+    size_t print(int32_t n) {
+        if (n < 0) {
+            size_t t = print('-');
+            return printNumber(0UL - (uint32_t)n, 10) + t;
+        }
+        return printNumber((uint32_t)n, 10);
+    }
+
+    size_t print(uint32_t n) { return printNumber(n, 10); }
+
+    size_t println(void) { return write("\r\n"); }
+
+    template <typename T>
+    size_t println(T value) {
+        size_t n = print(value);
+        return n + println();
+    }
+};
+
+// 改版前 print_csv_line 的呼叫序列（加上 user-045 的 pipe、t_base_us 欄位）
+// 參數型別照 AVR 的整數提升：uint16_t → unsigned int、int16_t / flags 運算 → int
+static inline void legacy_csv_line(LegacyPrint* s, const SensorPacket* p, uint8_t pipe, uint32_t t_base_us) {
+    s->print((uint32_t)p->seq);
+    s->print(',');
+    s->print((uint32_t)p->timestamp);
+    s->print(',');
+    s->print((int32_t)(p->flags & PACKET_FLAG_BUTTON));
+    s->print(',');
+    // MPU1
+    s->print((int32_t)p->mpu1_ax);
+    s->print(',');
+    s->print((int32_t)p->mpu1_ay);
+    s->print(',');
+    s->print((int32_t)p->mpu1_az);
+    s->print(',');
+    s->print((int32_t)p->mpu1_gx);
+    s->print(',');
+    s->print((int32_t)p->mpu1_gy);
+    s->print(',');
+    s->print((int32_t)p->mpu1_gz);
+    s->print(',');
+    // MPU2
+    s->print((int32_t)p->mpu2_ax);
+    s->print(',');
+    s->print((int32_t)p->mpu2_ay);
+    s->print(',');
+    s->print((int32_t)p->mpu2_az);
+    s->print(',');
+    s->print((int32_t)p->mpu2_gx);
+    s->print(',');
+    s->print((int32_t)p->mpu2_gy);
+    s->print(',');
+    s->print((int32_t)p->mpu2_gz);
+    s->print(',');
+    s->print((int32_t)(p->flags >> 6));
+    s->print(',');
+    s->print((uint32_t)pipe);
+    s->print(',');
+    s->println(t_base_us);
+}
+
+// 測試用亂數（LCG，可重現）
+static inline uint32_t legacy_rand(uint32_t* state) {
+    *state = *state * 1664525UL + 1013904223UL;
+    return *state;
+}
+
+// 第 i 筆測試封包：前面是邊界值組合，之後為亂數
+// 邊界：int16 -32768 / -1 / 0 / 1 / 32767，u16 / u32 分界 65535 / 65536，UINT32_MAX
+#define LEGACY_EDGE_COUNT 8
+
+static inline void legacy_packet(uint32_t i, uint32_t* rng, SensorPacket* p, uint8_t* pipe, uint32_t* t_base_us) {
+    static const int16_t AXES[5] = { -32768, -1, 0, 1, 32767 };
+    static const uint32_t TIMES[LEGACY_EDGE_COUNT] = {
+        0, 9, 10, 65535, 65536, 99999, 100000, 0xFFFFFFFFUL
+    };
+    p->version = PROTOCOL_VERSION;
+    if (i < LEGACY_EDGE_COUNT) {
+        p->seq = (i & 1) ? 0xFFFF : (uint16_t)i;
+        p->timestamp = TIMES[i];
+        p->flags = (uint8_t)((i & 1) | ((i << 5) & 0xC0));   // btn 與 valid 各種組合
+        uint8_t* axes = (uint8_t*)p + 8;
+        for (uint8_t a = 0; a < 12; a++) {
+            int16_t v = AXES[(a + i) % 5];
+            memcpy(axes + a * 2, &v, sizeof(v));
+        }
+        *pipe = (uint8_t)(i % RF_PIPE_COUNT);
+        *t_base_us = TIMES[LEGACY_EDGE_COUNT - 1 - i];
+        return;
+    }
+    uint8_t raw[PACKET_SIZE];
+    for (uint8_t b = 0; b < PACKET_SIZE; b++) raw[b] = (uint8_t)(legacy_rand(rng) >> 24);
+    memcpy(p, raw, PACKET_SIZE);
+    p->version = PROTOCOL_VERSION;
+    p->flags &= PACKET_FLAG_BUTTON | PACKET_FLAG_MPU1_VALID | PACKET_FLAG_MPU2_VALID;
+    // 時間戳涵蓋各種位數（右移 0-31 位）
+    uint32_t r = legacy_rand(rng);
+    p->timestamp = legacy_rand(rng) >> (r & 31);
+    *pipe = (uint8_t)((r >> 8) % RF_PIPE_COUNT);
+    *t_base_us = legacy_rand(rng) >> ((r >> 16) & 31);
+}
+
+#endif
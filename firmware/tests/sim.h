@@ -0,0 +1,72 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "hal.h"
+
+// 韌體主迴圈驅動（測試與效能量測共用）
+//
+// 虛擬時鐘不計 loop() 本身的執行時間，每圈固定推進 sim_loop_us；
+// 預設值接近 ATmega328P 上閒置 loop() 的耗時，輸出 / 無線 / I2C 的傳輸時間由 HAL 另外計入。
+
+void setup(void);
+void loop(void);
+
+static uint32_t sim_loop_us = 20;
+
+// 每圈 loop() 之前呼叫（送入無線封包、主機指令等），now_us = 目前虛擬時間
+typedef void (*SimTick)(uint64_t now_us);
+
+// 執行 loop() 直到虛擬時間到達 until_us
+// 回傳: 執行圈數
+static inline uint32_t sim_run_until(uint64_t until_us, SimTick tick) {
+    uint32_t loops = 0;
+    while (hal_now_us() < until_us) {
+        if (tick) tick(hal_now_us());
+        loop();
+        hal_advance_us(sim_loop_us);
+        loops++;
+    }
+    return loops;
+}
+
+static inline uint32_t sim_run_for(uint32_t us, SimTick tick) {
+    return sim_run_until(hal_now_us() + us, tick);
+}
+
+// 送出一行主機指令（自動加上換行）
+static inline void sim_command(const char* line) {
+    hal_serial_inject(line, strlen(line));
+    hal_serial_inject("\n", 1);
+}
+
+// 目前為止送上線路的輸出
+static inline std::string sim_output(void) {
+    size_t len;
+    const uint8_t* p = hal_serial_output(&len);
+    return std::string((const char*)p, len);
+}
+
+// 輸出依 \r\n 切成完整的行（最後不完整的一行不含在內）
+static inline std::vector<std::string> sim_lines(void) {
+    std::vector<std::string> lines;
+    std::string out = sim_output();
+    size_t start = 0;
+    for (size_t pos; (pos = out.find("\r\n", start)) != std::string::npos; start = pos + 2) {
+        lines.push_back(out.substr(start, pos - start));
+    }
+    return lines;
+}
+
+static inline bool sim_has_line(const char* line) {
+    std::vector<std::string> lines = sim_lines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i] == line) return true;
+    }
+    return false;
+}
+
+#endif
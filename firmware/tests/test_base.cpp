@@ -0,0 +1,597 @@
+// Base 韌體情境測試（主機端模擬硬體，見 host/hal.h）
+#include <Arduino.h>
+#include "check.h"
+#include "sim.h"
+#include "feed.h"
+#include "legacy_print.h"
+#include "../common/packet.h"
+#include "../common/cobs.h"
+#include "../common/crc.h"
+#include "../common/tdma.h"
+#include "../common/remote_command.h"
+#include "../base/csv_format.h"
+#include "../base/rf_receiver.h"
+#include "../base/serial_frame.h"
+#include "../base/tdma_base.h"
+#include "../base/uart.h"
+#include <stdlib.h>
+
+// ========== 輔助 ==========
+
+// 開機並等開機訊息送完（115200 baud 約 13 ms）
+static void boot(uint64_t start_us) {
+    hal_reset(start_us);
+    setup();
+    sim_run_for(50000, 0);
+}
+
+static std::vector<std::string> split(const std::string& line, char sep) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (size_t pos; (pos = line.find(sep, start)) != std::string::npos; start = pos + 1) {
+        fields.push_back(line.substr(start, pos - start));
+    }
+    fields.push_back(line.substr(start));
+    return fields;
+}
+
+// CSV 資料行（不以 # 開頭）
+static std::vector<std::vector<std::string> > data_lines(void) {
+    std::vector<std::vector<std::string> > rows;
+    std::vector<std::string> lines = sim_lines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (!lines[i].empty() && lines[i][0] != '#') rows.push_back(split(lines[i], ','));
+    }
+    return rows;
+}
+
+typedef struct {
+    uint8_t  type;
+    uint32_t t_us;
+    uint8_t  payload[FRAME_MAX_PAYLOAD];
+    uint8_t  len;
+} Frame;
+
+// 解出輸出中所有二進位框架（從 skip 位元組之後開始；CRC 錯誤的框架計入 bad）
+static std::vector<Frame> frames(size_t skip, int* bad) {
+    std::vector<Frame> out;
+    std::string s = sim_output().substr(skip);
+    size_t start = 0;
+    *bad = 0;
+    for (size_t pos; (pos = s.find('\0', start)) != std::string::npos; start = pos + 1) {
+        uint8_t raw[64];
+        uint16_t n = 0;
+        if (pos - start <= sizeof(raw)) {
+            n = cobs_decode((const uint8_t*)s.data() + start, (uint16_t)(pos - start), raw);
+        }
+        if (n < FRAME_HEADER_LEN + FRAME_CRC_LEN ||
+            crc16(raw, n - FRAME_CRC_LEN) != (uint16_t)(raw[n - 2] | (raw[n - 1] << 8))) {
+            (*bad)++;
+            continue;
+        }
+        Frame f;
+        f.type = raw[0];
+        f.t_us = (uint32_t)raw[1] | ((uint32_t)raw[2] << 8) | ((uint32_t)raw[3] << 16) | ((uint32_t)raw[4] << 24);
+        f.len = (uint8_t)(n - FRAME_HEADER_LEN - FRAME_CRC_LEN);
+        memcpy(f.payload, &raw[FRAME_HEADER_LEN], f.len);
+        out.push_back(f);
+    }
+    return out;
+}
+
+// 送出一筆感測封包（遠距端時間戳 ts_ms），再跑 gap_us
+static void send_seq(uint8_t pipe, uint16_t seq, uint32_t ts_ms, uint32_t gap_us) {
+    SensorPacket pkt = make_sensor(seq, ts_ms, 0xC0, 0);
+    CHECK(deliver(pipe, &pkt, 0) >= 0);
+    sim_run_for(gap_us, 0);
+}
+
+// !S 之後該管道 #pps 文字行的欄位值（key=value）；找不到時回傳 -1
+static long pps_field(uint8_t pipe, const char* key) {
+    std::string tag = ",pipe=" + std::to_string(pipe) + ",";
+    std::vector<std::string> lines = sim_lines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].compare(0, 5, "#pps=") != 0 || lines[i].find(tag) == std::string::npos) continue;
+        std::vector<std::string> fields = split(lines[i], ',');
+        for (size_t f = 0; f < fields.size(); f++) {
+            size_t eq = fields[f].find('=');
+            if (eq != std::string::npos && fields[f].compare(0, eq, key) == 0) {
+                return atol(fields[f].c_str() + eq + 1);
+            }
+        }
+    }
+    return -1;
+}
+
+// CSV 資料行的序號（依輸出順序）
+static std::vector<long> data_seqs(void) {
+    std::vector<long> seqs;
+    std::vector<std::vector<std::string> > rows = data_lines();
+    for (size_t i = 0; i < rows.size(); i++) seqs.push_back(atol(rows[i][0].c_str()));
+    return seqs;
+}
+
+// ========== 情境 ==========
+
+// 開機訊息、RF 初始化與接收模式
+static void test_boot_banner(void) {
+    boot(0);
+    CHECK(sim_has_line("#Mechtronic Base Station v2.0"));
+    CHECK(sim_has_line("#[OK] RF receiver ready"));
+    CHECK(sim_has_line("#seq,t_remote_ms,btn,ax1,ay1,az1,gx1,gy1,gz1,ax2,ay2,az2,gx2,gy2,gz2,valid,pipe,t_base_us"));
+    CHECK(hal_radio_listening());
+    CHECK_EQ(hal_radio_channel(), RF_CHANNEL);
+    CHECK_EQ(hal_serial_baud(), 115200);
+}
+
+// 感測封包 → CSV 行；t_base_us 為中斷進入時間
+static void test_csv_sample(void) {
+    boot(0);
+    hal_serial_clear();
+
+    SensorPacket pkt = make_sensor(5, 1234, PACKET_FLAG_BUTTON | PACKET_FLAG_MPU1_VALID, -3);
+    uint32_t t_arrival = micros();
+    CHECK(deliver(1, &pkt, 0) >= 0);
+    sim_run_for(20000, 0);
+
+    std::vector<std::vector<std::string> > rows = data_lines();
+    CHECK_EQ(rows.size(), 1);
+    if (rows.size() == 1) {
+        std::string expect = "5,1234,1,-3,-2,-1,0,1,2,3,4,5,6,7,8,1,1," + std::to_string(t_arrival);
+        CHECK(sim_lines().back() == expect);
+        CHECK_EQ(rows[0].size(), 18);
+    }
+}
+
+// csv_format_sensor 與改版前逐欄 Serial.print 的輸出逐位元組相同（邊界值 + 亂數封包）
+static void test_csv_legacy(void) {
+    uint32_t rng = 1;
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < 20000; i++) {
+        SensorPacket p;
+        uint8_t pipe;
+        uint32_t t_base_us;
+        legacy_packet(i, &rng, &p, &pipe, &t_base_us);
+
+        LegacyPrint legacy;
+        legacy_csv_line(&legacy, &p, pipe, t_base_us);
+        char line[CSV_LINE_MAX];
+        uint8_t len = csv_format_sensor(line, &p, pipe, t_base_us);
+
+        if (legacy.out != std::string(line, len)) {
+            if (mismatches++ < 3) {
+                fprintf(stderr, "packet %u:\n  legacy %s  format %.*s", i, legacy.out.c_str(), len, line);
+            }
+        }
+        CHECK(len <= CSV_LINE_MAX);
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+// 序號分類：跳號記為掉包、晚到扣回、重複不輸出
+static void test_seq_classes(void) {
+    boot(0);
+    sim_command("!I60000,1");
+    hal_serial_clear();
+    send_seq(1, 100, 1000, 10000);
+    send_seq(1, 101, 1010, 10000);
+    send_seq(1, 104, 1040, 2000);     // 102、103 暫記為掉包
+    send_seq(1, 102, 1020, 2000);     // 晚到
+    send_seq(1, 102, 1020, 2000);     // 重複
+    send_seq(1, 105, 1050, 10000);
+
+    long expect[] = { 100, 101, 104, 102, 105 };
+    std::vector<long> seqs = data_seqs();
+    CHECK(seqs == std::vector<long>(expect, expect + 5));
+
+    sim_command("!S");
+    sim_run_for(50000, 0);
+    CHECK_EQ(pps_field(1, "rx"), 5);
+    CHECK_EQ(pps_field(1, "dropped"), 1);
+    CHECK_EQ(pps_field(1, "dup"), 1);
+    CHECK_EQ(pps_field(1, "late"), 1);
+}
+
+// 遠距端在序號 32768 以上重啟：時間戳倒退，重新同步，不計掉包
+static void test_seq_reset_high(void) {
+    boot(0);
+    sim_command("!I60000,1");
+    hal_serial_clear();
+    for (uint16_t seq = 40000; seq < 40003; seq++) send_seq(2, seq, 400000 + (seq - 40000) * 10, 10000);
+    sim_run_for(30000, 0);
+    for (uint16_t seq = 0; seq < 3; seq++) send_seq(2, seq, 25 + seq * 10, 10000);
+
+    CHECK_EQ(data_seqs().size(), 6);
+    sim_command("!S");
+    sim_run_for(50000, 0);
+    CHECK_EQ(pps_field(2, "rx"), 6);
+    CHECK_EQ(pps_field(2, "dropped"), 0);
+    CHECK_EQ(pps_field(2, "late"), 0);
+}
+
+// 遠距端在序號 32 以下重啟：新序號落在視窗內已收過的位置，仍照常輸出（不當成重複）
+static void test_seq_reset_low(void) {
+    boot(0);
+    sim_command("!I60000,1");
+    hal_serial_clear();
+    for (uint16_t seq = 0; seq <= 20; seq++) send_seq(3, seq, 25 + seq * 10, 10000);
+    sim_run_for(20000, 0);
+    for (uint16_t seq = 0; seq < 6; seq++) send_seq(3, seq, 25 + seq * 10, 10000);
+
+    CHECK_EQ(data_seqs().size(), 27);
+    sim_command("!S");
+    sim_run_for(50000, 0);
+    CHECK_EQ(pps_field(3, "rx"), 27);
+    CHECK_EQ(pps_field(3, "dup"), 0);
+    CHECK_EQ(pps_field(3, "dropped"), 0);
+}
+
+// 比視窗更舊的封包（重傳延遲內到達）：計入晚到，最大序號不倒退，下一筆不多算掉包
+static void test_seq_stale(void) {
+    boot(0);
+    sim_command("!I60000,1");
+    hal_serial_clear();
+    send_seq(4, 100, 1000, 1000);
+    send_seq(4, 60, 960, 1000);       // 1 ms 採樣間隔下 40 個序號前的封包
+    send_seq(4, 101, 1001, 30000);
+
+    CHECK_EQ(data_seqs().size(), 3);
+    sim_command("!S");
+    sim_run_for(50000, 0);
+    CHECK_EQ(pps_field(4, "rx"), 3);
+    CHECK_EQ(pps_field(4, "late"), 1);
+    CHECK_EQ(pps_field(4, "dropped"), 0);
+}
+
+// !M1 以原模式回覆後切換為 COBS 框架；框架內容與 CRC 正確
+static void test_binary_frames(void) {
+    boot(0);
+    hal_serial_clear();
+    sim_command("!M1");
+    sim_run_for(5000, 0);
+    CHECK(sim_has_line("#ok,M"));
+    size_t text_len = sim_output().size();
+
+    SensorPacket pkt = make_sensor(42, 777, 0xC0, 1000);
+    uint32_t t_arrival = micros();
+    CHECK(deliver(3, &pkt, 0) >= 0);
+    sim_command("!S");
+    sim_run_for(20000, 0);
+
+    int bad = 0;
+    std::vector<Frame> fs = frames(text_len, &bad);
+    CHECK_EQ(bad, 0);
+    bool radio = false, cmd_ok = false, stats = false, base_stats = false;
+    for (size_t i = 0; i < fs.size(); i++) {
+        const Frame& f = fs[i];
+        if (f.type == FRAME_TYPE_PIPE(FRAME_TYPE_RADIO, 3)) {
+            radio = true;
+            CHECK_EQ(f.t_us, t_arrival);
+            CHECK_EQ(f.len, PACKET_SIZE);
+            CHECK(memcmp(f.payload, &pkt, PACKET_SIZE) == 0);
+        } else if (f.type == FRAME_TYPE_EVENT && f.payload[0] == FRAME_EVENT_CMD_OK) {
+            cmd_ok = f.payload[1] == 'S';
+        } else if (f.type == FRAME_TYPE_PIPE(FRAME_TYPE_STATS, 3)) {
+            stats = true;
+        } else if (f.type == FRAME_TYPE_BASE_STATS) {
+            base_stats = true;
+        }
+    }
+    CHECK(radio);
+    CHECK(cmd_ok);
+    CHECK(stats);
+    CHECK(base_stats);
+}
+
+// 參數錯誤與未知指令回覆 #err
+static void test_command_errors(void) {
+    boot(0);
+    hal_serial_clear();
+    const char* cmds[] = { "!M9", "!Q", "!I50", "!I1000,1", "!P7,1", "!D1", "!C200", "!S" };
+    for (size_t i = 0; i < sizeof(cmds) / sizeof(cmds[0]); i++) {
+        sim_command(cmds[i]);
+        sim_run_for(20000, 0);
+    }
+    CHECK(sim_has_line("#err,M"));
+    CHECK(sim_has_line("#err,Q"));
+    CHECK(sim_has_line("#err,I"));
+    CHECK(sim_has_line("#ok,I"));
+    CHECK(sim_has_line("#err,P"));
+    CHECK(sim_has_line("#err,D"));
+    CHECK(sim_has_line("#err,C"));
+    CHECK(sim_has_line("#ok,S"));
+}
+
+// !P 依原到達時間重送，最後回覆 #ok,P；已覆蓋的序號回覆 #err,P
+static void test_replay(void) {
+    boot(0);
+    uint32_t t_arrival[4];
+    for (uint16_t seq = 10; seq < 14; seq++) {
+        SensorPacket pkt = make_sensor(seq, seq * 10, 0xC0, 0);
+        t_arrival[seq - 10] = micros();
+        deliver(2, &pkt, 0);
+        sim_run_for(10000, 0);
+    }
+    hal_serial_clear();
+    sim_command("!P2,11,2");
+    sim_run_for(10000, 0);
+
+    std::vector<std::vector<std::string> > rows = data_lines();
+    CHECK_EQ(rows.size(), 2);
+    for (size_t i = 0; i < rows.size() && i < 2; i++) {
+        CHECK_EQ(atol(rows[i][0].c_str()), 11 + i);
+        CHECK_EQ(atol(rows[i][17].c_str()), t_arrival[1 + i]);
+    }
+    std::vector<std::string> lines = sim_lines();
+    CHECK(!lines.empty() && lines.back() == "#ok,P");
+
+    hal_serial_clear();
+    sim_command("!P2,99");
+    sim_run_for(10000, 0);
+    CHECK(sim_has_line("#err,P"));
+}
+
+// 重送緩衝只存到達時間低 16 位元：比最新一筆早 65 ms 以上的捨棄，其餘還原完整時間
+static void test_replay_age(void) {
+    boot(0);
+    uint32_t t_arrival[3];
+    for (uint16_t seq = 10; seq < 13; seq++) {
+        SensorPacket pkt = make_sensor(seq, seq * 10, 0xC0, 0);
+        t_arrival[seq - 10] = micros();
+        deliver(2, &pkt, 0);
+        sim_run_for(40000, 0);
+    }
+    hal_serial_clear();
+    sim_command("!P2,10");
+    sim_run_for(10000, 0);
+    CHECK(sim_has_line("#err,P"));
+    CHECK(data_lines().empty());
+
+    hal_serial_clear();
+    sim_command("!P2,11,2");
+    sim_run_for(10000, 0);
+    std::vector<std::vector<std::string> > rows = data_lines();
+    CHECK_EQ(rows.size(), 2);
+    for (size_t i = 0; i < rows.size() && i < 2; i++) {
+        CHECK_EQ(atol(rows[i][0].c_str()), 11 + i);
+        CHECK_EQ(strtoul(rows[i][17].c_str(), 0, 10), t_arrival[1 + i]);
+    }
+}
+
+// !D1,4：每 4 筆輸出一筆平均（視窗借用重送緩衝，int32 累加須對齊）
+static void test_decimate_average(void) {
+    boot(0);
+    sim_command("!D1,4");
+    sim_run_for(10000, 0);
+    hal_serial_clear();
+    for (uint16_t seq = 0; seq < 8; seq++) {
+        SensorPacket pkt = make_sensor(seq, seq * 10, 0xC0, (int16_t)(seq * 4));
+        CHECK(deliver(1, &pkt, 0) >= 0);
+        sim_run_for(10000, 0);
+    }
+    std::vector<std::vector<std::string> > rows = data_lines();
+    CHECK_EQ(rows.size(), 2);
+    for (size_t i = 0; i < rows.size() && i < 2; i++) {
+        CHECK_EQ(atol(rows[i][0].c_str()), 3 + i * 4);
+        CHECK_EQ(atol(rows[i][3].c_str()), 6 + i * 16);     // ax1 = (0+4+8+12)/4、(16+20+24+28)/4
+        CHECK_EQ(atol(rows[i][14].c_str()), 6 + i * 16 + 11);
+    }
+}
+
+// 傳送緩衝被樣本塞滿時 !P 不重送（再寫會擠掉剛重送的行），回覆 #err,P 而不是假的 #ok,P
+static void test_replay_busy(void) {
+    boot(0);
+    for (uint16_t seq = 10; seq < 12; seq++) {
+        SensorPacket pkt = make_sensor(seq, seq * 10, 0xC0, 0);
+        deliver(2, &pkt, 0);
+        sim_run_for(10000, 0);
+    }
+    hal_serial_clear();
+    for (uint8_t pipe = 3; pipe < RF_PIPE_COUNT; pipe++) {
+        SensorPacket pkt = make_sensor(100, 1000, 0xC0, -30000);
+        deliver(pipe, &pkt, 0);
+        sim_run_for(200, 0);
+    }
+    CHECK(uart_tx_free() < UART_RECORD_MAX);
+    sim_command("!P2,10,2");
+    sim_run_for(50000, 0);
+
+    std::vector<std::vector<std::string> > rows = data_lines();
+    for (size_t i = 0; i < rows.size(); i++) CHECK(rows[i][16] != "2");
+    CHECK(sim_has_line("#err,P"));
+}
+
+// 健康狀態只保存最先送來的 STATS_HEALTH_SLOTS 個遠距端（文字統計行 #health）
+static void test_health_slots(void) {
+    boot(0);
+    sim_command("!I60000,1");
+    for (uint8_t pipe = 0; pipe < 3; pipe++) {
+        HealthPacket h;
+        memset(&h, 0, sizeof(h));
+        h.type = PACKET_TYPE_HEALTH;
+        h.i2c_err1 = (uint16_t)(pipe + 1);
+        CHECK(deliver(pipe, &h, 0) >= 0);
+        sim_run_for(5000, 0);
+    }
+    hal_serial_clear();
+    sim_command("!S");
+    sim_run_for(50000, 0);
+
+    int found[3] = { 0, 0, 0 };
+    std::vector<std::string> lines = sim_lines();
+    for (size_t i = 0; i < lines.size(); i++) {
+        for (uint8_t pipe = 0; pipe < 3; pipe++) {
+            std::string prefix = "#health,pipe=" + std::to_string(pipe) + ",";
+            if (lines[i].compare(0, prefix.size(), prefix) == 0) {
+                found[pipe]++;
+                std::string i2c = ",i2c1=" + std::to_string(pipe + 1) + ",";
+                CHECK(lines[i].find(i2c) != std::string::npos);
+            }
+        }
+    }
+    CHECK_EQ(found[0], 1);
+    CHECK_EQ(found[1], 1);
+    CHECK_EQ(found[2], 0);
+}
+
+// 115200 baud 下 6 個遠距端的 CSV 超過頻寬：整行丟棄，主機不會收到半行
+static void test_serial_overflow(void) {
+    boot(0);
+    hal_serial_clear();
+    feed_start(RF_PIPE_COUNT);
+    sim_run_for(1000000, feed_tick);
+
+    UartStats us;
+    uart_get_stats(&us);
+    CHECK(us.records_dropped > 0);
+    CHECK_EQ(feed_missed, 0);
+    CHECK_EQ(rf_get_rx_overflow(), 0);
+
+    std::vector<std::vector<std::string> > rows = data_lines();
+    CHECK(rows.size() > 100);
+    long last_seq[RF_PIPE_COUNT];
+    for (uint8_t p = 0; p < RF_PIPE_COUNT; p++) last_seq[p] = -1;
+    for (size_t i = 0; i < rows.size(); i++) {
+        CHECK_EQ(rows[i].size(), 18);
+        if (rows[i].size() != 18) continue;
+        int pipe = atoi(rows[i][16].c_str());
+        long seq = atol(rows[i][0].c_str());
+        CHECK(pipe >= 0 && pipe < RF_PIPE_COUNT);
+        if (pipe < 0 || pipe >= RF_PIPE_COUNT) continue;
+        CHECK(seq > last_seq[pipe]);   // 丟棄只造成缺號，不會亂序或重複
+        last_seq[pipe] = seq;
+    }
+}
+
+// 鮑率協商：回覆送完後切換，!K 確認；1 Mbaud 下 6 個遠距端不再丟棄
+static void test_baud_switch(void) {
+    boot(0);
+    hal_serial_clear();
+    sim_command("!B1000000");
+    sim_run_for(20000, 0);
+    CHECK(sim_has_line("#baud=1000000"));
+    CHECK_EQ(hal_serial_baud(), 1000000);
+
+    sim_command("!K");
+    sim_run_for(10000, 0);
+    CHECK(sim_has_line("#baud-ok=1000000"));
+
+    UartStats before;
+    uart_get_stats(&before);
+    feed_start(RF_PIPE_COUNT);
+    sim_run_for(1000000, feed_tick);
+    UartStats after;
+    uart_get_stats(&after);
+    CHECK_EQ(after.records_dropped, before.records_dropped);
+    CHECK(data_lines().size() >= 590);
+
+    // 未確認：BAUD_CONFIRM_MS 後退回預設鮑率
+    sim_command("!B500000");
+    sim_run_for(1200000, 0);
+    CHECK_EQ(hal_serial_baud(), 115200);
+    CHECK(sim_has_line("#baud=115200"));
+}
+
+// 兩個遠距端：依管道號碼分配時槽，ACK payload 帶回時槽同步
+static void test_tdma_slots(void) {
+    boot(0);
+    feed_start(2);
+    sim_run_for(300000, feed_tick);
+
+    CHECK_EQ(tdma_slot_count(), 2);
+    CHECK_EQ(tdma_slot_of(0), 0);
+    CHECK_EQ(tdma_slot_of(1), 1);
+    for (uint8_t p = 0; p < 2; p++) {
+        CHECK_EQ(feed_ack_len[p], sizeof(TdmaSync));
+        TdmaSync sync;
+        memcpy(&sync, feed_ack[p], sizeof(sync));
+        CHECK_EQ(sync.type, TDMA_ACK_SYNC);
+        CHECK_EQ(sync.slot, p);
+        CHECK_EQ(sync.slot_count, 2);
+    }
+
+    // !R 轉送指令：下一筆 ACK payload 為指令，送達後回到時槽同步
+    hal_serial_clear();
+    sim_command("!R1W");
+    sim_run_for(100000, feed_tick);
+    CHECK(sim_has_line("#ok,R"));
+    CHECK_EQ(feed_commands[0], 0);
+    CHECK_EQ(feed_commands[1], 1);
+    CHECK(!tdma_command_pending());
+    CHECK_EQ(feed_ack_len[1], sizeof(TdmaSync));
+
+    // 已離線的遠距端
+    sim_command("!R4W");
+    sim_run_for(20000, feed_tick);
+    CHECK(sim_has_line("#err,R"));
+}
+
+// micros() 溢位前後：到達時間照 32-bit 累進，序號與輸出不受影響
+static void test_micros_wrap(void) {
+    boot(0x100000000ULL - 300000);
+    hal_serial_clear();
+    feed_start(1);
+    sim_run_for(1000000, feed_tick);
+
+    std::vector<std::vector<std::string> > rows = data_lines();
+    CHECK(rows.size() >= 99);
+    uint32_t prev_t = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+        CHECK_EQ(rows[i].size(), 18);
+        if (rows[i].size() != 18) break;
+        CHECK_EQ(atol(rows[i][0].c_str()), i);
+        uint32_t t = (uint32_t)strtoul(rows[i][17].c_str(), 0, 10);
+        if (i > 0) CHECK_EQ((uint32_t)(t - prev_t), FEED_FRAME_US);
+        prev_t = t;
+    }
+    CHECK(hal_now_us() > 0x100000000ULL);
+    CHECK(!sim_has_line("#[WARN] Bad version: 0"));
+}
+
+// nRF24 不在線：回報錯誤、LED 快閃，接回後 RF_RETRY_INTERVAL 內恢復
+static void test_rf_absent(void) {
+    hal_reset(0);
+    hal_radio_set_present(false);
+    setup();
+    uint8_t last = hal_pin_read(3);
+    uint8_t toggles = 0;
+    for (uint8_t i = 0; i < 50; i++) {
+        sim_run_for(10000, 0);
+        if (hal_pin_read(3) != last) toggles++;
+        last = hal_pin_read(3);
+    }
+    CHECK(sim_has_line("#[ERROR] RF init failed!"));
+    CHECK(toggles >= 4);
+    CHECK(!hal_radio_listening());
+
+    hal_serial_clear();
+    hal_radio_set_present(true);
+    sim_run_for(1100000, 0);
+    CHECK(sim_has_line("#[OK] RF receiver ready"));
+    CHECK(hal_radio_listening());
+}
+
+int main(int argc, char** argv) {
+    static const TestCase cases[] = {
+        { "boot_banner",    test_boot_banner },
+        { "csv_legacy",     test_csv_legacy },
+        { "csv_sample",     test_csv_sample },
+        { "seq_classes",    test_seq_classes },
+        { "seq_reset_high", test_seq_reset_high },
+        { "seq_reset_low",  test_seq_reset_low },
+        { "seq_stale",      test_seq_stale },
+        { "binary_frames",  test_binary_frames },
+        { "command_errors", test_command_errors },
+        { "replay",         test_replay },
+        { "replay_age",     test_replay_age },
+        { "replay_busy",    test_replay_busy },
+        { "decimate_average", test_decimate_average },
+        { "health_slots",   test_health_slots },
+        { "serial_overflow", test_serial_overflow },
+        { "baud_switch",    test_baud_switch },
+        { "tdma_slots",     test_tdma_slots },
+        { "micros_wrap",    test_micros_wrap },
+        { "rf_absent",      test_rf_absent },
+    };
+    return check_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
@@ -0,0 +1,337 @@
+// 遠距端韌體情境測試（主機端模擬硬體，見 host/hal.h）
+#include <Arduino.h>
+#include "check.h"
+#include "sim.h"
+#include "../common/packet.h"
+#include "../common/tdma.h"
+#include "../common/remote_command.h"
+#include "../remote/config_store.h"
+#include "../remote/imu_driver.h"
+#include "../remote/rf_link.h"
+#include "../remote/button.h"
+#include "../remote/scheduler.h"
+
+// ========== 輔助 ==========
+
+// Base 收到的封包（responder 記錄）
+typedef struct {
+    uint64_t t_us;               // 收完的時間
+    RadioPayload p;
+} Received;
+
+static std::vector<Received> received;
+
+// 回應方式：0 = 空 ACK，其餘見各情境
+static uint8_t ack_mode = 0;
+#define ACK_NONE     0
+#define ACK_TDMA     1   // 模擬 Base：2 個時槽，本遠距端為時槽 1，每筆感測封包回傳相位修正
+#define ACK_COMMAND  2   // 下一筆封包回傳 pending_command，之後空 ACK
+
+#define TDMA_TEST_SLOT_CENTER_US 7500   // 時槽 1 / 2 的中央（時框以 0 為起點）
+
+static RemoteCommand pending_command;
+
+static uint8_t respond(const uint8_t* data, uint8_t len, uint8_t* ack) {
+    Received r;
+    r.t_us = hal_now_us();
+    memset(&r.p, 0, sizeof(r.p));
+    memcpy(r.p.raw, data, len < PACKET_SIZE ? len : PACKET_SIZE);
+    received.push_back(r);
+
+    if (ack_mode == ACK_COMMAND) {
+        ack_mode = ACK_NONE;
+        memcpy(ack, &pending_command, sizeof(pending_command));
+        return sizeof(pending_command);
+    }
+    if (ack_mode == ACK_TDMA && r.p.sensor.version == PROTOCOL_VERSION) {
+        int32_t offset = TDMA_TEST_SLOT_CENTER_US - (int32_t)(r.t_us % TDMA_FRAME_US);
+        if (offset >= (int32_t)(TDMA_FRAME_US / 2)) offset -= TDMA_FRAME_US;
+        if (offset < -(int32_t)(TDMA_FRAME_US / 2)) offset += TDMA_FRAME_US;
+        TdmaSync sync;
+        sync.type = TDMA_ACK_SYNC;
+        sync.slot = 1;
+        sync.slot_count = 2;
+        sync.tag = (uint8_t)r.p.sensor.seq;
+        sync.offset_us = (int16_t)offset;
+        memcpy(ack, &sync, sizeof(sync));
+        return sizeof(sync);
+    }
+    return 0;
+}
+
+static const int16_t SAMPLE1[7] = { 100, -200, 16384, 0, 1, -2, 3 };
+static const int16_t SAMPLE2[7] = { -100, 200, -16384, 0, -1, 2, -3 };
+
+// 重設模擬硬體；開機前可再調整（EEPROM、感測器在線與否）
+static void power_on(void) {
+    hal_reset(0);
+    hal_imu_set_sample(0, SAMPLE1);
+    hal_imu_set_sample(1, SAMPLE2);
+    hal_radio_set_responder(respond);
+    received.clear();
+    ack_mode = ACK_NONE;
+}
+
+static void boot(void) {
+    power_on();
+    setup();
+}
+
+// received 中的感測封包
+static std::vector<const Received*> sensor_packets(void) {
+    std::vector<const Received*> out;
+    for (size_t i = 0; i < received.size(); i++) {
+        if (received[i].p.sensor.version == PROTOCOL_VERSION) out.push_back(&received[i]);
+    }
+    return out;
+}
+
+static const HealthPacket* last_health(void) {
+    for (size_t i = received.size(); i-- > 0;) {
+        if (received[i].p.raw[0] == PACKET_TYPE_HEALTH) return &received[i].p.health;
+    }
+    return 0;
+}
+
+// ========== 情境 ==========
+
+// EEPROM 空白：探測兩顆感測器並寫入組態，I2C 400kHz
+static void test_first_boot(void) {
+    boot();
+    RemoteConfig cfg;
+    CHECK(config_load(&cfg, 10));
+    CHECK_EQ(cfg.rf_channel, RF_CHANNEL);
+    CHECK_EQ(cfg.sample_interval_ms, 10);
+    for (uint8_t i = 0; i < 2; i++) {
+        CHECK_EQ(hal_imu_reg(i, 0x6B), 0x00);   // 已喚醒
+        CHECK_EQ(hal_imu_reg(i, 0x1A), IMU_DLPF);
+    }
+    CHECK_EQ(hal_i2c_clock(), 400000);
+    CHECK_EQ(hal_radio_channel(), RF_CHANNEL);
+    CHECK(!hal_radio_listening());
+}
+
+// 有效組態：跳過探測直接套用（頻道取自 EEPROM）
+static void test_fast_boot(void) {
+    power_on();
+    RemoteConfig cfg;
+    config_defaults(&cfg, 10);
+    cfg.rf_channel = 90;
+    config_save(&cfg);
+    setup();
+    CHECK_EQ(hal_radio_channel(), 90);
+    CHECK_EQ(hal_imu_reg(0, 0x6B), 0x00);
+    sim_run_for(100000, 0);
+    std::vector<const Received*> s = sensor_packets();
+    CHECK(!s.empty());
+    if (!s.empty()) CHECK_EQ(s.back()->p.sensor.flags, PACKET_FLAG_MPU1_VALID | PACKET_FLAG_MPU2_VALID);
+}
+
+// 預設值不同的舊韌體寫入的組態：不沿用舊頻道，完整探測後以新預設值重寫
+static void test_stale_build(void) {
+    power_on();
+    RemoteConfig cfg;
+    config_defaults(&cfg, 10);
+    cfg.rf_channel = 90;
+    cfg.build_id = config_build_id(20);   // 舊韌體的預設採樣間隔不同
+    config_save(&cfg);
+    CHECK(!config_load(&cfg, 10));
+    setup();
+    CHECK_EQ(hal_radio_channel(), RF_CHANNEL);
+    CHECK(config_load(&cfg, 10));
+    CHECK_EQ(cfg.rf_channel, RF_CHANNEL);
+    CHECK_EQ(cfg.build_id, config_build_id(10));
+}
+
+// 100Hz 採樣：序號連續、時間間隔 10 ms、資料與感測器一致；按鈕去抖後反映在 flags
+static void test_sample_rate(void) {
+    boot();
+    sim_run_for(1000000, 0);
+
+    std::vector<const Received*> s = sensor_packets();
+    CHECK(s.size() >= 99 && s.size() <= 101);
+    for (size_t i = 0; i < s.size(); i++) {
+        const SensorPacket* p = &s[i]->p.sensor;
+        CHECK_EQ(p->seq, i);
+        // 第一筆的時間戳含開機到第一次讀取的時間
+        if (i > 1) CHECK_EQ(p->timestamp - s[i - 1]->p.sensor.timestamp, 10);
+        CHECK_EQ(p->flags, PACKET_FLAG_MPU1_VALID | PACKET_FLAG_MPU2_VALID);
+        CHECK_EQ(p->mpu1_az, SAMPLE1[2]);
+        CHECK_EQ(p->mpu1_gz, SAMPLE1[6]);
+        CHECK_EQ(p->mpu2_ay, SAMPLE2[1]);
+        CHECK_EQ(p->mpu2_gx, SAMPLE2[4]);
+    }
+    CHECK_EQ(sched_get_task(0)->deadline_miss, 0);
+
+    hal_pin_write(BUTTON_PIN, 0);
+    sim_run_for(100000, 0);
+    CHECK(button_is_pressed());
+    s = sensor_packets();
+    CHECK(!s.empty() && (s.back()->p.sensor.flags & PACKET_FLAG_BUTTON));
+    hal_pin_write(BUTTON_PIN, 1);
+    sim_run_for(100000, 0);
+    CHECK(!button_is_pressed());
+}
+
+// MPU2 不在線：照常發送，只有 MPU1 有效，健康封包標示故障
+static void test_imu_fault(void) {
+    power_on();
+    hal_imu_set_present(1, false);
+    setup();
+    sim_run_for(4500000, 0);
+
+    std::vector<const Received*> s = sensor_packets();
+    CHECK(s.size() > 400);
+    if (!s.empty()) {
+        CHECK_EQ(s.back()->p.sensor.flags, PACKET_FLAG_MPU1_VALID);
+        CHECK_EQ(s.back()->p.sensor.mpu2_az, 0);
+        CHECK_EQ(s.back()->p.sensor.mpu1_az, SAMPLE1[2]);
+    }
+    const HealthPacket* h = last_health();
+    CHECK(h != 0);
+    if (h) {
+        CHECK_EQ(h->status & (HEALTH_STATUS_MPU1_FAULT | HEALTH_STATUS_MPU2_FAULT), HEALTH_STATUS_MPU2_FAULT);
+        CHECK(h->i2c_err2 > 0);
+        CHECK_EQ(h->i2c_err1, 0);
+    }
+}
+
+// 斷線：連續失敗達門檻後重新初始化，恢復後健康封包帶回累計計數
+static void test_link_loss(void) {
+    boot();
+    sim_run_for(100000, 0);
+    hal_radio_set_loss(1000);
+    sim_run_for(1000000, 0);
+    CHECK(rf_get_tx_fail_total() >= 20);
+    CHECK(rf_get_reinit_count() >= 1);
+
+    hal_radio_set_loss(0);
+    received.clear();
+    sim_run_for(4500000, 0);
+    const HealthPacket* h = last_health();
+    CHECK(h != 0);
+    if (h) {
+        CHECK(h->tx_fail >= 20);
+        CHECK(h->rf_reinit >= 1);
+        CHECK_EQ(h->status & HEALTH_STATUS_RF_FAULT, 0);
+    }
+    // 斷線期間照常採樣（未同步時每次失敗隨機移動相位，筆數少於 100Hz），序號不重來
+    std::vector<const Received*> s = sensor_packets();
+    CHECK(!s.empty() && s.front()->p.sensor.seq > 50);
+}
+
+// TDMA：依 Base 的相位修正移到所屬時槽，之後每筆都落在時槽中央附近
+static void test_tdma_sync(void) {
+    boot();
+    ack_mode = ACK_TDMA;
+    sim_run_for(2000000, 0);
+
+    CHECK(rf_slot_synced());
+    std::vector<const Received*> s = sensor_packets();
+    CHECK(s.size() > 150);
+    for (size_t i = s.size() - 50; i < s.size(); i++) {
+        int32_t phase = (int32_t)(s[i]->t_us % TDMA_FRAME_US);
+        CHECK(phase > TDMA_TEST_SLOT_CENTER_US - 300 && phase < TDMA_TEST_SLOT_CENTER_US + 300);
+    }
+    CHECK_EQ(sched_get_task(0)->deadline_miss, 0);
+}
+
+// 模擬 Base 停在 base_channel：遠距端不在該頻道時收不到 ACK
+static uint8_t base_channel = RF_CHANNEL;
+static void base_on_channel(uint64_t now_us) {
+    (void)now_us;
+    hal_radio_set_loss(hal_radio_channel() == base_channel ? 0 : 1000);
+}
+
+// EEPROM 存了其他頻道而 Base 重新上電回到 RF_CHANNEL：斷線一段時間後改用 RF_CHANNEL，EEPROM 不變；
+// 之後 Base 切到組態頻道再斷線，會換回組態頻道
+static void test_channel_fallback(void) {
+    power_on();
+    RemoteConfig cfg;
+    config_defaults(&cfg, 10);
+    cfg.rf_channel = 90;
+    config_save(&cfg);
+    setup();
+    CHECK_EQ(hal_radio_channel(), 90);
+
+    base_channel = RF_CHANNEL;
+    sim_run_for(2000000, base_on_channel);
+    CHECK_EQ(hal_radio_channel(), 90);          // 還沒到回退時間
+    sim_run_for(2000000, base_on_channel);
+    CHECK_EQ(hal_radio_channel(), RF_CHANNEL);
+    received.clear();
+    sim_run_for(5000000, base_on_channel);
+    CHECK_EQ(hal_radio_channel(), RF_CHANNEL);  // 連線中不再切換
+    CHECK(sensor_packets().size() > 400);
+    CHECK(config_load(&cfg, 10));
+    CHECK_EQ(cfg.rf_channel, 90);
+
+    base_channel = 90;
+    sim_run_for(4000000, base_on_channel);
+    CHECK_EQ(hal_radio_channel(), 90);
+    hal_radio_set_loss(0);
+}
+
+// Base 經 ACK payload 送來的指令：切換頻道、寫入 EEPROM
+static void test_remote_channel(void) {
+    boot();
+    sim_run_for(100000, 0);
+    pending_command.type = REMOTE_CMD_TYPE;
+    pending_command.op = REMOTE_CMD_CHANNEL;
+    pending_command.arg = 100;
+    ack_mode = ACK_COMMAND;
+    sim_run_for(100000, 0);
+    CHECK_EQ(hal_radio_channel(), 100);
+
+    RemoteConfig cfg;
+    CHECK(config_load(&cfg, 10));
+    CHECK_EQ(cfg.rf_channel, RF_CHANNEL);   // 尚未寫入
+
+    pending_command.op = REMOTE_CMD_SAVE;
+    pending_command.arg = 0;
+    ack_mode = ACK_COMMAND;
+    sim_run_for(100000, 0);
+    CHECK(config_load(&cfg, 10));
+    CHECK_EQ(cfg.rf_channel, 100);
+
+    // 超出範圍的頻道不理會
+    pending_command.op = REMOTE_CMD_CHANNEL;
+    pending_command.arg = 200;
+    ack_mode = ACK_COMMAND;
+    sim_run_for(100000, 0);
+    CHECK_EQ(hal_radio_channel(), 100);
+}
+
+// 從端拉住 SDA：偵測後以 GPIO 送時脈恢復匯流排，重新設定感測器後資料恢復
+static void test_bus_recovery(void) {
+    boot();
+    sim_run_for(200000, 0);
+    hal_i2c_hold_sda(true);
+    sim_run_for(100000, 0);
+    std::vector<const Received*> s = sensor_packets();
+    CHECK(!s.empty() && s.back()->p.sensor.flags == 0);
+
+    sim_run_for(1000000, 0);
+    CHECK_EQ(imu_get_recovery_count(), 1);
+    CHECK(!imu_bus_recovering());
+    CHECK_EQ(hal_pin_read(IMU_SDA_PIN), 1);
+    s = sensor_packets();
+    CHECK(!s.empty() && s.back()->p.sensor.flags == (PACKET_FLAG_MPU1_VALID | PACKET_FLAG_MPU2_VALID));
+    CHECK(imu_get_error_count(0) >= IMU_FAIL_THRESHOLD);
+}
+
+int main(int argc, char** argv) {
+    static const TestCase cases[] = {
+        { "first_boot",     test_first_boot },
+        { "fast_boot",      test_fast_boot },
+        { "stale_build",    test_stale_build },
+        { "sample_rate",    test_sample_rate },
+        { "imu_fault",      test_imu_fault },
+        { "link_loss",      test_link_loss },
+        { "tdma_sync",      test_tdma_sync },
+        { "remote_channel", test_remote_channel },
+        { "channel_fallback", test_channel_fallback },
+        { "bus_recovery",   test_bus_recovery },
+    };
+    return check_main(argc, argv, cases, sizeof(cases) / sizeof(cases[0]));
+}
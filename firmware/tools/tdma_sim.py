@@ -0,0 +1,335 @@
+"""
+TDMA Simulator
+多個遠距端共用一個頻道的無線模擬：比較無協調發送（ALOHA + 自動重傳）與 TDMA 時槽
+
+模型:
+    - 每個遠距端每個時框 (10 ms) 採樣一筆並發送；晶振誤差 ±ppm、採樣相位隨機
+    - 一次傳輸 = 資料封包 + 收發切換 + ACK，期間佔用頻道；任兩筆重疊即兩筆皆失敗
+    - 失敗後依 ARD 重傳，最多 ARC 次；rf_send() 阻塞，忙碌期間的採樣延後或略過
+    - TDMA 模式的遠距端 / Base 邏輯對應 firmware/remote/rf_link.cpp 與 firmware/base/tdma_base.cpp
+      （ACK payload 預載、tag 對應、採樣任務整數 ms 移相 + 忙等）
+
+用法:
+    python firmware/tools/tdma_sim.py                     # 1-6 個遠距端，250kbps / 1Mbps
+    python firmware/tools/tdma_sim.py -n 4 --rate 1M --seconds 30
+"""
+
+import argparse
+import heapq
+import random
+from dataclasses import dataclass, field
+
+FRAME_US = 10000            # TDMA_FRAME_US
+SAMPLE_MS = 10              # 採樣間隔
+TELEMETRY_FRAMES = 100      # 每 100 個時框多送一筆遙測封包
+PAYLOAD = 32
+SYNC_LEN = 6                # sizeof(TdmaSync)
+SETTLE_US = 130             # nRF24 TX/RX 切換
+IMU_US = (850, 1100)        # imu_read_both() 耗時範圍
+LOOP_JITTER_US = 300        # 排程器延遲
+SPIN_MAX_US = 2500          # TDMA_SPIN_MAX_US
+LATE_US = 300               # TDMA_LATE_US
+LATE_FRAMES = 2             # TDMA_LATE_FRAMES
+UNSYNC_FAILS = 10           # RF_TDMA_UNSYNC_FAILS
+ACK_DEPTH = 3               # TDMA_ACK_DEPTH
+RATES = {'250k': 250_000, '1M': 1_000_000, '2M': 2_000_000}
+
+
+def airtime_us(payload_len: int, bps: int) -> float:
+    """一個封包（含前導、位址、PCF、CRC）的空中時間"""
+    preamble = 2 if bps >= 2_000_000 else 1
+    bits = 8 * (preamble + 5 + payload_len + 2) + 9
+    return bits * 1e6 / bps
+
+
+@dataclass
+class RadioProfile:
+    """一種模式的無線參數"""
+    name: str
+    tdma: bool
+    ard: int            # setRetries delay (×250us + 250us)
+    arc: int            # setRetries count
+    ack_payload: int    # ACK payload 長度
+
+
+MODES = {
+    'aloha': RadioProfile('aloha', tdma=False, ard=5, arc=15, ack_payload=0),   # RF_RETRY_DELAY / COUNT
+    'tdma': RadioProfile('tdma', tdma=True, ard=2, arc=2, ack_payload=SYNC_LEN),  # RF_TDMA_RETRY_*
+}
+
+
+@dataclass
+class Remote:
+    """遠距端（時鐘、排程、時槽同步狀態）"""
+    pipe: int
+    ppm: float
+    clock_offset: float
+    next_release_ms: int
+    seq: int = 0
+    busy_until: float = 0.0
+    synced: bool = False
+    slot_next_us: float = 0.0
+    history: list = field(default_factory=list)   # [(tag, t_local_us)]
+    frames: int = 0
+    release_waiting: bool = False   # 釋放時無線仍忙碌，完成後再執行
+    late_count: int = 0
+    fail_count: int = 0
+
+    # 統計
+    generated: int = 0
+    delivered: int = 0
+    skipped: int = 0
+    slot_skipped: int = 0
+
+    def local(self, t_true: float) -> float:
+        return t_true * (1 + self.ppm * 1e-6) + self.clock_offset
+
+    def true(self, t_local: float) -> float:
+        return (t_local - self.clock_offset) / (1 + self.ppm * 1e-6)
+
+    def slot_wait(self, now_local: float) -> float:
+        return self.slot_next_us - now_local if self.synced else 0.0
+
+    def slot_skip(self, now_local: float):
+        while self.slot_next_us - now_local < FRAME_US / 2:
+            self.slot_next_us += FRAME_US
+
+    def slot_begin(self, tag: int, now_local: float):
+        self.history = (self.history + [(tag, now_local)])[-4:]
+        if not self.synced:
+            self.slot_next_us = now_local + FRAME_US
+            return
+        while self.slot_next_us - now_local < FRAME_US / 2:
+            self.slot_next_us += FRAME_US
+
+    def apply_sync(self, tag: int, offset_us: int):
+        for t, t_us in self.history:
+            if t != tag:
+                continue
+            last_us = self.history[-1][1]
+            nxt = t_us + offset_us
+            while nxt - last_us < FRAME_US / 2:
+                nxt += FRAME_US
+            self.slot_next_us = nxt
+            self.synced = True
+            return
+
+
+class Base:
+    """Base 端時槽分配（對應 tdma_base.cpp，時間基準 = 真實時間）"""
+
+    def __init__(self):
+        self.active: set[int] = set()
+        self.slot: dict[int, int] = {}
+        self.meas: dict[int, tuple[int, int]] = {}
+        self.pending: dict[int, tuple[int, int, int]] = {}
+
+    def _assign(self):
+        self.slot = {p: i for i, p in enumerate(sorted(self.active))}
+
+    def _offset(self, slot: int, t_us: float) -> int:
+        phase = t_us % FRAME_US
+        slot_us = FRAME_US // len(self.active)
+        off = slot * slot_us + slot_us // 2 - phase
+        if off >= FRAME_US / 2:
+            off -= FRAME_US
+        if off < -FRAME_US / 2:
+            off += FRAME_US
+        return int(off)
+
+    def _fill(self, after: int):
+        n = len(self.active)
+        by_slot = {s: p for p, s in self.slot.items()}
+        for i in range(1, n + 1):
+            if len(self.pending) >= ACK_DEPTH:
+                break
+            pipe = by_slot[(after + i) % n]
+            if pipe not in self.pending and pipe in self.meas:
+                tag, off = self.meas[pipe]
+                self.pending[pipe] = (self.slot[pipe], tag, off)
+
+    def on_packet(self, pipe: int, sensor: bool, tag: int, t_us: float):
+        """回傳此封包 ACK 帶回的 payload（預載內容），並量測 / 補充"""
+        ack = self.pending.pop(pipe, None)
+        if pipe not in self.active:
+            self.active.add(pipe)
+            self._assign()
+        if sensor:
+            self.meas[pipe] = (tag, self._offset(self.slot[pipe], t_us))
+        self._fill(self.slot[pipe])
+        return ack
+
+
+def simulate(n_remotes: int, mode: str, bps: int, seconds: float,
+             ppm: float = 100.0, telemetry: bool = True, seed: int = 1) -> dict:
+    """
+    模擬一段時間
+
+    Returns:
+        {'collision_rate', 'delivery', 'pps_min', 'pps_mean', 'retries_per_pkt', 'tx'}
+    """
+    rng = random.Random(seed)
+    prof = MODES[mode]
+    data_us = airtime_us(PAYLOAD, bps)
+    ack_us = airtime_us(prof.ack_payload, bps)
+    txn_us = SETTLE_US + data_us + SETTLE_US + ack_us
+    ard_us = (prof.ard + 1) * 250
+
+    remotes = []
+    for i in range(n_remotes):
+        offset = rng.uniform(0, 1e6)
+        remotes.append(Remote(pipe=i + 1, ppm=rng.uniform(-ppm, ppm), clock_offset=offset,
+                              next_release_ms=int(offset // 1000) + rng.randrange(1, SAMPLE_MS + 1)))
+    base = Base()
+    end_us = seconds * 1e6
+
+    events = []
+    counter = 0
+
+    def push(t, kind, *args):
+        nonlocal counter
+        counter += 1
+        heapq.heappush(events, (t, counter, kind, args))
+
+    for r in remotes:
+        push(r.true(r.next_release_ms * 1000.0), 'release', r)
+
+    active = []         # [end_time, txn]
+    tx_total = 0
+    tx_collided = 0
+    retries = 0
+
+    while events:
+        t, _, kind, args = heapq.heappop(events)
+        if t > end_us:
+            break
+
+        if kind == 'release':
+            r, = args
+            if r.busy_until > t:
+                r.release_waiting = True
+                continue
+            now_ms = int(r.local(t) // 1000)
+            release_ms = r.next_release_ms
+            # 落後超過一個週期：跳過錯過的釋放
+            while now_ms >= r.next_release_ms + SAMPLE_MS:
+                r.next_release_ms += SAMPLE_MS
+                r.skipped += 1
+            r.next_release_ms += SAMPLE_MS
+
+            now_local = max(r.local(t), release_ms * 1000.0) + rng.uniform(0, LOOP_JITTER_US) \
+                + rng.uniform(*IMU_US)
+            r.generated += 1
+            tag = r.seq & 0xFF
+            if prof.tdma:
+                wait = r.slot_wait(now_local)
+                if wait > SPIN_MAX_US or wait < -LATE_US:
+                    # 不在時槽內：本筆不送，偏早立即移相，偏晚連續發生才移相
+                    if wait > 0:
+                        r.next_release_ms += int(wait // 1000)
+                        r.late_count = 0
+                    else:
+                        r.late_count += 1
+                        if r.late_count >= LATE_FRAMES:
+                            r.next_release_ms += int((wait - 999) // 1000)
+                            r.late_count = 0
+                    r.slot_skip(now_local)
+                    r.slot_skipped += 1
+                    r.seq += 1
+                    push(r.true(r.next_release_ms * 1000.0), 'release', r)
+                    continue
+                r.late_count = 0
+                if wait > 0:
+                    now_local += wait
+                r.slot_begin(tag, now_local)
+            start = r.true(now_local)
+            r.busy_until = float('inf')
+            send_telem = telemetry and r.frames % TELEMETRY_FRAMES == TELEMETRY_FRAMES - 1
+            r.frames += 1
+            push(start, 'txstart', r, True, tag, prof.arc, send_telem)
+            push(r.true((r.next_release_ms) * 1000.0), 'release', r)
+            r.seq += 1
+
+        elif kind == 'txstart':
+            r, sensor, tag, left, send_telem = args
+            txn = {'r': r, 'collided': False}
+            active = [a for a in active if a[0] > t]
+            for _, other in active:
+                other['collided'] = True
+                txn['collided'] = True
+            active.append((t + txn_us, txn))
+            tx_total += 1
+            push(t + txn_us, 'txend', txn, sensor, tag, left, send_telem, t)
+
+        elif kind == 'txend':
+            txn, sensor, tag, left, send_telem, start = args
+            r = txn['r']
+            if txn['collided']:
+                tx_collided += 1
+                if left > 0:
+                    retries += 1
+                    push(t + ard_us, 'txstart', r, sensor, tag, left - 1, send_telem)
+                    continue
+                if prof.tdma and sensor:
+                    # 未同步：隨機移動採樣相位，跳出與其他遠距端的固定碰撞
+                    # 已同步但連續失敗：視為失去同步
+                    r.fail_count += 1
+                    if r.fail_count >= UNSYNC_FAILS:
+                        r.synced = False
+                    if not r.synced:
+                        r.next_release_ms += rng.randrange(1, SAMPLE_MS)
+            else:
+                r.fail_count = 0
+                arrival = start + SETTLE_US + data_us
+                ack = base.on_packet(r.pipe, sensor, tag, arrival) if prof.tdma else None
+                if ack is not None:
+                    r.apply_sync(ack[1], ack[2])
+                if sensor:
+                    r.delivered += 1
+            if sensor and send_telem:
+                push(t + 50, 'txstart', r, False, tag, prof.arc, False)
+            else:
+                r.busy_until = t
+                if r.release_waiting:
+                    r.release_waiting = False
+                    push(t, 'release', r)
+
+    pps = [r.delivered / seconds for r in remotes]
+    generated = sum(r.generated + r.skipped for r in remotes)
+    return {
+        'collision_rate': tx_collided / tx_total if tx_total else 0.0,
+        'delivery': sum(r.delivered for r in remotes) / generated if generated else 0.0,
+        'pps_min': min(pps),
+        'pps_mean': sum(pps) / len(pps),
+        'retries_per_pkt': retries / max(1, sum(r.delivered for r in remotes)),
+        'tx': tx_total,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Multi-remote nRF24 channel simulator (ALOHA vs TDMA)")
+    parser.add_argument('-n', '--remotes', type=int, default=0, help="遠距端數（0 = 1~6 全部）")
+    parser.add_argument('--rate', choices=RATES, action='append', help="資料速率（可重複）")
+    parser.add_argument('--seconds', type=float, default=10.0)
+    parser.add_argument('--ppm', type=float, default=100.0, help="遠距端晶振誤差上限")
+    parser.add_argument('--no-telemetry', action='store_true')
+    parser.add_argument('--seed', type=int, default=1)
+    args = parser.parse_args()
+
+    counts = [args.remotes] if args.remotes else list(range(1, 7))
+    rates = args.rate or ['250k', '1M']
+
+    print(f"{'rate':>5} {'mode':>6} {'n':>2} {'collide%':>9} {'deliver%':>9} "
+          f"{'pps_min':>8} {'pps_avg':>8} {'retry/pkt':>9}")
+    for rate in rates:
+        for mode in MODES:
+            for n in counts:
+                res = simulate(n, mode, RATES[rate], args.seconds, args.ppm,
+                               not args.no_telemetry, args.seed)
+                print(f"{rate:>5} {mode:>6} {n:>2} {res['collision_rate'] * 100:>8.2f}% "
+                      f"{res['delivery'] * 100:>8.2f}% {res['pps_min']:>8.1f} {res['pps_mean']:>8.1f} "
+                      f"{res['retries_per_pkt']:>9.3f}")
+
+
+if __name__ == '__main__':
+    main()